@@ -0,0 +1,211 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file s21_bench_credit.cc
+ *
+ * @brief Benchmarks of the credit calculations
+ * for the SmartCalc v2.0 library.
+ *
+ * This file compares the differential credit calculated with the whole
+ * schedule of payments, with the lazy schedule streamed row by row and
+ * the summary calculated in closed form, and sums the interest of a year
+ * over rows with string dates and over columns with day numbers. The plan
+ * of a mortgage with early repayments shows the cost of the event-driven
+ * recalculation. A portfolio of annuities is priced loan by loan and by
+ * the batch kernels. The Monte Carlo simulation of a floating-rate
+ * mortgage shows the cost of a path.
+ * The entry point of the benchmarks is in s21_bench_expression.cc.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string>  // BM_InterestByYearRows
+#include <vector>  // BM_PortfolioScalar
+
+#include "../model/credit_simulator.h"
+#include "../model/model_credit.h"
+
+namespace {
+
+// кредит на state.range(0) месяцев
+s21::CrInput credit(const benchmark::State& state) {
+  return {3000000, static_cast<int>(state.range(0)), 11.5};
+}
+
+void BM_DifferentialSchedule(benchmark::State& state) {
+  s21::CreditModel model;
+  s21::CrInput in = credit(state);
+  for (auto _ : state) {
+    double first_pay = 0;
+    s21::CrOutput out = {0, 0};
+    s21::PaymentVector payments;
+    model.calculateCredit(s21::DIFFERENTIAL, in, first_pay, out, payments);
+    benchmark::DoNotOptimize(out.total);
+  }
+}
+
+// строки графика суммируются без хранения и форматирования дат
+void BM_DifferentialLazy(benchmark::State& state) {
+  s21::CreditModel model;
+  s21::PaymentSchedule rows =
+      model.schedule(s21::DIFFERENTIAL, credit(state), {2024, 1, 31});
+  for (auto _ : state) {
+    double total = 0;
+    for (const s21::ScheduleRow& row : rows) total += row.monthly_pay;
+    benchmark::DoNotOptimize(total);
+  }
+}
+
+void BM_DifferentialSummary(benchmark::State& state) {
+  s21::CreditModel model;
+  s21::CrInput in = credit(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model.summarizeCredit(s21::DIFFERENTIAL, in));
+  }
+}
+
+// срок в 40 лет, проценты за десятый год
+const s21::CrInput kLongCredit = {3000000, 480, 11.5};
+
+void BM_InterestByYearRows(benchmark::State& state) {
+  s21::CreditModel model;
+  double first_pay = 0;
+  s21::CrOutput out = {0, 0};
+  s21::PaymentVector payments;
+  model.calculateCredit(s21::DIFFERENTIAL, kLongCredit, first_pay, out,
+                        payments);
+  const std::string year = payments[120].date.substr(6);
+  for (auto _ : state) {
+    double interest = 0;
+    for (const s21::Payment& payment : payments) {
+      if (payment.date.compare(6, 4, year) == 0) {
+        interest += payment.interest_pay;
+      }
+    }
+    benchmark::DoNotOptimize(interest);
+  }
+}
+
+void BM_InterestByYearColumns(benchmark::State& state) {
+  s21::CreditModel model;
+  double first_pay = 0;
+  s21::CrOutput out = {0, 0};
+  s21::PaymentColumns payments;
+  model.calculateCredit(s21::DIFFERENTIAL, kLongCredit, first_pay, out,
+                        payments);
+  const int year = s21::CreditModel::fromDayNumber(payments.day[120]).year;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(payments.interestInYear(year));
+  }
+}
+
+// ипотека на 30 лет с пятью досрочными погашениями
+void BM_AnnuityPlan(benchmark::State& state) {
+  s21::CreditModel model;
+  const s21::RepaymentVector events = {
+      {12, 200000, s21::RepaymentMode::ReduceTerm},
+      {36, 300000, s21::RepaymentMode::ReducePayment},
+      {60, 250000, s21::RepaymentMode::ReduceTerm},
+      {120, 500000, s21::RepaymentMode::ReducePayment},
+      {180, 400000, s21::RepaymentMode::ReduceTerm}};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        model.planAnnuity({6000000, 360, 9}, events).total);
+  }
+}
+
+// сетка 200 ставок x 360 сроков x 50 сумм
+void BM_CreditGrid(benchmark::State& state) {
+  s21::CreditGridAxes axes;
+  for (int i = 1; i <= 200; ++i) axes.rate.push_back(i * 0.15);
+  for (int n = 1; n <= 360; ++n) axes.term.push_back(n);
+  for (int k = 1; k <= 50; ++k) axes.credit.push_back(k * 100000.0);
+  s21::CreditCube cube;
+  for (auto _ : state) {
+    s21::CreditModel::priceGrid(s21::ANNUITY, axes, cube);
+    benchmark::DoNotOptimize(cube.total.data());
+  }
+  state.SetItemsProcessed(state.iterations() * cube.total.size());
+}
+
+// 10 000 траекторий плавающей ставки на 30 лет
+void BM_MonteCarlo(benchmark::State& state) {
+  s21::SimulationOptions options;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        s21::CreditSimulator::simulate(s21::ANNUITY, {6000000, 360, 9},
+                                       s21::RateModel(), options)
+            .total.mean);
+  }
+  state.SetItemsProcessed(state.iterations() * options.paths);
+}
+
+// ставка по платежу: число итераций выводится счётчиком
+void BM_SolveRate(benchmark::State& state) {
+  int iterations = 0;
+  for (auto _ : state) {
+    s21::CrSolution rate =
+        s21::CreditModel::solveRate(s21::ANNUITY, 6000000, 360, 48277.36);
+    benchmark::DoNotOptimize(rate.value);
+    iterations = rate.iterations;
+  }
+  state.counters["iterations"] = iterations;
+}
+
+// портфель из миллиона аннуитетов
+s21::CreditPortfolio portfolio() {
+  s21::CreditPortfolio loans;
+  for (int i = 0; i < 1000000; ++i) {
+    loans.credit.push_back(100000 + 37 * i % 9000000);
+    loans.term.push_back(12 + i % 349);
+    loans.rate.push_back(1 + (i % 2500) / 100.0);
+    loans.type.push_back(s21::ANNUITY);
+  }
+  return loans;
+}
+
+void BM_PortfolioScalar(benchmark::State& state) {
+  s21::CreditModel model;
+  const s21::CreditPortfolio loans = portfolio();
+  std::vector<double> pay(loans.credit.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < pay.size(); ++i) {
+      pay[i] = model
+                   .summarizeCredit(s21::ANNUITY, {loans.credit[i],
+                                                   loans.term[i], loans.rate[i]})
+                   .first_pay;
+    }
+    benchmark::DoNotOptimize(pay.data());
+  }
+  state.SetItemsProcessed(state.iterations() * pay.size());
+}
+
+void BM_PortfolioBatch(benchmark::State& state) {
+  const s21::CreditPortfolio loans = portfolio();
+  s21::PortfolioQuotes quotes;
+  for (auto _ : state) {
+    s21::CreditModel::priceBatch(loans, quotes);
+    benchmark::DoNotOptimize(quotes.monthly_pay.data());
+  }
+  state.SetItemsProcessed(state.iterations() * loans.credit.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_DifferentialSchedule)->Arg(12)->Arg(360);
+BENCHMARK(BM_DifferentialLazy)->Arg(12)->Arg(360);
+BENCHMARK(BM_DifferentialSummary)->Arg(12)->Arg(360);
+BENCHMARK(BM_InterestByYearRows);
+BENCHMARK(BM_InterestByYearColumns);
+BENCHMARK(BM_AnnuityPlan);
+BENCHMARK(BM_SolveRate);
+BENCHMARK(BM_MonteCarlo)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_CreditGrid)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PortfolioScalar)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PortfolioBatch)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,194 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file s21_bench_expression.cc
+ *
+ * @brief Benchmarks of the expression evaluators
+ * for the SmartCalc v2.0 library.
+ *
+ * This file compares the stack interpreter of ModelCalculator with the
+ * graph interpreter of ExpressionProgram and the register machine of
+ * RegisterProgram on the same corpus of formulas, double with float
+ * evaluation, a formula compiled by the C++ compiler with the interpreters,
+ * the Chebyshev proxy with the expression it replaces, and single points
+ * of a TieredExpression after its promotion to JIT.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <limits>  // std::numeric_limits
+#include <vector>  // corpus
+
+#include "../model/chebyshev_proxy.h"
+#include "../model/expression_program.h"
+#include "../model/model_calculator.h"
+#include "../model/register_program.h"
+#include "../model/static_expression.h"
+#include "../model/tiered_expression.h"
+
+namespace {
+
+// количество точек в одном замере
+const unsigned kPoints = 1024;
+
+const std::vector<s21::String> kCorpus = {
+    "x*x-3*x+2",
+    "sin(x)^2+cos(x)^2",
+    "(x+1)*(x+2)*(x+3)*(x+4)/(x-5)",
+    "sqrt(x*x+1)-ln(x*x+1)/log(x*x+2)",
+    "2*x^5-3*x^4+x^3-7*x^2+x-1",
+};
+
+std::vector<double> grid() {
+  std::vector<double> x(kPoints);
+  for (unsigned i = 0; i < kPoints; ++i) x[i] = -5.0 + 10.0 * i / kPoints;
+  return x;
+}
+
+// стековая машина: RPN разбирается один раз, точки вычисляются в цикле
+void BM_StackInterpreter(benchmark::State& state) {
+  const s21::String& infix = kCorpus[state.range(0)];
+  const double inf = std::numeric_limits<double>::infinity();
+  s21::ModelCalculator calculator;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        calculator.calculateGraf({-5.0, 5.0}, {-inf, inf}, kPoints, infix));
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+  state.SetLabel(infix);
+}
+
+void BM_GraphScalar(benchmark::State& state) {
+  s21::ExpressionProgram program =
+      s21::ExpressionProgram::compile(kCorpus[state.range(0)]);
+  std::vector<double> x = grid();
+  for (auto _ : state) {
+    for (double v : x) benchmark::DoNotOptimize(program.evaluate(v));
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+}
+
+// одиночные точки выражения, уже переведённого на JIT
+void BM_TieredScalar(benchmark::State& state) {
+  s21::TierPolicy policy;
+  policy.blockAfter = 0;
+  policy.jitAfter = 0;
+  s21::TieredExpression expression(
+      s21::ExpressionProgram::compile(kCorpus[state.range(0)]), policy);
+  std::vector<double> x = grid();
+  for (double v : x) benchmark::DoNotOptimize(expression.evaluate(v));
+  for (auto _ : state) {
+    for (double v : x) benchmark::DoNotOptimize(expression.evaluate(v));
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+  state.SetLabel(expression.tier() == s21::Tier::Jit ? "jit" : "scalar");
+}
+
+void BM_RegisterScalar(benchmark::State& state) {
+  s21::RegisterProgram vm =
+      s21::RegisterProgram::compile(kCorpus[state.range(0)]);
+  std::vector<double> x = grid();
+  for (auto _ : state) {
+    for (double v : x) benchmark::DoNotOptimize(vm.evaluate(v));
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+  state.counters["instructions"] = vm.size();
+}
+
+void BM_GraphBatch(benchmark::State& state) {
+  s21::ExpressionProgram program =
+      s21::ExpressionProgram::compile(kCorpus[state.range(0)]);
+  std::vector<double> x = grid(), y(kPoints);
+  double* columns[1] = {y.data()};
+  for (auto _ : state) {
+    program.evaluate(x.data(), x.size(), columns);
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+}
+
+// тот же интерпретатор блоков в одинарной точности
+void BM_GraphBatchFloat(benchmark::State& state) {
+  s21::ExpressionProgram program =
+      s21::ExpressionProgram::compile(kCorpus[state.range(0)]);
+  std::vector<double> grid64 = grid();
+  std::vector<float> x(grid64.begin(), grid64.end()), y(kPoints);
+  float* columns[1] = {y.data()};
+  for (auto _ : state) {
+    program.evaluate(x.data(), x.size(), columns);
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+}
+
+void BM_RegisterBatch(benchmark::State& state) {
+  s21::RegisterProgram vm =
+      s21::RegisterProgram::compile(kCorpus[state.range(0)]);
+  std::vector<double> x = grid(), y(kPoints);
+  double* columns[1] = {y.data()};
+  for (auto _ : state) {
+    vm.evaluate(x.data(), x.size(), columns);
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+}
+
+// формула, разобранная компилятором C++
+constexpr char kStaticPolynomial[] = "2*x^5-3*x^4+x^3-7*x^2+x-1";
+
+void BM_StaticExpression(benchmark::State& state) {
+  std::vector<double> x = grid();
+  for (auto _ : state) {
+    for (double v : x) {
+      benchmark::DoNotOptimize(
+          s21::StaticExpression<kStaticPolynomial>::evaluate(v));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+}
+
+// тяжёлое выражение для сравнения с приближением
+const char kHeavy[] = "sin(cos(ln(x+6)))*atan(sqrt(x+6))+log(tan(x/7)+2)";
+
+void BM_HeavyExpression(benchmark::State& state) {
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile(kHeavy);
+  std::vector<double> x = grid(), y(kPoints);
+  for (auto _ : state) {
+    for (unsigned k = 0; k < kPoints; ++k) y[k] = program.evaluate(x[k]);
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+}
+
+void BM_HeavyProxy(benchmark::State& state) {
+  s21::ChebyshevProxy proxy = s21::ChebyshevProxy::fit(
+      s21::ExpressionProgram::compile(kHeavy), {-5.0, 5.0});
+  std::vector<double> x = grid(), y(kPoints);
+  for (auto _ : state) {
+    proxy.evaluate(x.data(), x.size(), y.data());
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kPoints);
+  state.counters["pieces"] = proxy.pieceCount();
+}
+
+}  // namespace
+
+BENCHMARK(BM_StackInterpreter)->DenseRange(0, kCorpus.size() - 1);
+BENCHMARK(BM_GraphScalar)->DenseRange(0, kCorpus.size() - 1);
+BENCHMARK(BM_TieredScalar)->DenseRange(0, kCorpus.size() - 1);
+BENCHMARK(BM_RegisterScalar)->DenseRange(0, kCorpus.size() - 1);
+BENCHMARK(BM_GraphBatch)->DenseRange(0, kCorpus.size() - 1);
+BENCHMARK(BM_GraphBatchFloat)->DenseRange(0, kCorpus.size() - 1);
+BENCHMARK(BM_RegisterBatch)->DenseRange(0, kCorpus.size() - 1);
+BENCHMARK(BM_StaticExpression);
+BENCHMARK(BM_HeavyExpression);
+BENCHMARK(BM_HeavyProxy);
+
+BENCHMARK_MAIN();
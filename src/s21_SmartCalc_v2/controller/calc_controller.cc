@@ -9,7 +9,9 @@
  * This file contains the implementation of the methods for the CalcController
  * class, which is part of the SmartCalc v2.0 library. The CalcController class
  * acts as an intermediary between the user interface and the model, handling
- * the calculation of mathematical expressions.
+ * the calculation of mathematical expressions. The models are stateless and
+ * the caches of compiled expressions are guarded by a mutex, so one
+ * controller may serve several threads.
  *
  * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
  *
@@ -25,10 +27,21 @@
 /**
  * @brief Calculate the result of a mathematical expression.
  *
+ * The expression is deliberately not taken from the cache of compiled
+ * expressions used by calculateGrafs. The calculator reports a division
+ * by zero or an argument out of the domain as an error with its reason
+ * and raises to powers with std::pow, while a compiled expression returns
+ * NaN for every invalid point; the result is calculated once per request,
+ * so there is nothing to promote.
+ *
  * @param expression The mathematical expression to calculate.
+ * @param x The value of x.
  * @return The result of the calculation.
+ * @throw std::invalid_argument If the expression is invalid or cannot be
+ * calculated at x.
  */
 double s21::CalcController::calculateExpression(const String& expression, const double& x) {
+  // одна точка: разбор выражения дешевле компиляции и кэша
   return model_.calculate(expression, x);
 }
 
@@ -50,12 +63,321 @@ void s21::CalcController::calculateCredit(TypeOfMonthlyPayments type,
   credit_.calculateCredit(type, in, monthly_pay, out, payments);
 }
 
+/**
+ * @brief Calculate the credit payments into a schedule stored by columns.
+ *
+ * @param type The type of monthly payment calculation (ANNUITY or
+ * DIFFERENTIAL).
+ * @param in The input data for the calculation.
+ * @param monthly_pay The calculated monthly payment (the first one for
+ * differential calculation).
+ * @param out The output data containing the total and overpayment.
+ * @param payments The columns of payments.
+ * @throw std::invalid_argument If the term is not positive.
+ */
+void s21::CalcController::calculateCredit(TypeOfMonthlyPayments type,
+                                          CrInput in, double& monthly_pay,
+                                          CrOutput& out,
+                                          PaymentColumns& payments) {
+  credit_.calculateCredit(type, in, monthly_pay, out, payments);
+}
+
+/**
+ * @brief Calculate an annuity with early repayments into a schedule stored
+ * by columns.
+ *
+ * @param in The input data for the calculation.
+ * @param events The early repayments.
+ * @param monthly_pay The first monthly payment.
+ * @param out The output data containing the total and overpayment.
+ * @param payments The columns of payments.
+ * @throw std::invalid_argument If the term or an early repayment is
+ * invalid.
+ */
+void s21::CalcController::calculateCredit(CrInput in,
+                                          const RepaymentVector& events,
+                                          double& monthly_pay, CrOutput& out,
+                                          PaymentColumns& payments) {
+  credit_.calculateCredit(in, events, monthly_pay, out, payments);
+}
+
+/**
+ * @brief Calculate the totals of a credit without the schedule of payments.
+ *
+ * @param type The type of monthly payment calculation (ANNUITY or
+ * DIFFERENTIAL).
+ * @param in The input data for the calculation.
+ * @return The total payment, the overpayment and the first and last
+ * payments.
+ * @throw std::invalid_argument If the term is not positive.
+ */
+s21::CrSummary s21::CalcController::summarizeCredit(
+    TypeOfMonthlyPayments type, CrInput in) {
+  return credit_.summarizeCredit(type, in);
+}
+
+/**
+ * @brief Price a portfolio of credits stored by columns.
+ *
+ * @param in The credits.
+ * @param out The payments and the totals of the credits.
+ * @throw std::invalid_argument If the columns of the portfolio differ in
+ * length.
+ */
+void s21::CalcController::priceBatch(const CreditPortfolio& in,
+                                     PortfolioQuotes& out) {
+  CreditModel::priceBatch(in, out);
+}
+
+/**
+ * @brief Price every credit of a grid of rates, terms and amounts.
+ *
+ * @param type The type of monthly payments.
+ * @param axes The rates, the terms and the amounts of the grid.
+ * @param out The payments and the totals in the order of CreditCube::index.
+ * @throw std::invalid_argument If a term is not positive.
+ */
+void s21::CalcController::priceGrid(TypeOfMonthlyPayments type,
+                                    const CreditGridAxes& axes,
+                                    CreditCube& out) {
+  CreditModel::priceGrid(type, axes, out);
+}
+
+/**
+ * @brief Simulate a floating-rate credit by Monte Carlo.
+ *
+ * @param type The type of monthly payments.
+ * @param in The credit; the rate is the rate of the first month.
+ * @param model The process of the rate.
+ * @param options The number of paths, the seed and the quantiles.
+ * @return The distributions of the total cost and of the overpayment.
+ * @throw std::invalid_argument If the input is invalid.
+ */
+s21::SimulationResult s21::CalcController::simulateCredit(
+    TypeOfMonthlyPayments type, const CrInput& in, const RateModel& model,
+    const SimulationOptions& options) {
+  return CreditSimulator::simulate(type, in, model, options);
+}
+
+/**
+ * @brief Find the annual rate giving a monthly payment.
+ *
+ * @param type The type of monthly payments.
+ * @param credit The amount of the credit.
+ * @param term The term in months.
+ * @param payment The monthly payment.
+ * @return The annual rate in percent and the number of iterations.
+ * @throw std::invalid_argument If no rate gives the payment.
+ */
+s21::CrSolution s21::CalcController::solveRate(TypeOfMonthlyPayments type,
+                                               double credit, int term,
+                                               double payment) {
+  return CreditModel::solveRate(type, credit, term, payment);
+}
+
+/**
+ * @brief Find the shortest term with a monthly payment not above a limit.
+ *
+ * @param type The type of monthly payments.
+ * @param credit The amount of the credit.
+ * @param rate The annual rate in percent.
+ * @param payment The largest monthly payment.
+ * @return The term in months and the number of evaluations.
+ * @throw std::invalid_argument If no term gives the payment.
+ */
+s21::CrSolution s21::CalcController::solveTerm(TypeOfMonthlyPayments type,
+                                               double credit, double rate,
+                                               double payment) {
+  return CreditModel::solveTerm(type, credit, rate, payment);
+}
+
+/**
+ * @brief Find the largest credit with a given monthly payment.
+ *
+ * @param type The type of monthly payments.
+ * @param term The term in months.
+ * @param rate The annual rate in percent.
+ * @param payment The monthly payment.
+ * @return The amount of the credit.
+ * @throw std::invalid_argument If the input is invalid.
+ */
+s21::CrSolution s21::CalcController::solvePrincipal(TypeOfMonthlyPayments type,
+                                                    int term, double rate,
+                                                    double payment) {
+  return CreditModel::solvePrincipal(type, term, rate, payment);
+}
+
+/**
+ * @brief Solve the inverse problem for every credit of a portfolio.
+ *
+ * @param unknown The column to be found.
+ * @param payments The monthly payments.
+ * @param portfolio The credits; the unknown column is overwritten.
+ * @throw std::invalid_argument If the columns differ in length.
+ */
+void s21::CalcController::solveBatch(SolveFor unknown,
+                                     const std::vector<double>& payments,
+                                     CreditPortfolio& portfolio) {
+  CreditModel::solveBatch(unknown, payments, portfolio);
+}
+
 std::vector<std::vector<double>> s21::CalcController::calculateGraf(
     std::pair<double, double> xRange, std::pair<double, double> yRange,
     unsigned pAmount, std::string infix){
     return model_.calculateGraf(xRange, yRange, pAmount, infix);
 }
 
+/**
+ * @brief Calculate several graphs over a shared grid of x values.
+ *
+ * The compiled expressions are cached, so an expression that is plotted
+ * again and again is promoted to faster tiers of execution. Graphs in
+ * single precision are evaluated in float without the cache.
+ *
+ * @param xRange The domain of the graphs.
+ * @param yRange The range of values of the graphs.
+ * @param pAmount The number of points in the grid.
+ * @param infixes The expressions to be plotted.
+ * @param precision The precision of evaluation.
+ * @return Row 0 holds the x values, rows 1..N hold the values of the
+ * expressions.
+ */
+s21::Vector s21::CalcController::calculateGrafs(
+    std::pair<double, double> xRange, std::pair<double, double> yRange,
+    unsigned pAmount, const StringVector& infixes, Precision precision) {
+  if (precision == Precision::Single) {
+    return model_.calculateGrafs(xRange, yRange, pAmount, infixes, precision);
+  }
+  return model_.calculateGrafs(xRange, yRange, pAmount, *expression(infixes));
+}
+
+/**
+ * @brief Reports for every expression whether plotting it in single
+ * precision gives visible errors.
+ *
+ * @param xRange The domain of the graphs.
+ * @param pAmount The number of points in the grid.
+ * @param infixes The expressions to be plotted.
+ * @return The accuracy report for every expression.
+ */
+std::vector<s21::AccuracyReport> s21::CalcController::checkAccuracy(
+    std::pair<double, double> xRange, unsigned pAmount,
+    const StringVector& infixes) {
+  return ExpressionProgram::compile(infixes).checkAccuracy(xRange, pAmount);
+}
+
+/**
+ * @brief Calculates graphs too large for memory into memory-mapped files.
+ *
+ * Besides the series of points, the level of detail pyramid of every
+ * expression is returned, so the graphs can be drawn for any visible range
+ * at the cost of the number of pixels, not of points.
+ *
+ * @param xRange The domain of the graphs.
+ * @param pAmount The number of points in the grid.
+ * @param infixes The expressions to be plotted.
+ * @param pathPrefix The common prefix of the file paths.
+ * @return The x series, the series of the expressions and their pyramids.
+ * @throw std::invalid_argument If the range or expressions are invalid.
+ * @throw std::runtime_error If the files cannot be written.
+ */
+s21::MappedGraf s21::CalcController::calculateGrafToFiles(
+    std::pair<double, double> xRange, std::size_t pAmount,
+    const StringVector& infixes, const String& pathPrefix) {
+  return model_.calculateGrafToFiles(xRange, pAmount, infixes, pathPrefix);
+}
+
+/**
+ * @brief Removes the files written by calculateGrafToFiles.
+ *
+ * @param pathPrefix The common prefix of the file paths.
+ * @param outputs The number of expressions.
+ */
+void s21::CalcController::removeGrafFiles(const String& pathPrefix,
+                                          std::size_t outputs) {
+  ModelCalculator::removeGrafFiles(pathPrefix, outputs);
+}
+
+/**
+ * @brief Returns the cached compiled expression, compiling it on first use.
+ *
+ * The expression is shared, so it stays alive for the callers using it
+ * even if another thread clears the cache.
+ *
+ * @param infixes The expressions.
+ * @return The compiled expression.
+ */
+std::shared_ptr<s21::TieredExpression> s21::CalcController::expression(
+    const StringVector& infixes) {
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  auto it = expressions_.find(infixes);
+  if (it == expressions_.end()) {
+    auto compiled =
+        std::make_shared<TieredExpression>(ExpressionProgram::compile(infixes));
+    if (expressions_.size() >= kMaxExpressions) {
+      expressions_.clear();
+    }
+    it = expressions_.emplace(infixes, std::move(compiled)).first;
+  }
+  return it->second;
+}
+
+/**
+ * @brief Calculate a graph through a cached Chebyshev proxy of the
+ * expression, fitted once over xRange.
+ *
+ * @param xRange The domain of the graph and of the proxy.
+ * @param yRange The range of values of the graph.
+ * @param pAmount The number of points in the grid.
+ * @param infix The expression to be plotted.
+ * @param options The parameters of the proxy.
+ * @return Rows x and y of the graph.
+ */
+s21::Vector s21::CalcController::calculateProxyGraf(
+    std::pair<double, double> xRange, std::pair<double, double> yRange,
+    unsigned pAmount, const String& infix, const ProxyOptions& options) {
+  // в ключе все параметры: приближения с разной степенью или числом
+  // участков различаются
+  auto key = std::make_tuple(infix, xRange.first, xRange.second, options);
+  std::shared_ptr<const ChebyshevProxy> proxy;
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto it = proxies_.find(key);
+    if (it != proxies_.end()) proxy = it->second;
+  }
+  if (!proxy) {
+    // приближение строится без блокировки, другие потоки не ждут
+    proxy = std::make_shared<const ChebyshevProxy>(ChebyshevProxy::fit(
+        ExpressionProgram::compile(infix), xRange, options));
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (proxies_.size() >= kMaxExpressions) {
+      proxies_.clear();
+    }
+    proxies_.emplace(key, proxy);
+  }
+  return model_.calculateGrafs(xRange, yRange, pAmount, *proxy);
+}
+
+/**
+ * @brief Calculate a parametric curve (x(t), y(t)).
+ *
+ * @param in The input data of the curve.
+ * @return Rows t, x and y of the sampled curve.
+ */
+s21::Vector s21::CalcController::calculateParametric(const CurveInput& in) {
+  return curve_.calculateParametric(in);
+}
+
+/**
+ * @brief Calculate a polar curve r(θ).
+ *
+ * @param in The input data of the curve.
+ * @return Rows θ, x and y of the sampled curve.
+ */
+s21::Vector s21::CalcController::calculatePolar(const CurveInput& in) {
+  return curve_.calculatePolar(in);
+}
+
 /**
  * @brief Calculate the deposit based on the input parameters.
  *
@@ -21,8 +21,15 @@
 #ifndef CPP3_S21_SMART_CALC_CALC_CONTROLLER_H
 #define CPP3_S21_SMART_CALC_CALC_CONTROLLER_H
 
+#include <map>     // expressions_
+#include <memory>  // expressions_
+#include <mutex>   // cacheMutex_
+#include <tuple>   // proxies_
+
+#include "../model/credit_simulator.h"
 #include "../model/model_calculator.h"
 #include "../model/model_credit.h"
+#include "../model/model_curve.h"
 #include "../model/model_deposit.h"
 
 namespace s21 {
@@ -33,15 +40,67 @@ class CalcController {
   void calculateCredit(TypeOfMonthlyPayments type, CrInput in,
                        double& monthly_pay, CrOutput& out,
                        PaymentVector& payments);
+  void calculateCredit(TypeOfMonthlyPayments type, CrInput in,
+                       double& monthly_pay, CrOutput& out,
+                       PaymentColumns& payments);
+  void calculateCredit(CrInput in, const RepaymentVector& events,
+                       double& monthly_pay, CrOutput& out,
+                       PaymentColumns& payments);
+  CrSummary summarizeCredit(TypeOfMonthlyPayments type, CrInput in);
+  void priceBatch(const CreditPortfolio& in, PortfolioQuotes& out);
+  void priceGrid(TypeOfMonthlyPayments type, const CreditGridAxes& axes,
+                 CreditCube& out);
+  SimulationResult simulateCredit(TypeOfMonthlyPayments type,
+                                  const CrInput& in, const RateModel& model,
+                                  const SimulationOptions& options);
+  CrSolution solveRate(TypeOfMonthlyPayments type, double credit, int term,
+                       double payment);
+  CrSolution solveTerm(TypeOfMonthlyPayments type, double credit, double rate,
+                       double payment);
+  CrSolution solvePrincipal(TypeOfMonthlyPayments type, int term, double rate,
+                            double payment);
+  void solveBatch(SolveFor unknown, const std::vector<double>& payments,
+                  CreditPortfolio& portfolio);
   void calculateDeposit(const Input& in, Output& out);
   Vector calculateGraf(
       std::pair<double, double> xRange, std::pair<double, double> yRange,
       unsigned pAmount, std::string infix);
+  Vector calculateGrafs(std::pair<double, double> xRange,
+                        std::pair<double, double> yRange, unsigned pAmount,
+                        const StringVector& infixes,
+                        Precision precision = Precision::Double);
+  std::vector<AccuracyReport> checkAccuracy(std::pair<double, double> xRange,
+                                            unsigned pAmount,
+                                            const StringVector& infixes);
+  MappedGraf calculateGrafToFiles(std::pair<double, double> xRange,
+                                  std::size_t pAmount,
+                                  const StringVector& infixes,
+                                  const String& pathPrefix);
+  void removeGrafFiles(const String& pathPrefix, std::size_t outputs);
+  Vector calculateProxyGraf(std::pair<double, double> xRange,
+                            std::pair<double, double> yRange, unsigned pAmount,
+                            const String& infix, const ProxyOptions& options);
+  Vector calculateParametric(const CurveInput& in);
+  Vector calculatePolar(const CurveInput& in);
 
  private:
+  // предел количества выражений в кэше
+  static constexpr std::size_t kMaxExpressions = 64;
+
+  std::shared_ptr<TieredExpression> expression(const StringVector& infixes);
+
   ModelCalculator model_;
   CreditModel credit_;
   DepositModel deposit_;
+  CurveModel curve_;
+  // скомпилированные выражения, ускоряющиеся при повторных вычислениях
+  std::map<StringVector, std::shared_ptr<TieredExpression>> expressions_;
+  // приближения выражений: выражение, область, параметры приближения
+  std::map<std::tuple<String, double, double, ProxyOptions>,
+           std::shared_ptr<const ChebyshevProxy>>
+      proxies_;
+  // защищает кэши; вычисления идут без блокировки
+  std::mutex cacheMutex_;
 };
 
 }  // namespace s21
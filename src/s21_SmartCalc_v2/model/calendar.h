@@ -0,0 +1,152 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file calendar.h
+ *
+ * @brief Declaration and implementation of the civil calendar
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the civil (proleptic Gregorian) calendar shared by the
+ * credit and deposit models. A date is an integer day number counted from
+ * 01.01.1970; conversions between day numbers and dates are constexpr
+ * integer arithmetic without calls of the C time library, so date loops
+ * do not depend on the time zone and are safe to run in parallel. The only
+ * call of the C time library, localDate, is reentrant.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_CALENDAR_H
+#define CPP3_S21_SMART_CALC_CALENDAR_H
+
+#include <cstdint>    // int32_t
+#include <ctime>      // localDate
+#include <stdexcept>  // localDate
+
+namespace s21 {
+
+namespace calendar {
+
+// дата календаря
+struct Date {
+  int year;   // год
+  int month;  // месяц (1 - 12)
+  int day;    // число (1 - 31)
+};
+
+/**
+ * @brief Checks if a year is a leap year.
+ *
+ * @param year The year.
+ * @return True if the year is a leap year.
+ */
+constexpr bool isLeapYear(int year) {
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/**
+ * @brief Returns the number of days in a year.
+ *
+ * @param year The year.
+ * @return 366 for leap years, 365 otherwise.
+ */
+constexpr int daysInYear(int year) { return isLeapYear(year) ? 366 : 365; }
+
+/**
+ * @brief Returns the number of days in a month.
+ *
+ * @param year The year.
+ * @param month The month (1 - 12).
+ * @return The number of days, 0 for a wrong month.
+ */
+constexpr int daysInMonth(int year, int month) {
+  if (month < 1 || month > 12) return 0;
+  if (month == 2) return isLeapYear(year) ? 29 : 28;
+  // 30 дней - в апреле, июне, сентябре и ноябре
+  return month == 4 || month == 6 || month == 9 || month == 11 ? 30 : 31;
+}
+
+/**
+ * @brief Converts a date to the number of days since 01.01.1970.
+ *
+ * @param year The year.
+ * @param month The month (1 - 12).
+ * @param day The day of the month.
+ * @return The day number (negative before 1970).
+ */
+constexpr std::int32_t daysFromCivil(int year, int month, int day) {
+  // год начинается с марта, поэтому 29 февраля - последний день года
+  year -= month <= 2;
+  int era = (year >= 0 ? year : year - 399) / 400;
+  int year_of_era = year - era * 400;
+  int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int day_of_era =
+      year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + day_of_era - 719468;
+}
+
+/**
+ * @brief Converts the number of days since 01.01.1970 to a date.
+ *
+ * @param days The day number.
+ * @return The date.
+ */
+constexpr Date civilFromDays(std::int32_t days) {
+  int z = days + 719468;
+  int era = (z >= 0 ? z : z - 146096) / 146097;
+  int day_of_era = z - era * 146097;
+  int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+                     day_of_era / 146096) /
+                    365;
+  int day_of_year =
+      day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  int month_from_march = (5 * day_of_year + 2) / 153;
+  int month =
+      month_from_march < 10 ? month_from_march + 3 : month_from_march - 9;
+  return {year_of_era + era * 400 + (month <= 2), month,
+          day_of_year - (153 * month_from_march + 2) / 5 + 1};
+}
+
+/**
+ * @brief Returns the number of days in the month of a day.
+ *
+ * @param days The day number.
+ * @return The number of days in its month.
+ */
+constexpr int daysInMonthOf(std::int32_t days) {
+  Date date = civilFromDays(days);
+  return daysInMonth(date.year, date.month);
+}
+
+/**
+ * @brief Returns the local date of a moment of time.
+ *
+ * Uses the reentrant localtime_r (localtime_s on Windows) instead of
+ * std::localtime, whose static buffer is shared by all threads.
+ *
+ * @param time The moment of time.
+ * @return The date in the local time zone.
+ * @throw std::runtime_error If the time cannot be converted.
+ */
+inline Date localDate(std::time_t time) {
+  std::tm local{};
+#if defined(_WIN32)
+  bool converted = localtime_s(&local, &time) == 0;
+#else
+  bool converted = localtime_r(&time, &local) != nullptr;
+#endif
+  if (!converted) {
+    throw std::runtime_error("calendar: cannot convert the local time");
+  }
+  return {local.tm_year + 1900, local.tm_mon + 1, local.tm_mday};
+}
+
+}  // namespace calendar
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_CALENDAR_H
@@ -0,0 +1,263 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file chebyshev_proxy.cc
+ *
+ * @brief Implementation of the ChebyshevProxy class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the ChebyshevProxy class,
+ * which is part of the SmartCalc v2.0 library.
+ * The ChebyshevProxy class replaces an expensive expression on a fixed
+ * domain by a piecewise Chebyshev approximation fitted to a requested
+ * tolerance and verified by dense sampling. Outside the domain and on
+ * pieces that cannot be approximated the expression itself is evaluated.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "chebyshev_proxy.h"
+
+#include <algorithm>  // std::upper_bound, std::max, std::count
+#include <cmath>      // std::cos, std::fabs, std::isfinite
+
+namespace s21 {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+}  // namespace
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Fits a piecewise Chebyshev approximation of an expression.
+ *
+ * The domain is bisected until the polynomial of every piece matches the
+ * expression within max(absTolerance, relTolerance * |f(x)|) at
+ * verifyPoints uniformly spaced points. Pieces that still fail when the
+ * budget of pieces is spent (poles, discontinuities) are marked to be
+ * evaluated directly.
+ *
+ * @param program The compiled expression.
+ * @param domain The domain of the approximation.
+ * @param options The tolerances, the degree and the budgets.
+ * @param output The output of the program to be approximated.
+ * @return The fitted approximation.
+ * @throw std::invalid_argument If the domain, the options or the output
+ * are invalid.
+ */
+ChebyshevProxy ChebyshevProxy::fit(const ExpressionProgram& program,
+                                   std::pair<double, double> domain,
+                                   const ProxyOptions& options,
+                                   std::size_t output) {
+  if (!std::isfinite(domain.first) || !std::isfinite(domain.second) ||
+      !(domain.first < domain.second)) {
+    throw std::invalid_argument("Invalid domain of approximation");
+  }
+  if (options.degree == 0 || options.maxPieces == 0 ||
+      options.verifyPoints < 2 || !(options.absTolerance >= 0.0) ||
+      !(options.relTolerance >= 0.0)) {
+    throw std::invalid_argument("Invalid options of approximation");
+  }
+  if (output >= program.outputCount()) {
+    throw std::invalid_argument("No such output of the expression");
+  }
+
+  ChebyshevProxy proxy;
+  proxy.program_ = program;
+  proxy.output_ = output;
+  proxy.domain_ = domain;
+  std::vector<double> coefficients;
+  proxy.fitPiece(domain.first, domain.second, 0, options, coefficients);
+  return proxy;
+}
+
+/**
+ * @brief Evaluates the approximation at a point.
+ *
+ * @param x The value of x.
+ * @return The approximate value (the exact one outside the domain
+ * and on direct pieces).
+ */
+double ChebyshevProxy::evaluate(double x) const {
+  if (!(x >= domain_.first && x <= domain_.second) || breaks_.empty()) {
+    return evaluateProgram(x);
+  }
+  std::size_t i =
+      std::upper_bound(breaks_.begin(), breaks_.end(), x) - breaks_.begin();
+  i = i > 0 ? i - 1 : 0;
+  if (direct_[i]) {
+    return evaluateProgram(x);
+  }
+  double a = breaks_[i];
+  double b = i + 1 < breaks_.size() ? breaks_[i + 1] : domain_.second;
+  double t = (2.0 * x - a - b) / (b - a);
+  return clenshaw(coefficients_.data() + offsets_[i], lengths_[i], t);
+}
+
+/**
+ * @brief Evaluates the approximation at many points.
+ *
+ * @param x Pointer to the x values.
+ * @param n The number of values.
+ * @param y Pointer to the output values.
+ */
+void ChebyshevProxy::evaluate(const double* x, std::size_t n,
+                              double* y) const {
+  for (std::size_t k = 0; k < n; ++k) {
+    y[k] = evaluate(x[k]);
+  }
+}
+
+/**
+ * @brief Returns the number of pieces evaluated by the expression itself.
+ *
+ * @return The number of direct pieces.
+ */
+std::size_t ChebyshevProxy::directCount() const {
+  return std::count(direct_.begin(), direct_.end(), true);
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Fits the interval [a, b], bisecting it while the approximation
+ * fails and the budget allows. Pieces are appended from left to right.
+ *
+ * @param a The left end of the interval.
+ * @param b The right end of the interval.
+ * @param pending The number of intervals waiting to the right.
+ * @param options The options of the approximation.
+ * @param coefficients Scratch buffer for the coefficients.
+ */
+void ChebyshevProxy::fitPiece(double a, double b, std::size_t pending,
+                              const ProxyOptions& options,
+                              std::vector<double>& coefficients) {
+  double error = 0.0;
+  if (approximate(a, b, options, coefficients, error)) {
+    breaks_.push_back(a);
+    offsets_.push_back(coefficients_.size());
+    lengths_.push_back(coefficients.size());
+    direct_.push_back(false);
+    coefficients_.insert(coefficients_.end(), coefficients.begin(),
+                         coefficients.end());
+    maxError_ = std::max(maxError_, error);
+    return;
+  }
+  double m = a + (b - a) / 2;
+  bool canSplit = direct_.size() + pending + 2 <= options.maxPieces &&
+                  m > a && m < b &&
+                  b - a > (domain_.second - domain_.first) * 1e-12;
+  if (canSplit) {
+    fitPiece(a, m, pending + 1, options, coefficients);
+    fitPiece(m, b, pending, options, coefficients);
+  } else {
+    // участок не приближается: вычисляется самим выражением
+    breaks_.push_back(a);
+    offsets_.push_back(coefficients_.size());
+    lengths_.push_back(0);
+    direct_.push_back(true);
+  }
+}
+
+/**
+ * @brief Builds the Chebyshev interpolant of the expression on [a, b] and
+ * verifies it by dense sampling.
+ *
+ * The coefficients come from the values at the Chebyshev nodes; trailing
+ * coefficients whose sum is far below the tolerance are dropped before the
+ * verification, so the certificate holds for the polynomial actually used.
+ *
+ * @param a The left end of the interval.
+ * @param b The right end of the interval.
+ * @param options The options of the approximation.
+ * @param coefficients The coefficients of the interpolant.
+ * @param error The largest error found by the verification.
+ * @return True if the interpolant is within the tolerance.
+ */
+bool ChebyshevProxy::approximate(double a, double b,
+                                 const ProxyOptions& options,
+                                 std::vector<double>& coefficients,
+                                 double& error) {
+  const std::size_t n = options.degree + 1;
+  const double mid = (a + b) / 2, half = (b - a) / 2;
+  std::vector<double> values(n);
+  for (std::size_t k = 0; k < n; ++k) {
+    values[k] = evaluateProgram(mid + half * std::cos(kPi * (k + 0.5) / n));
+    if (!std::isfinite(values[k])) return false;
+  }
+  coefficients.assign(n, 0.0);
+  for (std::size_t j = 0; j < n; ++j) {
+    double sum = 0.0;
+    for (std::size_t k = 0; k < n; ++k) {
+      sum += values[k] * std::cos(kPi * j * (k + 0.5) / n);
+    }
+    coefficients[j] = (j == 0 ? 1.0 : 2.0) * sum / n;
+  }
+  // |T_j| <= 1, поэтому отброшенный хвост ограничен суммой модулей
+  double tail = 0.0;
+  while (coefficients.size() > 1 &&
+         tail + std::fabs(coefficients.back()) <= 0.1 * options.absTolerance) {
+    tail += std::fabs(coefficients.back());
+    coefficients.pop_back();
+  }
+
+  error = 0.0;
+  for (unsigned i = 0; i < options.verifyPoints; ++i) {
+    double x = i + 1 < options.verifyPoints
+                   ? a + (b - a) * i / (options.verifyPoints - 1)
+                   : b;
+    double exact = evaluateProgram(x);
+    if (!std::isfinite(exact)) return false;
+    double t = (2.0 * x - a - b) / (b - a);
+    double e = std::fabs(clenshaw(coefficients.data(), coefficients.size(), t) -
+                         exact);
+    if (!(e <= std::max(options.absTolerance,
+                        options.relTolerance * std::fabs(exact)))) {
+      return false;
+    }
+    error = std::max(error, e);
+  }
+  verified_ += options.verifyPoints;
+  return true;
+}
+
+/**
+ * @brief Evaluates the approximated output of the expression.
+ *
+ * @param x The value of x.
+ * @return The exact value.
+ */
+double ChebyshevProxy::evaluateProgram(double x) const {
+  return program_.evaluate(x, output_);
+}
+
+/**
+ * @brief Evaluates a Chebyshev series by Clenshaw's recurrence.
+ *
+ * @param c The coefficients of the series.
+ * @param n The number of coefficients.
+ * @param t The point in [-1, 1].
+ * @return The value of the series.
+ */
+double ChebyshevProxy::clenshaw(const double* c, std::size_t n, double t) {
+  double b1 = 0.0, b2 = 0.0;
+  for (std::size_t j = n; j-- > 1;) {
+    double b0 = 2.0 * t * b1 - b2 + c[j];
+    b2 = b1;
+    b1 = b0;
+  }
+  return t * b1 - b2 + c[0];
+}
+
+}  // namespace s21
@@ -0,0 +1,98 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file chebyshev_proxy.h
+ *
+ * @brief Declaration of the ChebyshevProxy class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the ChebyshevProxy class,
+ * which is part of the SmartCalc v2.0 library.
+ * The ChebyshevProxy class replaces an expensive expression on a fixed
+ * domain by a piecewise Chebyshev approximation fitted to a requested
+ * tolerance and verified by dense sampling. Outside the domain and on
+ * pieces that cannot be approximated the expression itself is evaluated.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_CHEBYSHEV_PROXY_H
+#define CPP3_S21_SMART_CALC_CHEBYSHEV_PROXY_H
+
+#include <cstddef>    // size_t
+#include <stdexcept>  // fit
+#include <tuple>      // ProxyOptions::operator<
+#include <utility>    // std::pair
+#include <vector>     // breaks_, coefficients_
+
+#include "expression_program.h"
+
+namespace s21 {
+
+// параметры построения приближения
+struct ProxyOptions {
+  double absTolerance = 1e-9;   // допустимая абсолютная погрешность
+  double relTolerance = 1e-9;   // допустимая относительная погрешность
+  unsigned degree = 12;         // степень многочлена на одном участке
+  unsigned maxPieces = 4096;    // наибольшее количество участков
+  unsigned verifyPoints = 128;  // точки проверки на одном участке
+
+  // порядок по всем полям: параметры - часть ключа кэша приближений
+  bool operator<(const ProxyOptions& other) const {
+    return std::tie(absTolerance, relTolerance, degree, maxPieces,
+                    verifyPoints) < std::tie(other.absTolerance,
+                                             other.relTolerance, other.degree,
+                                             other.maxPieces,
+                                             other.verifyPoints);
+  }
+};
+
+class ChebyshevProxy {
+ public:
+  ChebyshevProxy() = default;
+
+  // Main methods:
+  static ChebyshevProxy fit(const ExpressionProgram& program,
+                            std::pair<double, double> domain,
+                            const ProxyOptions& options = ProxyOptions(),
+                            std::size_t output = 0);
+
+  double evaluate(double x) const;
+  void evaluate(const double* x, std::size_t n, double* y) const;
+
+  // Accessors:
+  std::pair<double, double> domain() const { return domain_; }
+  std::size_t pieceCount() const { return direct_.size(); }
+  std::size_t directCount() const;
+  double maxError() const { return maxError_; }
+  std::size_t verifiedPoints() const { return verified_; }
+
+ private:
+  // Auxiliary methods:
+  void fitPiece(double a, double b, std::size_t pending,
+                const ProxyOptions& options,
+                std::vector<double>& coefficients);
+  bool approximate(double a, double b, const ProxyOptions& options,
+                   std::vector<double>& coefficients, double& error);
+  double evaluateProgram(double x) const;
+  static double clenshaw(const double* c, std::size_t n, double t);
+
+  ExpressionProgram program_;
+  std::size_t output_ = 0;
+  std::pair<double, double> domain_ = {0.0, 0.0};
+  std::vector<double> breaks_;        // левые границы участков
+  std::vector<std::size_t> offsets_;  // начало коэффициентов участка
+  std::vector<std::size_t> lengths_;  // количество коэффициентов участка
+  std::vector<bool> direct_;          // участок вычисляется выражением
+  std::vector<double> coefficients_;  // коэффициенты всех участков
+  double maxError_ = 0.0;             // наибольшая погрешность проверки
+  std::size_t verified_ = 0;          // количество проверенных точек
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_CHEBYSHEV_PROXY_H
@@ -0,0 +1,415 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file credit_simulator.cc
+ *
+ * @brief Implementation of the CreditSimulator, Philox4x32 and
+ * QuantileSketch classes for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the CreditSimulator class,
+ * which is part of the SmartCalc v2.0 library.
+ * The CreditSimulator class prices a floating-rate credit by Monte Carlo
+ * with counter-based random streams, parallel paths and streaming
+ * quantiles.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "credit_simulator.h"
+
+#include <algorithm>  // std::max, std::min
+#include <cmath>      // std::exp, std::log, std::sqrt
+#include <mutex>      // simulate
+
+namespace s21 {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+// 2^-53: шаг равномерной сетки из 53 бит
+const double kUnit = 1.0 / 9007199254740992.0;
+// значения не больше этого считаются нулём
+const double kZero = 1e-9;
+
+}  // namespace
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTOR
+ ******************************************************************************/
+
+/**
+ * @brief Creates an empty sketch.
+ *
+ * Values are counted in bins (g^(i-1), g^i] with g = (1 + a) / (1 - a),
+ * so every quantile is returned with a relative error of at most a.
+ *
+ * @param accuracy The relative accuracy a of the quantiles.
+ * @throw std::invalid_argument If the accuracy is not in (0, 1).
+ */
+QuantileSketch::QuantileSketch(double accuracy) : accuracy_(accuracy) {
+  if (!(accuracy > 0 && accuracy < 1)) {
+    throw std::invalid_argument("Accuracy of quantiles must be in (0, 1)");
+  }
+  gamma_ = (1 + accuracy) / (1 - accuracy);
+  logGamma_ = std::log(gamma_);
+}
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Generates a block of four random numbers by Philox4x32-10.
+ *
+ * @param counter The counter: any number identifies its own block.
+ * @param key The key of the stream.
+ * @return Four random 32-bit numbers.
+ */
+Philox4x32::Counter Philox4x32::generate(Counter counter, Key key) {
+  for (int round = 0; round < 10; ++round) {
+    std::uint64_t first = std::uint64_t{0xD2511F53} * counter[0];
+    std::uint64_t second = std::uint64_t{0xCD9E8D57} * counter[2];
+    counter = {static_cast<std::uint32_t>(second >> 32) ^ counter[1] ^ key[0],
+               static_cast<std::uint32_t>(second),
+               static_cast<std::uint32_t>(first >> 32) ^ counter[3] ^ key[1],
+               static_cast<std::uint32_t>(first)};
+    key[0] += 0x9E3779B9;
+    key[1] += 0xBB67AE85;
+  }
+  return counter;
+}
+
+/**
+ * @brief Generates two independent standard normal numbers
+ * by the Box-Muller transform of one block.
+ *
+ * @param counter The counter of the block.
+ * @param key The key of the stream.
+ * @return Two normal numbers.
+ */
+std::array<double, 2> Philox4x32::normals(Counter counter, Key key) {
+  Counter bits = generate(counter, key);
+  // u1 из (0, 1]: логарифм всегда конечен
+  double u1 = (((std::uint64_t{bits[0]} << 32 | bits[1]) >> 11) + 1) * kUnit;
+  double u2 = ((std::uint64_t{bits[2]} << 32 | bits[3]) >> 11) * kUnit;
+  double radius = std::sqrt(-2 * std::log(u1));
+  return {radius * std::cos(2 * kPi * u2), radius * std::sin(2 * kPi * u2)};
+}
+
+/**
+ * @brief Adds a value to the sketch.
+ *
+ * @param value The value; values not above 1e-9 are counted as zeros.
+ * @throw std::invalid_argument If the value is not a number.
+ */
+void QuantileSketch::add(double value) {
+  if (std::isnan(value)) {
+    throw std::invalid_argument("Value is not a number");
+  }
+  if (value <= kZero) {
+    ++zeros_;
+  } else {
+    ++bin(indexOf(value));
+  }
+  ++count_;
+}
+
+/**
+ * @brief Adds the values of another sketch. Only the counts are added,
+ * so the result does not depend on the order of merging.
+ *
+ * @param other The sketch with the same accuracy.
+ * @throw std::invalid_argument If the accuracies differ.
+ */
+void QuantileSketch::merge(const QuantileSketch& other) {
+  if (other.accuracy_ != accuracy_) {
+    throw std::invalid_argument("Sketches have different accuracy");
+  }
+  for (std::size_t i = 0; i < other.counts_.size(); ++i) {
+    if (other.counts_[i] != 0) {
+      bin(other.offset_ + static_cast<int>(i)) += other.counts_[i];
+    }
+  }
+  zeros_ += other.zeros_;
+  count_ += other.count_;
+}
+
+/**
+ * @brief Returns a quantile of the values added.
+ *
+ * @param q The level of the quantile.
+ * @return The value of rank floor(q (count - 1)) within the relative
+ * accuracy of the sketch.
+ * @throw std::invalid_argument If the sketch is empty or q is not in
+ * [0, 1].
+ */
+double QuantileSketch::quantile(double q) const {
+  if (count_ == 0 || !(q >= 0 && q <= 1)) {
+    throw std::invalid_argument("No such quantile");
+  }
+  std::uint64_t rank = static_cast<std::uint64_t>(q * (count_ - 1));
+  std::uint64_t seen = zeros_;
+  if (rank < seen) return 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (rank < seen) {
+      // середина корзины по относительной погрешности
+      return 2 * std::pow(gamma_, offset_ + static_cast<int>(i)) /
+             (gamma_ + 1);
+    }
+  }
+  return 2 * std::pow(gamma_, offset_ + static_cast<int>(counts_.size()) - 1) /
+         (gamma_ + 1);
+}
+
+/**
+ * @brief Simulates a floating-rate credit by Monte Carlo.
+ *
+ * The paths are split into parts of kChunk paths; the parts are simulated
+ * by the workers of the scheduler, the moments of every part are kept
+ * separately and combined in the order of the parts, and the sketches
+ * hold integer counts only. So the results are the same for any number
+ * of workers.
+ *
+ * @param type The type of monthly payments.
+ * @param in The credit; the rate is the rate of the first month.
+ * @param model The process of the rate.
+ * @param options The number of paths, the seed and the quantiles.
+ * @param scheduler The scheduler running the paths.
+ * @return The distributions of the total cost and of the overpayment.
+ * @throw std::invalid_argument If the input is invalid.
+ */
+SimulationResult CreditSimulator::simulate(TypeOfMonthlyPayments type,
+                                           const CrInput& in,
+                                           const RateModel& model,
+                                           const SimulationOptions& options,
+                                           TaskScheduler& scheduler) {
+  validate(in, model, options);
+  const std::size_t chunks = (options.paths + kChunk - 1) / kChunk;
+  std::vector<Moments> totals(chunks), overpayments(chunks);
+  QuantileSketch totalSketch(options.accuracy);
+  QuantileSketch overpaymentSketch(options.accuracy);
+  std::mutex mutex;  // защищает общие гистограммы
+
+  scheduler.parallelFor(0, chunks, 1, [&](std::size_t begin, std::size_t end) {
+    QuantileSketch total(options.accuracy), overpayment(options.accuracy);
+    for (std::size_t chunk = begin; chunk < end; ++chunk) {
+      std::size_t last = std::min(options.paths, (chunk + 1) * kChunk);
+      for (std::size_t path = chunk * kChunk; path < last; ++path) {
+        double cost = simulatePath(type, in, model, options.seed, path);
+        accumulate(totals[chunk], cost);
+        accumulate(overpayments[chunk], cost - in.credit);
+        total.add(cost);
+        overpayment.add(cost - in.credit);
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    totalSketch.merge(total);
+    overpaymentSketch.merge(overpayment);
+  });
+
+  Moments total, overpayment;
+  for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+    combine(total, totals[chunk]);
+    combine(overpayment, overpayments[chunk]);
+  }
+  SimulationResult result;
+  result.paths = options.paths;
+  result.total = summarize(total, totalSketch, options.quantiles);
+  result.overpayment =
+      summarize(overpayment, overpaymentSketch, options.quantiles);
+  return result;
+}
+
+/**
+ * @brief Simulates one path of the rate and returns the total cost.
+ *
+ * The rate is fixed for the first month and then follows the exact
+ * monthly step of the Vasicek process
+ * r' = m + (r - m) e^(-k/12) + s sqrt((1 - e^(-k/6)) / (2k)) z,
+ * limited from below by the floor. An annuity payment is recalculated
+ * every month for the remaining debt and term, the principal part of a
+ * differential payment is constant. Payments are not rounded to kopecks.
+ *
+ * @param type The type of monthly payments.
+ * @param in The credit; the rate is the rate of the first month.
+ * @param model The process of the rate.
+ * @param seed The key of the random stream.
+ * @param path The number of the path.
+ * @return The total cost of the credit on the path.
+ */
+double CreditSimulator::simulatePath(TypeOfMonthlyPayments type,
+                                     const CrInput& in, const RateModel& model,
+                                     std::uint64_t seed, std::uint64_t path) {
+  const double decay = std::exp(-model.reversion / 12);
+  const double scale =
+      model.reversion > 0
+          ? model.volatility *
+                std::sqrt(-std::expm1(-model.reversion / 6) /
+                          (2 * model.reversion))
+          : model.volatility * std::sqrt(1.0 / 12);
+  const Philox4x32::Key key = {static_cast<std::uint32_t>(seed),
+                               static_cast<std::uint32_t>(seed >> 32)};
+  const double principal = in.credit / in.term;
+
+  double rate = in.rate, debt = in.credit, total = 0;
+  std::array<double, 2> noise = {0, 0};
+  for (int month = 0; month < in.term; ++month) {
+    if (month > 0) {
+      // один блок генератора даёт числа для двух месяцев
+      int step = month - 1;
+      if (step % 2 == 0) {
+        noise = Philox4x32::normals(
+            {static_cast<std::uint32_t>(step / 2), 0,
+             static_cast<std::uint32_t>(path),
+             static_cast<std::uint32_t>(path >> 32)},
+            key);
+      }
+      rate = std::max(model.floor, model.mean + (rate - model.mean) * decay +
+                                       scale * noise[step % 2]);
+    }
+    double const_rate = rate / 1200;
+    int left = in.term - month;
+    double repaid = debt;
+    if (left > 1) {
+      // долговая часть аннуитета: D r / ((1 + r)^left - 1)
+      repaid = type == DIFFERENTIAL ? principal
+               : const_rate == 0
+                   ? debt / left
+                   : debt * const_rate /
+                         std::expm1(left * std::log1p(const_rate));
+    }
+    total += debt * const_rate + repaid;
+    debt -= repaid;
+  }
+  return total;
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the number of the bin of a positive value.
+ *
+ * @param value The value.
+ * @return The number i of the bin (g^(i-1), g^i].
+ */
+int QuantileSketch::indexOf(double value) const {
+  return static_cast<int>(std::ceil(std::log(value) / logGamma_));
+}
+
+/**
+ * @brief Returns the count of a bin, adding the bins up to it.
+ *
+ * @param index The number of the bin.
+ * @return The count.
+ */
+std::uint64_t& QuantileSketch::bin(int index) {
+  if (counts_.empty()) {
+    offset_ = index;
+    counts_.push_back(0);
+  } else if (index < offset_) {
+    counts_.insert(counts_.begin(), offset_ - index, 0);
+    offset_ = index;
+  } else if (index - offset_ >= static_cast<int>(counts_.size())) {
+    counts_.resize(index - offset_ + 1, 0);
+  }
+  return counts_[index - offset_];
+}
+
+/**
+ * @brief Checks the input of a simulation.
+ *
+ * @param in The credit.
+ * @param model The process of the rate.
+ * @param options The options of the simulation.
+ * @throw std::invalid_argument If the input is invalid.
+ */
+void CreditSimulator::validate(const CrInput& in, const RateModel& model,
+                               const SimulationOptions& options) {
+  if (in.term < 1 || !(in.credit > 0) || !(in.rate >= 0)) {
+    throw std::invalid_argument("Invalid conditions of the credit");
+  }
+  if (!(model.floor >= 0) || !(model.reversion >= 0) ||
+      !(model.volatility >= 0) || !std::isfinite(model.mean)) {
+    throw std::invalid_argument("Invalid model of the rate");
+  }
+  if (options.paths == 0 || !(options.accuracy > 0 && options.accuracy < 1)) {
+    throw std::invalid_argument("Invalid options of the simulation");
+  }
+  for (double level : options.quantiles) {
+    if (!(level >= 0 && level <= 1)) {
+      throw std::invalid_argument("Level of a quantile must be in [0, 1]");
+    }
+  }
+}
+
+/**
+ * @brief Adds a value to the moments (Welford's method).
+ *
+ * @param moments The moments.
+ * @param value The value.
+ */
+void CreditSimulator::accumulate(Moments& moments, double value) {
+  if (moments.count++ == 0) {
+    moments.min = moments.max = value;
+  }
+  double delta = value - moments.mean;
+  moments.mean += delta / moments.count;
+  moments.squares += delta * (value - moments.mean);
+  moments.min = std::min(moments.min, value);
+  moments.max = std::max(moments.max, value);
+}
+
+/**
+ * @brief Adds the moments of a part to the moments of the parts before it
+ * (Chan's method).
+ *
+ * @param into The moments of the parts before.
+ * @param part The moments of the part.
+ */
+void CreditSimulator::combine(Moments& into, const Moments& part) {
+  if (part.count == 0) return;
+  if (into.count == 0) {
+    into = part;
+    return;
+  }
+  double count = static_cast<double>(into.count + part.count);
+  double delta = part.mean - into.mean;
+  into.mean += delta * part.count / count;
+  into.squares +=
+      part.squares + delta * delta * into.count * part.count / count;
+  into.count += part.count;
+  into.min = std::min(into.min, part.min);
+  into.max = std::max(into.max, part.max);
+}
+
+/**
+ * @brief Builds the distribution of a value.
+ *
+ * @param moments The moments of all the paths.
+ * @param sketch The sketch of all the paths.
+ * @param levels The levels of the quantiles.
+ * @return The distribution.
+ */
+Distribution CreditSimulator::summarize(const Moments& moments,
+                                        const QuantileSketch& sketch,
+                                        const std::vector<double>& levels) {
+  Distribution distribution;
+  distribution.mean = moments.mean;
+  distribution.deviation =
+      moments.count > 1 ? std::sqrt(moments.squares / (moments.count - 1)) : 0;
+  distribution.min = moments.min;
+  distribution.max = moments.max;
+  for (double level : levels) {
+    distribution.quantiles.push_back(sketch.quantile(level));
+  }
+  return distribution;
+}
+
+}  // namespace s21
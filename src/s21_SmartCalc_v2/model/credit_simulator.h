@@ -0,0 +1,147 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file credit_simulator.h
+ *
+ * @brief Declaration of the CreditSimulator, Philox4x32 and QuantileSketch
+ * classes for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the CreditSimulator class,
+ * which is part of the SmartCalc v2.0 library.
+ * The CreditSimulator class prices a floating-rate credit by Monte Carlo:
+ * the annual rate follows a mean-reverting (Vasicek) process, every path
+ * is simulated month by month and the distributions of the total cost and
+ * of the overpayment are accumulated without storing the paths.
+ * The random numbers of a path depend only on the seed, the number of the
+ * path and the month (Philox4x32), and the paths are reduced in a fixed
+ * order, so the results do not depend on the number of threads.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_CREDIT_SIMULATOR_H
+#define CPP3_S21_SMART_CALC_CREDIT_SIMULATOR_H
+
+#include <array>      // Philox4x32
+#include <cstddef>    // size_t
+#include <cstdint>    // uint32_t, uint64_t
+#include <stdexcept>  // simulate
+#include <vector>     // counts_, SimulationOptions
+
+#include "model_credit.h"
+#include "task_scheduler.h"
+
+namespace s21 {
+
+// генератор на счётчике: блок случайных чисел - функция счётчика и ключа
+class Philox4x32 {
+ public:
+  using Counter = std::array<std::uint32_t, 4>;
+  using Key = std::array<std::uint32_t, 2>;
+
+  // Main methods:
+  static Counter generate(Counter counter, Key key);
+  static std::array<double, 2> normals(Counter counter, Key key);
+};
+
+// поток значений с квантилями заданной относительной точности
+class QuantileSketch {
+ public:
+  explicit QuantileSketch(double accuracy = 1e-3);
+
+  // Main methods:
+  void add(double value);
+  void merge(const QuantileSketch& other);
+  double quantile(double q) const;
+
+  // Accessors:
+  std::uint64_t count() const { return count_; }
+  double accuracy() const { return accuracy_; }
+
+ private:
+  // Auxiliary methods:
+  int indexOf(double value) const;
+  std::uint64_t& bin(int index);
+
+  double accuracy_;
+  double gamma_;     // отношение границ соседних корзин
+  double logGamma_;  // ln(gamma_)
+  int offset_ = 0;   // номер первой корзины в counts_
+  std::vector<std::uint64_t> counts_;  // количества значений по корзинам
+  std::uint64_t zeros_ = 0;            // значения, неотличимые от нуля
+  std::uint64_t count_ = 0;
+};
+
+// процесс Васичека для годовой ставки в процентах
+struct RateModel {
+  double mean = 10;        // долгосрочный уровень ставки
+  double reversion = 0.5;  // скорость возврата к уровню (в год)
+  double volatility = 2;   // волатильность (процентных пунктов в год)
+  double floor = 0;        // нижняя граница ставки (не меньше нуля)
+};
+
+// параметры моделирования
+struct SimulationOptions {
+  std::size_t paths = 10000;  // количество траекторий
+  std::uint64_t seed = 0;     // ключ генератора
+  std::vector<double> quantiles = {0.05, 0.5, 0.95};  // уровни квантилей
+  double accuracy = 1e-3;     // относительная точность квантилей
+};
+
+// распределение одной величины по траекториям
+struct Distribution {
+  double mean = 0;
+  double deviation = 0;  // стандартное отклонение
+  double min = 0;
+  double max = 0;
+  std::vector<double> quantiles;  // в порядке SimulationOptions::quantiles
+};
+
+// результат моделирования
+struct SimulationResult {
+  std::size_t paths = 0;
+  Distribution total;        // общая выплата
+  Distribution overpayment;  // переплата
+};
+
+class CreditSimulator {
+ public:
+  // Main methods:
+  static SimulationResult simulate(
+      TypeOfMonthlyPayments type, const CrInput& in, const RateModel& model,
+      const SimulationOptions& options = SimulationOptions(),
+      TaskScheduler& scheduler = TaskScheduler::instance());
+  static double simulatePath(TypeOfMonthlyPayments type, const CrInput& in,
+                             const RateModel& model, std::uint64_t seed,
+                             std::uint64_t path);
+
+ private:
+  // моменты части траекторий
+  struct Moments {
+    std::size_t count = 0;
+    double mean = 0;
+    double squares = 0;  // сумма квадратов отклонений от среднего
+    double min = 0;
+    double max = 0;
+  };
+
+  // Auxiliary methods:
+  static void validate(const CrInput& in, const RateModel& model,
+                       const SimulationOptions& options);
+  static void accumulate(Moments& moments, double value);
+  static void combine(Moments& into, const Moments& part);
+  static Distribution summarize(const Moments& moments,
+                                const QuantileSketch& sketch,
+                                const std::vector<double>& levels);
+
+  // траектории одной части: разбиение не зависит от числа потоков
+  static constexpr std::size_t kChunk = 256;
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_CREDIT_SIMULATOR_H
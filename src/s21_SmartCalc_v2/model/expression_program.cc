@@ -0,0 +1,881 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file expression_program.cc
+ *
+ * @brief Implementation of the ExpressionProgram class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the ExpressionProgram class,
+ * which is part of the SmartCalc v2.0 library.
+ * The ExpressionProgram class compiles one or several infix expressions
+ * into a single fused program of instructions with shared common
+ * subexpressions and evaluates it block by block over a grid of x values.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "expression_program.h"
+
+#include <algorithm>  // std::min, std::max, std::copy
+#include <cmath>      // applyScalar, std::isfinite
+#include <cstring>    // std::memcpy
+#include <limits>     // quiet_NaN
+#include <sstream>    // tokenOpCode, appendRPN
+
+#include "polish_notation.h"
+
+namespace s21 {
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Compiles a single infix expression into a program.
+ *
+ * @param infix The infix expression to be compiled.
+ * @return The compiled program with one output.
+ * @throw std::invalid_argument If the expression is invalid.
+ */
+ExpressionProgram ExpressionProgram::compile(const String& infix) {
+  return compile(StringVector{infix});
+}
+
+/**
+ * @brief Compiles several infix expressions into one fused program.
+ *
+ * Identical subexpressions (including the variable x and constants) are
+ * stored only once, so a subterm shared by several expressions is evaluated
+ * a single time per point. Subexpressions with constant operands are folded
+ * at compile time, polynomials in x are rewritten in Horner's scheme and
+ * small integer powers are replaced by multiplications.
+ *
+ * @param infixes The infix expressions to be compiled.
+ * @return The compiled program with one output per expression.
+ * @throw std::invalid_argument If any of the expressions is invalid.
+ */
+ExpressionProgram ExpressionProgram::compile(const StringVector& infixes) {
+  if (infixes.empty()) {
+    throw std::invalid_argument("No expressions to compile");
+  }
+  ExpressionProgram program;
+  NodeMap nodes;
+  for (const auto& infix : infixes) {
+    program.appendRPN(ReversePolishNotation::toRPN(infix), nodes);
+  }
+  program.optimizePolynomials();
+  program.eliminateDeadCode();
+  return program;
+}
+
+/**
+ * @brief Evaluates one output of the program for a single value of x.
+ *
+ * Invalid operations (division by zero, root of a negative number,
+ * logarithm of a non-positive number) produce NaN instead of an exception.
+ * The slots are kept in a thread-local buffer, so concurrent calls do not
+ * share memory.
+ *
+ * @param x The value to substitute for 'x'.
+ * @param output The index of the output expression.
+ * @return The value of the selected expression.
+ */
+double ExpressionProgram::evaluate(double x, std::size_t output) const {
+  // слоты свои у каждого потока, поэтому вызов не выделяет память
+  thread_local std::vector<double> slots;
+  if (slots.size() < code_.size()) {
+    slots.resize(code_.size());
+  }
+  for (std::size_t i = 0; i < code_.size(); ++i) {
+    const Instruction& in = code_[i];
+    switch (in.op) {
+      case OP_CONST:
+        slots[i] = in.value;
+        break;
+      case OP_X:
+        slots[i] = x;
+        break;
+      default:
+        slots[i] = applyScalar(in.op, slots[in.lhs],
+                               in.rhs >= 0 ? slots[in.rhs] : 0.0);
+    }
+  }
+  return slots[outputs_.at(output)];
+}
+
+/**
+ * @brief Evaluates all outputs of the program for any number of x values
+ * in the scalar type T.
+ *
+ * @param x Pointer to the x values.
+ * @param n The number of values.
+ * @param columns Array of outputCount() pointers to the output columns.
+ */
+template <typename T>
+void ExpressionProgram::evaluate(const T* x, std::size_t n,
+                                 T* const* columns) const {
+  std::vector<T> scratch;
+  std::vector<T*> block(outputs_.size());
+  for (std::size_t start = 0; start < n; start += kBlockSize) {
+    for (std::size_t j = 0; j < outputs_.size(); ++j) {
+      block[j] = columns[j] + start;
+    }
+    evaluateBlock(x + start, std::min(kBlockSize, n - start), block.data(),
+                  scratch);
+  }
+}
+
+/**
+ * @brief Evaluates all outputs of the program for a block of x values.
+ *
+ * Every instruction is applied to the whole block before moving on to the
+ * next one, which keeps the dispatch cost per point low and lets the
+ * compiler vectorize the inner loops. The block is evaluated in the scalar
+ * type T (float, double or long double); constants are rounded to T.
+ *
+ * @param x Pointer to the block of x values.
+ * @param n The number of values in the block (not greater than kBlockSize).
+ * @param columns Array of outputCount() pointers to the output columns.
+ * @param scratch Caller-owned scratch buffer, resized as needed.
+ */
+template <typename T>
+void ExpressionProgram::evaluateBlock(const T* x, std::size_t n,
+                                      T* const* columns,
+                                      std::vector<T>& scratch) const {
+  if (scratch.size() < code_.size() * kBlockSize) {
+    scratch.resize(code_.size() * kBlockSize);
+  }
+  const T nan = std::numeric_limits<T>::quiet_NaN();
+
+  for (std::size_t i = 0; i < code_.size(); ++i) {
+    const Instruction& in = code_[i];
+    T* r = scratch.data() + i * kBlockSize;
+    const T* a = in.lhs >= 0 ? scratch.data() + in.lhs * kBlockSize : x;
+    const T* b = in.rhs >= 0 ? scratch.data() + in.rhs * kBlockSize : x;
+
+    switch (in.op) {
+      case OP_CONST:
+        std::fill(r, r + n, static_cast<T>(in.value));
+        break;
+      case OP_X:
+        std::memcpy(r, x, n * sizeof(T));
+        break;
+      case OP_ADD:
+        for (std::size_t k = 0; k < n; ++k) r[k] = a[k] + b[k];
+        break;
+      case OP_SUB:
+        for (std::size_t k = 0; k < n; ++k) r[k] = a[k] - b[k];
+        break;
+      case OP_MUL:
+        for (std::size_t k = 0; k < n; ++k) r[k] = a[k] * b[k];
+        break;
+      case OP_DIV:
+        for (std::size_t k = 0; k < n; ++k) {
+          r[k] = b[k] == T(0) ? nan : a[k] / b[k];
+        }
+        break;
+      case OP_NEG:
+        for (std::size_t k = 0; k < n; ++k) r[k] = -a[k];
+        break;
+      default:
+        // трансцендентные функции и операции с проверкой области определения
+        for (std::size_t k = 0; k < n; ++k) {
+          r[k] = applyScalar(in.op, a[k], isBinary(in.op) ? b[k] : T(0));
+        }
+    }
+  }
+
+  for (std::size_t j = 0; j < outputs_.size(); ++j) {
+    std::memcpy(columns[j], scratch.data() + outputs_[j] * kBlockSize,
+                n * sizeof(T));
+  }
+}
+
+/**
+ * @brief Evaluates all outputs of the program over a uniform grid of x.
+ *
+ * @param xRange The range of x values [first, second).
+ * @param pAmount The number of points in the grid.
+ * @return Row 0 holds the x values, rows 1..outputCount() hold the values
+ * of the corresponding expressions.
+ */
+Vector ExpressionProgram::evaluateGrid(std::pair<double, double> xRange,
+                                       unsigned pAmount) const {
+  Vector table(outputs_.size() + 1);
+  for (auto& row : table) row.reserve(pAmount);
+  evaluateGrid(xRange, pAmount,
+               [&table](const double* x, std::size_t n,
+                        const double* const* columns) {
+                 table[0].insert(table[0].end(), x, x + n);
+                 for (std::size_t j = 1; j < table.size(); ++j) {
+                   table[j].insert(table[j].end(), columns[j - 1],
+                                   columns[j - 1] + n);
+                 }
+               });
+  return table;
+}
+
+/**
+ * @brief Evaluates all outputs of the program over a uniform grid of x
+ * and passes the results to a sink block by block.
+ *
+ * Only one block of results exists at a time, so the grid can be much
+ * larger than the available memory if the sink streams it elsewhere.
+ *
+ * @param xRange The range of x values [first, second).
+ * @param pAmount The number of points in the grid.
+ * @param sink The function receiving x values and output columns
+ * of every block.
+ */
+void ExpressionProgram::evaluateGrid(std::pair<double, double> xRange,
+                                     std::size_t pAmount,
+                                     const BlockSink& sink) const {
+  double step = (xRange.second - xRange.first) / pAmount;
+  std::vector<double> scratch;
+  std::vector<double> x(kBlockSize);
+  std::vector<double> values(outputs_.size() * kBlockSize);
+  std::vector<double*> columns(outputs_.size());
+  for (std::size_t j = 0; j < outputs_.size(); ++j) {
+    columns[j] = values.data() + j * kBlockSize;
+  }
+
+  for (std::size_t start = 0; start < pAmount; start += kBlockSize) {
+    std::size_t n = std::min<std::size_t>(kBlockSize, pAmount - start);
+    for (std::size_t k = 0; k < n; ++k) {
+      x[k] = xRange.first + (start + k) * step;
+    }
+    evaluateBlock(x.data(), n, columns.data(), scratch);
+    sink(x.data(), n, columns.data());
+  }
+}
+
+/**
+ * @brief Estimates how visible the rounding of float evaluation is
+ * on a plot of every output.
+ *
+ * The outputs are evaluated over a uniform grid in float and in long
+ * double, the reference. The precision is sufficient if no point changes
+ * between finite and non-finite and the largest deviation stays within
+ * half a pixel of a plot of the whole span of reference values drawn
+ * with the given number of pixels.
+ *
+ * @param xRange The range of x values [first, second).
+ * @param pAmount The number of points in the grid.
+ * @param pixels The height of the plot in pixels.
+ * @return The report for every output.
+ * @throw std::invalid_argument If the grid or the plot is empty.
+ */
+std::vector<AccuracyReport> ExpressionProgram::checkAccuracy(
+    std::pair<double, double> xRange, std::size_t pAmount,
+    std::size_t pixels) const {
+  if (pAmount == 0 || pixels == 0) {
+    throw std::invalid_argument("Empty grid of accuracy check");
+  }
+  double step = (xRange.second - xRange.first) / pAmount;
+  std::vector<float> xf(pAmount);
+  std::vector<long double> xl(pAmount);
+  for (std::size_t k = 0; k < pAmount; ++k) {
+    double x = xRange.first + k * step;
+    xf[k] = static_cast<float>(x);
+    xl[k] = x;
+  }
+  std::vector<std::vector<float>> single(outputs_.size(),
+                                         std::vector<float>(pAmount));
+  std::vector<std::vector<long double>> reference(
+      outputs_.size(), std::vector<long double>(pAmount));
+  std::vector<float*> singleColumns;
+  std::vector<long double*> referenceColumns;
+  for (std::size_t j = 0; j < outputs_.size(); ++j) {
+    singleColumns.push_back(single[j].data());
+    referenceColumns.push_back(reference[j].data());
+  }
+  evaluate(xf.data(), pAmount, singleColumns.data());
+  evaluate(xl.data(), pAmount, referenceColumns.data());
+
+  std::vector<AccuracyReport> reports(outputs_.size());
+  for (std::size_t j = 0; j < outputs_.size(); ++j) {
+    AccuracyReport& report = reports[j];
+    long double low = std::numeric_limits<long double>::infinity();
+    long double high = -low, magnitude = 0;
+    for (std::size_t k = 0; k < pAmount; ++k) {
+      long double exact = reference[j][k];
+      bool finite = std::isfinite(exact);
+      if (finite != std::isfinite(single[j][k])) {
+        ++report.mismatches;
+      }
+      if (!finite || !std::isfinite(single[j][k])) continue;
+      low = std::min(low, exact);
+      high = std::max(high, exact);
+      magnitude = std::max(magnitude, std::fabs(exact));
+      long double error = std::fabs(single[j][k] - exact);
+      report.maxAbsError =
+          std::max(report.maxAbsError, static_cast<double>(error));
+      if (exact != 0) {
+        report.maxRelError = std::max(
+            report.maxRelError, static_cast<double>(error / std::fabs(exact)));
+      }
+    }
+    report.valueSpan = high > low ? static_cast<double>(high - low) : 0.0;
+    // у постоянного выражения масштаб графика задаёт само значение
+    double scale = report.valueSpan > 0.0 ? report.valueSpan
+                                          : static_cast<double>(magnitude);
+    report.sufficient = report.mismatches == 0 &&
+                        report.maxAbsError <= scale / pixels / 2;
+  }
+  return reports;
+}
+
+/**
+ * @brief Checks if an operation takes two operands.
+ *
+ * @param op The operation code.
+ * @return True if the operation is binary, false otherwise.
+ */
+bool ExpressionProgram::isBinary(OpCode op) {
+  return op >= OP_ADD && op <= OP_MOD;
+}
+
+/**
+ * @brief Checks if an operation takes one operand.
+ *
+ * @param op The operation code.
+ * @return True if the operation is unary, false otherwise.
+ */
+bool ExpressionProgram::isUnary(OpCode op) {
+  return op >= OP_SIN && op <= OP_NEG;
+}
+
+/**
+ * @brief Applies an operation to scalar operands.
+ *
+ * Unlike ModelCalculator, which throws on invalid operations, this function
+ * returns NaN so that a single bad point does not interrupt a whole block.
+ *
+ * @param op The operation code.
+ * @param a The first operand.
+ * @param b The second operand (ignored for unary operations).
+ * @return The result of the operation.
+ */
+template <typename T>
+T ExpressionProgram::applyScalar(OpCode op, T a, T b) {
+  const T nan = std::numeric_limits<T>::quiet_NaN();
+  switch (op) {
+    case OP_ADD:
+      return a + b;
+    case OP_SUB:
+      return a - b;
+    case OP_MUL:
+      return a * b;
+    case OP_DIV:
+      return b == T(0) ? nan : a / b;
+    case OP_POW:
+      return power(a, b);
+    case OP_MOD:
+      return b == T(0) ? nan : std::fmod(a, b);
+    case OP_SIN:
+      return std::sin(a);
+    case OP_COS:
+      return std::cos(a);
+    case OP_TAN:
+      return std::tan(a);
+    case OP_ASIN:
+      return std::asin(a);
+    case OP_ACOS:
+      return std::acos(a);
+    case OP_ATAN:
+      return std::atan(a);
+    case OP_SQRT:
+      return a < T(0) ? nan : std::sqrt(a);
+    case OP_LN:
+      return a <= T(0) ? nan : std::log(a);
+    case OP_LOG:
+      return a <= T(0) ? nan : std::log10(a);
+    case OP_NEG:
+      return -a;
+    default:
+      return nan;
+  }
+}
+
+/**
+ * @brief Raises a number to a power.
+ *
+ * Integer exponents from 0 to kMaxPower are computed by exponentiation by
+ * squaring, in the same order as the multiplications emitted by
+ * appendPower(), so that all evaluators give identical results.
+ *
+ * @param base The base.
+ * @param exponent The exponent.
+ * @return The base raised to the exponent.
+ */
+template <typename T>
+T ExpressionProgram::power(T base, T exponent) {
+  if (!isSmallPower(exponent)) {
+    return std::pow(base, exponent);
+  }
+  unsigned n = static_cast<unsigned>(exponent);
+  T result = 1;
+  while (n != 0) {
+    if (n & 1u) result *= base;
+    n >>= 1;
+    if (n != 0) base *= base;
+  }
+  return result;
+}
+
+/**
+ * @brief Raises a number to a power in double precision.
+ *
+ * @param base The base.
+ * @param exponent The exponent.
+ * @return The base raised to the exponent.
+ */
+double ExpressionProgram::power(double base, double exponent) {
+  return power<double>(base, exponent);
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Appends the instructions of an RPN expression to the program
+ * and registers its result as a new output.
+ *
+ * @param rpn The expression in RPN.
+ * @param nodes The map of already emitted instructions.
+ * @throw std::invalid_argument If the expression is invalid.
+ */
+void ExpressionProgram::appendRPN(const String& rpn, NodeMap& nodes) {
+  std::vector<int> stack;
+  String token;
+  std::istringstream iss(rpn);
+
+  while (iss >> token) {
+    OpCode op = tokenOpCode(token);
+    Instruction in = {op, -1, -1, 0.0};
+    if (op == OP_CONST) {
+      in.value = std::stod(token);
+    } else if (isBinary(op)) {
+      if (stack.size() < 2) {
+        throw std::invalid_argument(
+            "Invalid RPN expression: not enough operands");
+      }
+      in.rhs = stack.back();
+      stack.pop_back();
+      in.lhs = stack.back();
+      stack.pop_back();
+    } else if (isUnary(op)) {
+      if (stack.empty()) {
+        throw std::invalid_argument(
+            "Invalid RPN expression: not enough operands");
+      }
+      in.lhs = stack.back();
+      stack.pop_back();
+    }
+    stack.push_back(appendNode(in, nodes));
+  }
+
+  if (stack.size() != 1) {
+    throw std::invalid_argument("Invalid RPN expression");
+  }
+  outputs_.push_back(stack.back());
+}
+
+/**
+ * @brief Appends an instruction unless an identical one already exists.
+ *
+ * Instructions whose operands are all constants are folded into a constant.
+ *
+ * @param instruction The instruction to be appended.
+ * @param nodes The map of already emitted instructions.
+ * @return The slot holding the result of the instruction.
+ */
+int ExpressionProgram::appendNode(const Instruction& instruction,
+                                  NodeMap& nodes) {
+  Instruction in = instruction;
+  bool foldable = in.lhs >= 0 && code_[in.lhs].op == OP_CONST &&
+                  (in.rhs < 0 || code_[in.rhs].op == OP_CONST);
+  if (foldable) {
+    double b = in.rhs >= 0 ? code_[in.rhs].value : 0.0;
+    in = {OP_CONST, -1, -1, applyScalar(in.op, code_[in.lhs].value, b)};
+  }
+
+  std::uint64_t bits = 0;
+  std::memcpy(&bits, &in.value, sizeof(bits));
+  NodeKey key(in.op, in.lhs, in.rhs, bits);
+  auto it = nodes.find(key);
+  if (it != nodes.end()) {
+    return it->second;
+  }
+  code_.push_back(in);
+  int slot = static_cast<int>(code_.size()) - 1;
+  nodes.emplace(key, slot);
+  return slot;
+}
+
+/**
+ * @brief Removes the instructions that no output depends on
+ * (e.g. constants left behind by constant folding).
+ */
+void ExpressionProgram::eliminateDeadCode() {
+  std::vector<bool> live(code_.size(), false);
+  for (int out : outputs_) live[out] = true;
+  for (std::size_t i = code_.size(); i-- > 0;) {
+    if (!live[i]) continue;
+    if (code_[i].lhs >= 0) live[code_[i].lhs] = true;
+    if (code_[i].rhs >= 0) live[code_[i].rhs] = true;
+  }
+
+  std::vector<int> remap(code_.size(), -1);
+  InstructionVector compacted;
+  for (std::size_t i = 0; i < code_.size(); ++i) {
+    if (!live[i]) continue;
+    Instruction in = code_[i];
+    if (in.lhs >= 0) in.lhs = remap[in.lhs];
+    if (in.rhs >= 0) in.rhs = remap[in.rhs];
+    remap[i] = static_cast<int>(compacted.size());
+    compacted.push_back(in);
+  }
+  for (int& out : outputs_) out = remap[out];
+  code_ = std::move(compacted);
+}
+
+/**
+ * @brief Rewrites polynomial subexpressions and small integer powers.
+ *
+ * The coefficients of every subexpression that is a polynomial in x are
+ * collected bottom-up. Each polynomial used by a non-polynomial operation
+ * or as an output is emitted in Horner's scheme, with runs of zero
+ * coefficients skipped by a power of x. To keep the rewrite exact enough,
+ * a product is collected only if one factor is a monomial, so (x - a)^n is
+ * never expanded; it becomes a chain of multiplications instead of pow.
+ * A term of x is never folded to zero: x - x and 0 * x are NaN for an
+ * infinite or NaN x, so such subexpressions are kept as they are.
+ * Division is collected only by a power of two: x / 10 is not the same
+ * double as x * 0.1, so it stays a division.
+ */
+void ExpressionProgram::optimizePolynomials() {
+  std::vector<Polynomial> polynomials(code_.size());
+  for (std::size_t i = 0; i < code_.size(); ++i) {
+    Polynomial polynomial;
+    if (toPolynomial(code_[i], polynomials, polynomial)) {
+      polynomials[i] = std::move(polynomial);
+    }
+  }
+
+  ExpressionProgram result;
+  NodeMap nodes;
+  std::vector<int> remap(code_.size(), -1);
+  auto operand = [&](int slot) {
+    if (slot >= 0 && remap[slot] < 0) {
+      remap[slot] = result.appendHorner(polynomials[slot], nodes);
+    }
+    return slot >= 0 ? remap[slot] : -1;
+  };
+  for (std::size_t i = 0; i < code_.size(); ++i) {
+    if (!polynomials[i].empty()) continue;
+    Instruction in = code_[i];
+    if (in.op == OP_POW && code_[in.rhs].op == OP_CONST &&
+        isSmallPower(code_[in.rhs].value)) {
+      remap[i] = result.appendPower(
+          operand(in.lhs), static_cast<unsigned>(code_[in.rhs].value), nodes);
+      continue;
+    }
+    in.lhs = operand(in.lhs);
+    in.rhs = operand(in.rhs);
+    remap[i] = result.appendNode(in, nodes);
+  }
+  for (int out : outputs_) {
+    result.outputs_.push_back(operand(out));
+  }
+  *this = std::move(result);
+}
+
+/**
+ * @brief Collects the coefficients of an instruction if its result is
+ * a polynomial in x.
+ *
+ * @param in The instruction.
+ * @param polynomials The polynomials of the previous instructions
+ * (empty if not a polynomial).
+ * @param result The coefficients of the result.
+ * @return True if the result is a polynomial of degree up to kMaxDegree.
+ */
+bool ExpressionProgram::toPolynomial(const Instruction& in,
+                                     const std::vector<Polynomial>& polynomials,
+                                     Polynomial& result) const {
+  static const Polynomial kNone;
+  const Polynomial& a = in.lhs >= 0 ? polynomials[in.lhs] : kNone;
+  const Polynomial& b = in.rhs >= 0 ? polynomials[in.rhs] : kNone;
+  switch (in.op) {
+    case OP_CONST:
+      result = {in.value};
+      return true;
+    case OP_X:
+      result = {0.0, 1.0};
+      return true;
+    case OP_ADD:
+    case OP_SUB:
+      if (a.empty() || b.empty()) return false;
+      result.assign(std::max(a.size(), b.size()), 0.0);
+      for (std::size_t i = 0; i < a.size(); ++i) result[i] = a[i];
+      for (std::size_t i = 0; i < b.size(); ++i) {
+        result[i] = in.op == OP_ADD ? result[i] + b[i] : result[i] - b[i];
+      }
+      if (dropsTerm(a, result, 0) || dropsTerm(b, result, 0)) return false;
+      break;
+    case OP_NEG:
+      if (a.empty()) return false;
+      result = a;
+      for (double& c : result) c = -c;
+      break;
+    case OP_MUL:
+      // произведение двух многочленов не раскрывается (потеря точности)
+      if (a.empty() || b.empty() || (!isMonomial(a) && !isMonomial(b)) ||
+          a.size() + b.size() - 2 > kMaxDegree) {
+        return false;
+      }
+      result.assign(a.size() + b.size() - 1, 0.0);
+      for (std::size_t i = 0; i < a.size(); ++i) {
+        for (std::size_t j = 0; j < b.size(); ++j) {
+          if (a[i] != 0.0 && b[j] != 0.0) result[i + j] = a[i] * b[j];
+        }
+      }
+      if (dropsTerm(a, result, b.size() - 1) ||
+          dropsTerm(b, result, a.size() - 1)) {
+        return false;
+      }
+      break;
+    case OP_DIV:
+      // x / c и x * (1 / c) совпадают, только если 1 / c точно:
+      // делитель - степень двойки
+      if (a.empty() || b.size() != 1 || !isPowerOfTwo(b[0])) return false;
+      result = a;
+      for (double& c : result) c /= b[0];
+      if (dropsTerm(a, result, 0)) return false;
+      break;
+    case OP_POW: {
+      if (!isMonomial(a) || b.size() != 1 || !isSmallPower(b[0]) ||
+          (a.size() - 1) * b[0] > kMaxDegree) {
+        return false;
+      }
+      std::size_t degree = (a.size() - 1) * static_cast<std::size_t>(b[0]);
+      result.assign(degree + 1, 0.0);
+      result[degree] = power(a.back(), b[0]);
+      if (degree > 0 && result[degree] == 0.0) return false;
+      break;
+    }
+    default:
+      return false;
+  }
+  while (result.size() > 1 && result.back() == 0.0) result.pop_back();
+  return true;
+}
+
+/**
+ * @brief Appends a polynomial in x in Horner's scheme.
+ *
+ * @param polynomial The coefficients of the polynomial.
+ * @param nodes The map of already emitted instructions.
+ * @return The slot holding the value of the polynomial.
+ */
+int ExpressionProgram::appendHorner(const Polynomial& polynomial,
+                                    NodeMap& nodes) {
+  std::size_t degree = polynomial.size() - 1;
+  if (degree == 0) {
+    return appendNode({OP_CONST, -1, -1, polynomial[0]}, nodes);
+  }
+  int x = appendNode({OP_X, -1, -1, 0.0}, nodes);
+  // -1 - старший коэффициент равен единице и умножение не нужно
+  int result = polynomial[degree] == 1.0
+                   ? -1
+                   : appendNode({OP_CONST, -1, -1, polynomial[degree]}, nodes);
+  std::size_t pending = degree;
+  for (std::size_t j = degree; j-- > 0;) {
+    if (polynomial[j] == 0.0 && j != 0) continue;
+    int step = appendPower(x, static_cast<unsigned>(pending - j), nodes);
+    result = result < 0 ? step
+                        : appendNode({OP_MUL, result, step, 0.0}, nodes);
+    if (polynomial[j] != 0.0) {
+      int c = appendNode({OP_CONST, -1, -1, polynomial[j]}, nodes);
+      result = appendNode({OP_ADD, result, c, 0.0}, nodes);
+    }
+    pending = j;
+  }
+  return result;
+}
+
+/**
+ * @brief Appends an integer power as a chain of multiplications
+ * (exponentiation by squaring).
+ *
+ * @param base The slot of the base.
+ * @param exponent The exponent.
+ * @param nodes The map of already emitted instructions.
+ * @return The slot holding the power.
+ */
+int ExpressionProgram::appendPower(int base, unsigned exponent,
+                                   NodeMap& nodes) {
+  if (exponent == 0) {
+    return appendNode({OP_CONST, -1, -1, 1.0}, nodes);
+  }
+  int result = -1;
+  while (exponent != 0) {
+    if (exponent & 1u) {
+      result = result < 0 ? base
+                          : appendNode({OP_MUL, result, base, 0.0}, nodes);
+    }
+    exponent >>= 1;
+    if (exponent != 0) base = appendNode({OP_MUL, base, base, 0.0}, nodes);
+  }
+  return result;
+}
+
+/**
+ * @brief Checks if a polynomial has at most one non-zero coefficient.
+ *
+ * @param polynomial The coefficients of the polynomial.
+ * @return True for a monomial c * x^k.
+ */
+bool ExpressionProgram::isMonomial(const Polynomial& polynomial) {
+  if (polynomial.empty()) return false;
+  for (std::size_t i = 0; i + 1 < polynomial.size(); ++i) {
+    if (polynomial[i] != 0.0) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Checks if an operation cancelled a term of an operand that
+ * depends on x.
+ *
+ * A coefficient that became zero (x - x, 0 * x, an underflow) equals the
+ * operation only for a finite x, so the result is not a polynomial.
+ *
+ * @param operand The coefficients of the operand.
+ * @param result The coefficients of the result.
+ * @param shift The degree the terms of the operand are moved by.
+ * @return True if a non-zero term of x of the operand vanished.
+ */
+bool ExpressionProgram::dropsTerm(const Polynomial& operand,
+                                  const Polynomial& result,
+                                  std::size_t shift) {
+  for (std::size_t i = 1; i < operand.size(); ++i) {
+    if (operand[i] != 0.0 &&
+        (i + shift >= result.size() || result[i + shift] == 0.0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Checks if a number is a power of two with a normal reciprocal.
+ *
+ * Division by such a number is multiplication by its exact reciprocal,
+ * so a polynomial divided by it can be folded into its coefficients.
+ *
+ * @param value The number.
+ * @return True for +-2^k with both 2^k and 2^-k normal.
+ */
+bool ExpressionProgram::isPowerOfTwo(double value) {
+  int exponent = 0;
+  return std::isnormal(value) && std::isnormal(1.0 / value) &&
+         std::fabs(std::frexp(value, &exponent)) == 0.5;
+}
+
+/**
+ * @brief Checks if an exponent is an integer from 0 to kMaxPower.
+ *
+ * @param exponent The exponent.
+ * @return True if the power can be computed by multiplications.
+ */
+bool ExpressionProgram::isSmallPower(double exponent) {
+  return exponent >= 0.0 && exponent <= kMaxPower &&
+         exponent == std::floor(exponent);
+}
+
+/**
+ * @brief Determines the operation code of an RPN token.
+ *
+ * @param token The token to be classified.
+ * @return The operation code of the token.
+ * @throw std::invalid_argument If the token is unknown.
+ */
+OpCode ExpressionProgram::tokenOpCode(const String& token) {
+  if (token == "x") {
+    return OP_X;
+  }
+  std::istringstream iss(token);
+  double d;
+  if (!(iss >> d).fail()) {
+    return OP_CONST;
+  }
+  switch (token[0]) {
+    case '+':
+      return OP_ADD;
+    case '-':
+      return OP_SUB;
+    case '*':
+      return OP_MUL;
+    case '/':
+      return OP_DIV;
+    case '^':
+      return OP_POW;
+    case '%':
+      return OP_MOD;
+    case 's':
+      return OP_SIN;
+    case 'c':
+      return OP_COS;
+    case 't':
+      return OP_TAN;
+    case 'i':
+      return OP_ASIN;
+    case 'o':
+      return OP_ACOS;
+    case 'n':
+      return OP_ATAN;
+    case 'q':
+      return OP_SQRT;
+    case 'l':
+      return OP_LN;
+    case 'g':
+      return OP_LOG;
+    case '~':
+      return OP_NEG;
+    default:
+      throw std::invalid_argument("Unknown token: " + token);
+  }
+}
+
+// типы, в которых вычисляется программа
+template void ExpressionProgram::evaluate<float>(const float*, std::size_t,
+                                                 float* const*) const;
+template void ExpressionProgram::evaluate<double>(const double*, std::size_t,
+                                                  double* const*) const;
+template void ExpressionProgram::evaluate<long double>(
+    const long double*, std::size_t, long double* const*) const;
+template void ExpressionProgram::evaluateBlock<float>(
+    const float*, std::size_t, float* const*, std::vector<float>&) const;
+template void ExpressionProgram::evaluateBlock<double>(
+    const double*, std::size_t, double* const*, std::vector<double>&) const;
+template void ExpressionProgram::evaluateBlock<long double>(
+    const long double*, std::size_t, long double* const*,
+    std::vector<long double>&) const;
+template float ExpressionProgram::applyScalar<float>(OpCode, float, float);
+template double ExpressionProgram::applyScalar<double>(OpCode, double, double);
+template long double ExpressionProgram::applyScalar<long double>(
+    OpCode, long double, long double);
+template float ExpressionProgram::power<float>(float, float);
+template double ExpressionProgram::power<double>(double, double);
+template long double ExpressionProgram::power<long double>(long double,
+                                                           long double);
+
+}  // namespace s21
@@ -0,0 +1,163 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file expression_program.h
+ *
+ * @brief Declaration of the ExpressionProgram class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the ExpressionProgram class,
+ * which is part of the SmartCalc v2.0 library.
+ * The ExpressionProgram class compiles one or several infix expressions
+ * into a single fused program of instructions with shared common
+ * subexpressions and evaluates it block by block over a grid of x values.
+ * A compiled program is immutable: its const methods may be called from
+ * any number of threads at once.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_EXPRESSION_PROGRAM_H
+#define CPP3_S21_SMART_CALC_EXPRESSION_PROGRAM_H
+
+#include <cstddef>     // evaluateBlock
+#include <cstdint>     // NodeKey
+#include <functional>  // BlockSink
+#include <map>         // appendNode
+#include <stdexcept>   // compile
+#include <string>      // compile
+#include <tuple>       // NodeKey
+#include <utility>     // evaluateGrid
+#include <vector>      // code_, outputs_
+
+namespace s21 {
+
+enum OpCode {
+  OP_CONST,  // константа
+  OP_X,      // переменная x
+  OP_ADD,    // +
+  OP_SUB,    // -
+  OP_MUL,    // *
+  OP_DIV,    // /
+  OP_POW,    // ^
+  OP_MOD,    // %
+  OP_SIN,    // s
+  OP_COS,    // c
+  OP_TAN,    // t
+  OP_ASIN,   // i
+  OP_ACOS,   // o
+  OP_ATAN,   // n
+  OP_SQRT,   // q
+  OP_LN,     // l
+  OP_LOG,    // g
+  OP_NEG     // ~
+};
+
+// инструкция программы: результат каждой инструкции хранится в своём слоте
+struct Instruction {
+  OpCode op;     // код операции
+  int lhs;       // слот первого операнда (-1, если нет)
+  int rhs;       // слот второго операнда (-1, если нет)
+  double value;  // значение константы для OP_CONST
+};
+
+using String = std::string;
+using StringVector = std::vector<std::string>;
+using InstructionVector = std::vector<Instruction>;
+using Vector = std::vector<std::vector<double>>;
+// получатель блоков результатов: x, количество точек, столбцы значений
+using BlockSink =
+    std::function<void(const double*, std::size_t, const double* const*)>;
+
+// точность вычисления графиков
+enum class Precision {
+  Single,  // float: вдвое больше точек на SIMD-регистр, вдвое меньше памяти
+  Double   // double
+};
+
+// оценка погрешности вычисления выражения во float
+struct AccuracyReport {
+  double maxAbsError = 0.0;  // наибольшее отклонение от эталона long double
+  double maxRelError = 0.0;  // наибольшее относительное отклонение
+  double valueSpan = 0.0;    // размах эталонных значений
+  std::size_t mismatches = 0;  // точки, где конечно лишь одно из значений
+  bool sufficient = true;      // погрешность не видна на графике
+};
+
+class ExpressionProgram {
+ public:
+  // количество точек, обрабатываемых за один проход по программе
+  static constexpr std::size_t kBlockSize = 256;
+  // наибольший показатель степени, вычисляемой умножениями
+  static constexpr unsigned kMaxPower = 64;
+  // наибольшая степень многочлена, вычисляемого по схеме Горнера
+  static constexpr std::size_t kMaxDegree = 32;
+
+  ExpressionProgram() = default;
+
+  // Main methods:
+  static ExpressionProgram compile(const String& infix);
+  static ExpressionProgram compile(const StringVector& infixes);
+
+  double evaluate(double x, std::size_t output = 0) const;
+  template <typename T>
+  void evaluate(const T* x, std::size_t n, T* const* columns) const;
+  template <typename T>
+  void evaluateBlock(const T* x, std::size_t n, T* const* columns,
+                     std::vector<T>& scratch) const;
+  Vector evaluateGrid(std::pair<double, double> xRange,
+                      unsigned pAmount) const;
+  void evaluateGrid(std::pair<double, double> xRange, std::size_t pAmount,
+                    const BlockSink& sink) const;
+  std::vector<AccuracyReport> checkAccuracy(std::pair<double, double> xRange,
+                                            std::size_t pAmount,
+                                            std::size_t pixels = 1024) const;
+
+  // Accessors:
+  std::size_t outputCount() const { return outputs_.size(); }
+  std::size_t size() const { return code_.size(); }
+  const InstructionVector& instructions() const { return code_; }
+  const std::vector<int>& outputs() const { return outputs_; }
+
+  static bool isBinary(OpCode op);
+  static bool isUnary(OpCode op);
+  template <typename T>
+  static T applyScalar(OpCode op, T a, T b);
+  static double power(double base, double exponent);
+  template <typename T>
+  static T power(T base, T exponent);
+
+ private:
+  using NodeKey = std::tuple<int, int, int, std::uint64_t>;
+  using NodeMap = std::map<NodeKey, int>;
+  // коэффициенты многочлена от x, начиная со свободного члена
+  using Polynomial = std::vector<double>;
+
+  // Auxiliary methods:
+  void appendRPN(const String& rpn, NodeMap& nodes);
+  int appendNode(const Instruction& instruction, NodeMap& nodes);
+  void eliminateDeadCode();
+  void optimizePolynomials();
+  int appendHorner(const Polynomial& polynomial, NodeMap& nodes);
+  int appendPower(int base, unsigned exponent, NodeMap& nodes);
+  bool toPolynomial(const Instruction& in,
+                    const std::vector<Polynomial>& polynomials,
+                    Polynomial& result) const;
+  static bool isMonomial(const Polynomial& polynomial);
+  static bool dropsTerm(const Polynomial& operand, const Polynomial& result,
+                        std::size_t shift);
+  static bool isSmallPower(double exponent);
+  static bool isPowerOfTwo(double value);
+  static OpCode tokenOpCode(const String& token);
+
+  InstructionVector code_;
+  std::vector<int> outputs_;
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_EXPRESSION_PROGRAM_H
@@ -0,0 +1,321 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file jit_program.cc
+ *
+ * @brief Implementation of the JitProgram class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the JitProgram class,
+ * which is part of the SmartCalc v2.0 library.
+ * The JitProgram class translates a compiled ExpressionProgram directly
+ * into x86-64 machine code in executable memory, without an external
+ * compiler. On other architectures it falls back to the interpreter.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "jit_program.h"
+
+#include <sys/mman.h>  // mmap, mprotect, munmap
+#include <unistd.h>    // sysconf
+
+#include <algorithm>         // std::min, std::fill
+#include <cstring>           // std::memcpy
+#include <initializer_list>  // emit
+#include <limits>            // std::numeric_limits
+
+namespace s21 {
+
+namespace {
+
+// размер строки значений одной инструкции в байтах
+constexpr std::size_t kRow = ExpressionProgram::kBlockSize * sizeof(double);
+
+/**
+ * @brief Appends bytes of machine code.
+ */
+void emit(JitProgram::Code& code, std::initializer_list<std::uint8_t> bytes) {
+  code.insert(code.end(), bytes);
+}
+
+/**
+ * @brief Appends a little-endian immediate value of the given width.
+ */
+void emitValue(JitProgram::Code& code, std::uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) {
+    code.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+  }
+}
+
+/**
+ * @brief Returns the bits of the NaN the interpreter gives for invalid points.
+ */
+std::uint64_t quietNanBits() {
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  std::uint64_t bits;
+  std::memcpy(&bits, &nan, sizeof(bits));
+  return bits;
+}
+
+/**
+ * @brief Appends "lea reg, [rbx + slot * kRow]"; modrm selects the register.
+ */
+void emitRow(JitProgram::Code& code, std::uint8_t modrm, int slot) {
+  emit(code, {0x48, 0x8D, modrm});
+  emitValue(code, slot * kRow, 4);
+}
+
+/**
+ * @brief Appends a loop over pairs of points: xmm0 = a[k], xmm1 = b[k],
+ * the body, r[k] = xmm0 (rsi = a, rdi = b, rdx = r, r13 = count).
+ */
+void emitLoop(JitProgram::Code& code,
+              std::initializer_list<std::uint8_t> body) {
+  emit(code, {0x31, 0xC0});                    // xor eax, eax
+  std::size_t top = code.size();
+  emit(code, {0x66, 0x0F, 0x10, 0x04, 0xC6});  // movupd xmm0, [rsi + rax*8]
+  emit(code, {0x66, 0x0F, 0x10, 0x0C, 0xC7});  // movupd xmm1, [rdi + rax*8]
+  emit(code, body);
+  emit(code, {0x66, 0x0F, 0x11, 0x04, 0xC2});  // movupd [rdx + rax*8], xmm0
+  emit(code, {0x48, 0x83, 0xC0, 0x02});        // add rax, 2
+  emit(code, {0x4C, 0x39, 0xE8});              // cmp rax, r13
+  emit(code, {0x72, static_cast<std::uint8_t>(top - code.size() - 2)});  // jb
+}
+
+/**
+ * @brief Applies an operation to whole rows of values; called from the
+ * generated code for functions without a single SSE instruction.
+ */
+void applyRow(const double* a, const double* b, double* r, std::size_t n,
+              int op) {
+  OpCode code = static_cast<OpCode>(op);
+  for (std::size_t k = 0; k < n; ++k) {
+    r[k] = ExpressionProgram::applyScalar(code, a[k], b[k]);
+  }
+}
+
+/**
+ * @brief Rounds a size up to a whole number of memory pages.
+ */
+std::size_t pageLength(std::size_t size) {
+  std::size_t page = sysconf(_SC_PAGESIZE);
+  return (size + page - 1) / page * page;
+}
+
+}  // namespace
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Releases the executable memory.
+ */
+JitProgram::~JitProgram() {
+  if (memory_ != nullptr) {
+    munmap(memory_, pageLength(size_));
+  }
+}
+
+/**
+ * @brief Translates a compiled program into machine code.
+ *
+ * Translation is a single pass over the instructions, so it takes
+ * microseconds and can be done for every expression typed by the user.
+ * If the code cannot be installed (other architecture, no executable
+ * memory) the program is still usable and runs in the interpreter.
+ *
+ * @param program The compiled program.
+ * @return The translated program.
+ */
+std::shared_ptr<JitProgram> JitProgram::compile(
+    const ExpressionProgram& program) {
+  std::shared_ptr<JitProgram> jit(new JitProgram(program));
+  if (supported()) {
+    jit->install(generateCode(program));
+  }
+  return jit;
+}
+
+/**
+ * @brief Checks if machine code can be generated on this platform.
+ *
+ * @return True on x86-64 with the System V calling convention.
+ */
+bool JitProgram::supported() {
+#if defined(__x86_64__) && !defined(_WIN32)
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Evaluates all outputs of the program for the given x values.
+ *
+ * @param x Pointer to the x values.
+ * @param n The number of values (any).
+ * @param columns Array of outputCount() pointers to the output columns.
+ */
+void JitProgram::evaluate(const double* x, std::size_t n,
+                          double* const* columns) const {
+  if (kernel_ == nullptr) {
+    program_.evaluate(x, n, columns);
+    return;
+  }
+  const std::size_t block = ExpressionProgram::kBlockSize;
+  const InstructionVector& code = program_.instructions();
+  // константы заполняются один раз, машинный код их не перезаписывает
+  std::vector<double> rows(code.size() * block);
+  for (std::size_t i = 0; i < code.size(); ++i) {
+    if (code[i].op == OP_CONST) {
+      std::fill(rows.begin() + i * block, rows.begin() + (i + 1) * block,
+                code[i].value);
+    }
+  }
+
+  for (std::size_t start = 0; start < n; start += block) {
+    std::size_t count = std::min(block, n - start);
+    for (std::size_t i = 0; i < code.size(); ++i) {
+      if (code[i].op == OP_X) {
+        std::memcpy(rows.data() + i * block, x + start,
+                    count * sizeof(double));
+      }
+    }
+    // код обрабатывает точки парами, лишняя точка блока не копируется
+    kernel_(rows.data(), (count + 1) & ~std::size_t(1));
+    for (std::size_t j = 0; j < program_.outputCount(); ++j) {
+      std::memcpy(columns[j] + start,
+                  rows.data() + program_.outputs()[j] * block,
+                  count * sizeof(double));
+    }
+  }
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Generates x86-64 machine code for a program.
+ *
+ * The function takes rows of kBlockSize values per instruction (rdi) and
+ * an even number of points (rsi). Arithmetic is done with packed SSE2
+ * instructions two points at a time; other functions are applied to whole
+ * rows by a call into applyRow, so the call cost is shared by the row.
+ * Division by zero gives the interpreter's quiet NaN, selected through
+ * a comparison mask.
+ *
+ * @param program The compiled program.
+ * @return The machine code (empty if the program is too large).
+ */
+JitProgram::Code JitProgram::generateCode(const ExpressionProgram& program) {
+  const InstructionVector& instructions = program.instructions();
+  Code code;
+  if (instructions.size() * kRow >
+      std::size_t(std::numeric_limits<std::int32_t>::max())) {
+    return code;
+  }
+
+  emit(code, {0x53});                    // push rbx
+  emit(code, {0x41, 0x55});              // push r13
+  emit(code, {0x48, 0x83, 0xEC, 0x08});  // sub rsp, 8 (выравнивание стека)
+  emit(code, {0x48, 0x89, 0xFB});        // mov rbx, rdi
+  emit(code, {0x49, 0x89, 0xF5});        // mov r13, rsi
+
+  for (std::size_t i = 0; i < instructions.size(); ++i) {
+    const Instruction& in = instructions[i];
+    if (in.op == OP_CONST || in.op == OP_X) continue;
+    int rhs = ExpressionProgram::isBinary(in.op) ? in.rhs : in.lhs;
+    int slot = static_cast<int>(i);
+
+    if (in.op == OP_ADD || in.op == OP_SUB || in.op == OP_MUL ||
+        in.op == OP_DIV || in.op == OP_SQRT || in.op == OP_NEG) {
+      emitRow(code, 0xB3, in.lhs);  // lea rsi, a
+      emitRow(code, 0xBB, rhs);     // lea rdi, b
+      emitRow(code, 0x93, slot);    // lea rdx, r
+    }
+    switch (in.op) {
+      case OP_ADD:
+        emitLoop(code, {0x66, 0x0F, 0x58, 0xC1});  // addpd xmm0, xmm1
+        break;
+      case OP_SUB:
+        emitLoop(code, {0x66, 0x0F, 0x5C, 0xC1});  // subpd xmm0, xmm1
+        break;
+      case OP_MUL:
+        emitLoop(code, {0x66, 0x0F, 0x59, 0xC1});  // mulpd xmm0, xmm1
+        break;
+      case OP_DIV:
+        // тот же NaN, что и у интерпретатора, в обеих половинах xmm3
+        emit(code, {0x48, 0xB9});  // mov rcx, nan
+        emitValue(code, quietNanBits(), 8);
+        emit(code, {0x66, 0x48, 0x0F, 0x6E, 0xD9});  // movq xmm3, rcx
+        emit(code, {0x66, 0x0F, 0x6C, 0xDB});  // punpcklqdq xmm3, xmm3
+        emitLoop(code, {0x66, 0x0F, 0x5E, 0xC1,  // divpd xmm0, xmm1
+                        0x66, 0x0F, 0x57, 0xD2,  // xorpd xmm2, xmm2
+                        0x66, 0x0F, 0xC2, 0xD1, 0x00,  // cmpeqpd xmm2, xmm1
+                        0x66, 0x0F, 0x28, 0xE2,  // movapd xmm4, xmm2
+                        0x66, 0x0F, 0x54, 0xE3,  // andpd xmm4, xmm3
+                        0x66, 0x0F, 0x55, 0xD0,  // andnpd xmm2, xmm0
+                        0x66, 0x0F, 0x56, 0xD4,  // orpd xmm2, xmm4
+                        0x66, 0x0F, 0x28, 0xC2});  // movapd xmm0, xmm2
+        break;
+      case OP_SQRT:
+        // sqrtpd отрицательного числа даёт NaN, как и интерпретатор
+        emitLoop(code, {0x66, 0x0F, 0x51, 0xC0});  // sqrtpd xmm0, xmm0
+        break;
+      case OP_NEG:
+        emitLoop(code, {0x66, 0x0F, 0x76, 0xD2,  // pcmpeqd xmm2, xmm2
+                        0x66, 0x0F, 0x73, 0xF2, 0x3F,  // psllq xmm2, 63
+                        0x66, 0x0F, 0x57, 0xC2});  // xorpd xmm0, xmm2
+        break;
+      default:
+        emitRow(code, 0xBB, in.lhs);  // lea rdi, a
+        emitRow(code, 0xB3, rhs);  // lea rsi, b
+        emitRow(code, 0x93, slot);  // lea rdx, r
+        emit(code, {0x4C, 0x89, 0xE9});  // mov rcx, r13
+        emit(code, {0x41, 0xB8});  // mov r8d, op
+        emitValue(code, in.op, 4);
+        emit(code, {0x48, 0xB8});  // mov rax, applyRow
+        emitValue(code, reinterpret_cast<std::uintptr_t>(&applyRow), 8);
+        emit(code, {0xFF, 0xD0});  // call rax
+    }
+  }
+
+  emit(code, {0x48, 0x83, 0xC4, 0x08});  // add rsp, 8
+  emit(code, {0x41, 0x5D});              // pop r13
+  emit(code, {0x5B});                    // pop rbx
+  emit(code, {0xC3});                    // ret
+  return code;
+}
+
+/**
+ * @brief Copies machine code into executable memory.
+ *
+ * The pages are writable while the code is copied and executable after
+ * that, never both at once. On failure the program stays interpreted.
+ *
+ * @param code The machine code.
+ */
+void JitProgram::install(const Code& code) {
+  if (code.empty()) return;
+  std::size_t length = pageLength(code.size());
+  void* memory = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) return;
+  std::memcpy(memory, code.data(), code.size());
+  if (mprotect(memory, length, PROT_READ | PROT_EXEC) != 0) {
+    munmap(memory, length);
+    return;
+  }
+  memory_ = memory;
+  size_ = code.size();
+  kernel_ = reinterpret_cast<Kernel>(memory);
+}
+
+}  // namespace s21
@@ -0,0 +1,70 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file jit_program.h
+ *
+ * @brief Declaration of the JitProgram class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the JitProgram class,
+ * which is part of the SmartCalc v2.0 library.
+ * The JitProgram class translates a compiled ExpressionProgram directly
+ * into x86-64 machine code in executable memory, without an external
+ * compiler. On other architectures it falls back to the interpreter.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_JIT_PROGRAM_H
+#define CPP3_S21_SMART_CALC_JIT_PROGRAM_H
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <memory>   // compile
+#include <vector>   // Code
+
+#include "expression_program.h"
+
+namespace s21 {
+
+class JitProgram {
+ public:
+  // сигнатура сгенерированной функции: строки значений, количество точек
+  using Kernel = void (*)(double*, std::size_t);
+  using Code = std::vector<std::uint8_t>;
+
+  ~JitProgram();
+  JitProgram(const JitProgram&) = delete;
+  JitProgram& operator=(const JitProgram&) = delete;
+
+  // Main methods:
+  static std::shared_ptr<JitProgram> compile(const ExpressionProgram& program);
+  static bool supported();
+
+  void evaluate(const double* x, std::size_t n, double* const* columns) const;
+
+  // Accessors:
+  std::size_t outputCount() const { return program_.outputCount(); }
+  std::size_t codeSize() const { return size_; }
+  bool isNative() const { return kernel_ != nullptr; }
+
+ private:
+  explicit JitProgram(const ExpressionProgram& program) : program_(program) {}
+
+  // Auxiliary methods:
+  static Code generateCode(const ExpressionProgram& program);
+  void install(const Code& code);
+
+  ExpressionProgram program_;  // исходная программа (константы, x, выходы)
+  void* memory_ = nullptr;     // исполняемые страницы
+  std::size_t size_ = 0;       // размер машинного кода
+  Kernel kernel_ = nullptr;    // точка входа (nullptr - интерпретатор)
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_JIT_PROGRAM_H
@@ -0,0 +1,287 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file lod_pyramid.cc
+ *
+ * @brief Implementation of the LodPyramid class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the LodPyramid class,
+ * which is part of the SmartCalc v2.0 library.
+ * The LodPyramid class keeps a level-of-detail pyramid of minimums and
+ * maximums over a large data series, so that the series can be shown at
+ * any zoom level in time proportional to the number of pixels.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "lod_pyramid.h"
+
+#include <algorithm>  // std::lower_bound
+#include <cmath>      // std::fmin, std::fmax, NAN
+#include <cstring>    // std::memcmp
+#include <fstream>    // save, load
+
+namespace s21 {
+
+namespace {
+
+// сигнатура файла пирамиды
+const char kMagic[8] = {'S', '2', '1', 'L', 'O', 'D', '0', '1'};
+
+}  // namespace
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Builds the pyramid over a data series.
+ *
+ * Level 0 groups factor points, every next level groups factor entries
+ * of the previous one. NaN values are ignored; a group consisting only of
+ * NaN values has NaN as its minimum and maximum.
+ *
+ * @param y The values of the series.
+ * @param n The number of values.
+ * @param factor How many times every level is coarser than the previous one.
+ * @throw std::invalid_argument If the factor is less than 2.
+ */
+void LodPyramid::build(const double* y, std::size_t n, unsigned factor) {
+  if (factor < 2) {
+    throw std::invalid_argument("LOD factor must be at least 2");
+  }
+  factor_ = factor;
+  size_ = n;
+  levels_.clear();
+
+  // первый уровень строим по исходным точкам
+  const double* srcMin = y;
+  const double* srcMax = y;
+  std::size_t srcCount = n;
+  std::size_t bucket = factor;
+
+  while (srcCount > 1) {
+    LodLevel level;
+    level.bucket = bucket;
+    std::size_t count = (srcCount + factor - 1) / factor;
+    level.min.assign(count, NAN);
+    level.max.assign(count, NAN);
+    for (std::size_t i = 0; i < srcCount; ++i) {
+      merge(level.min[i / factor], level.max[i / factor], srcMin[i],
+            srcMax[i]);
+    }
+    levels_.push_back(std::move(level));
+
+    // следующий уровень строим по предыдущему
+    srcMin = levels_.back().min.data();
+    srcMax = levels_.back().max.data();
+    srcCount = count;
+    bucket *= factor;
+  }
+}
+
+/**
+ * @brief Calculates the envelope of the series for a range of x values.
+ *
+ * For each pixel the coarsest level whose groups are not wider than a pixel
+ * is used, and the edges of the pixel are completed from the finer levels,
+ * so the result is exact and the cost does not depend on the number of
+ * points in the range.
+ *
+ * @param x The sorted x values of the series.
+ * @param y The values of the series (the data the pyramid was built from).
+ * @param n The number of points.
+ * @param xMin The left border of the visible range.
+ * @param xMax The right border of the visible range.
+ * @param pixels The number of pixels in the visible range.
+ * @return The minimum and maximum of the series for every pixel.
+ * @throw std::invalid_argument If the arguments do not match the pyramid.
+ */
+LodSlice LodPyramid::query(const double* x, const double* y, std::size_t n,
+                           double xMin, double xMax, unsigned pixels) const {
+  if (n != size_ || pixels == 0 || !(xMin < xMax)) {
+    throw std::invalid_argument("Invalid LOD query");
+  }
+  LodSlice slice;
+  slice.x.resize(pixels);
+  slice.min.assign(pixels, NAN);
+  slice.max.assign(pixels, NAN);
+
+  double width = (xMax - xMin) / pixels;
+  std::size_t first = std::lower_bound(x, x + n, xMin) - x;
+  std::size_t last = std::upper_bound(x, x + n, xMax) - x;
+  double pointsPerPixel = double(last - first) / pixels;
+  int level = chooseLevel(pointsPerPixel);
+
+  std::size_t a = first;
+  for (unsigned p = 0; p < pixels; ++p) {
+    slice.x[p] = xMin + (p + 0.5) * width;
+    // граница пикселя в индексах исходного ряда
+    std::size_t b =
+        p + 1 == pixels
+            ? last
+            : std::lower_bound(x + a, x + last, xMin + (p + 1) * width) - x;
+    accumulate(y, a, b, level, slice.min[p], slice.max[p]);
+    a = b;
+  }
+  return slice;
+}
+
+/**
+ * @brief Saves the pyramid to a file next to the data.
+ *
+ * @param path The path of the file.
+ * @throw std::runtime_error If the file cannot be written.
+ */
+void LodPyramid::save(const std::string& path) const {
+  std::ofstream file(path, std::ios::binary);
+  std::uint32_t factor = factor_;
+  std::uint64_t size = size_;
+  std::uint64_t count = levels_.size();
+  file.write(kMagic, sizeof(kMagic));
+  file.write(reinterpret_cast<const char*>(&factor), sizeof(factor));
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  for (const LodLevel& level : levels_) {
+    std::uint64_t bucket = level.bucket;
+    std::uint64_t entries = level.min.size();
+    file.write(reinterpret_cast<const char*>(&bucket), sizeof(bucket));
+    file.write(reinterpret_cast<const char*>(&entries), sizeof(entries));
+    file.write(reinterpret_cast<const char*>(level.min.data()),
+               entries * sizeof(double));
+    file.write(reinterpret_cast<const char*>(level.max.data()),
+               entries * sizeof(double));
+  }
+  if (!file) {
+    throw std::runtime_error("Cannot write LOD pyramid: " + path);
+  }
+}
+
+/**
+ * @brief Loads a pyramid saved by save().
+ *
+ * @param path The path of the file.
+ * @param n The number of points of the data the pyramid must belong to.
+ * @throw std::runtime_error If the file is missing, damaged or was built
+ * for another series.
+ */
+void LodPyramid::load(const std::string& path, std::size_t n) {
+  std::ifstream file(path, std::ios::binary);
+  char magic[sizeof(kMagic)] = {};
+  std::uint32_t factor = 0;
+  std::uint64_t size = 0;
+  std::uint64_t count = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&factor), sizeof(factor));
+  file.read(reinterpret_cast<char*>(&size), sizeof(size));
+  file.read(reinterpret_cast<char*>(&count), sizeof(count));
+  if (!file || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      size != n || factor < 2 || count > 64) {
+    throw std::runtime_error("Invalid LOD pyramid file: " + path);
+  }
+
+  std::vector<LodLevel> levels(count);
+  std::uint64_t previous = 1;
+  for (LodLevel& level : levels) {
+    std::uint64_t bucket = 0;
+    std::uint64_t entries = 0;
+    file.read(reinterpret_cast<char*>(&bucket), sizeof(bucket));
+    file.read(reinterpret_cast<char*>(&entries), sizeof(entries));
+    // группы уровня в factor раз больше групп предыдущего (как в build),
+    // а записи покрывают все точки ряда; иначе query читает мимо данных
+    if (!file || previous > UINT64_MAX / factor ||
+        bucket != previous * factor ||
+        entries != n / bucket + (n % bucket != 0)) {
+      throw std::runtime_error("Invalid LOD pyramid file: " + path);
+    }
+    previous = bucket;
+    level.bucket = bucket;
+    level.min.resize(entries);
+    level.max.resize(entries);
+    file.read(reinterpret_cast<char*>(level.min.data()),
+              entries * sizeof(double));
+    file.read(reinterpret_cast<char*>(level.max.data()),
+              entries * sizeof(double));
+  }
+  if (!file) {
+    throw std::runtime_error("Invalid LOD pyramid file: " + path);
+  }
+  factor_ = factor;
+  size_ = n;
+  levels_ = std::move(levels);
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Chooses the coarsest level whose groups fit into a pixel.
+ *
+ * @param pointsPerPixel The number of points of the series per pixel.
+ * @return The index of the chosen level or -1 (the raw data) if even
+ * the first level is too coarse.
+ */
+int LodPyramid::chooseLevel(double pointsPerPixel) const {
+  int chosen = -1;
+  for (size_t i = 0; i < levels_.size(); ++i) {
+    if (double(levels_[i].bucket) > pointsPerPixel) break;
+    chosen = static_cast<int>(i);
+  }
+  return chosen;
+}
+
+/**
+ * @brief Accumulates the minimum and maximum of the points [a, b).
+ *
+ * Full groups of the given level are taken from the pyramid, the remaining
+ * points at the edges are taken from the finer levels.
+ *
+ * @param y The values of the series.
+ * @param a The first point of the range.
+ * @param b The point after the last one of the range.
+ * @param level The level to be used (-1 for the raw data).
+ * @param min The accumulated minimum.
+ * @param max The accumulated maximum.
+ */
+void LodPyramid::accumulate(const double* y, std::size_t a, std::size_t b,
+                            int level, double& min, double& max) const {
+  if (a >= b) return;
+  if (level < 0) {
+    for (std::size_t i = a; i < b; ++i) merge(min, max, y[i], y[i]);
+    return;
+  }
+  const LodLevel& current = levels_[level];
+  std::size_t first = (a + current.bucket - 1) / current.bucket;
+  std::size_t last = b / current.bucket;
+  if (first >= last) {
+    accumulate(y, a, b, level - 1, min, max);
+    return;
+  }
+  for (std::size_t k = first; k < last; ++k) {
+    merge(min, max, current.min[k], current.max[k]);
+  }
+  accumulate(y, a, first * current.bucket, level - 1, min, max);
+  accumulate(y, last * current.bucket, b, level - 1, min, max);
+}
+
+/**
+ * @brief Merges a range [lo, hi] into an accumulated minimum and maximum,
+ * ignoring NaN values.
+ *
+ * @param min The accumulated minimum.
+ * @param max The accumulated maximum.
+ * @param lo The minimum to be merged.
+ * @param hi The maximum to be merged.
+ */
+void LodPyramid::merge(double& min, double& max, double lo, double hi) {
+  min = std::fmin(min, lo);
+  max = std::fmax(max, hi);
+}
+
+}  // namespace s21
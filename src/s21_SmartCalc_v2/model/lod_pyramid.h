@@ -0,0 +1,78 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file lod_pyramid.h
+ *
+ * @brief Declaration of the LodPyramid class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the LodPyramid class,
+ * which is part of the SmartCalc v2.0 library.
+ * The LodPyramid class keeps a level-of-detail pyramid of minimums and
+ * maximums over a large data series, so that the series can be shown at
+ * any zoom level in time proportional to the number of pixels.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_LOD_PYRAMID_H
+#define CPP3_S21_SMART_CALC_LOD_PYRAMID_H
+
+#include <cstddef>    // size_t
+#include <cstdint>    // save, load
+#include <stdexcept>  // build, query, load
+#include <string>     // save, load
+#include <vector>     // LodLevel
+
+namespace s21 {
+
+// один уровень пирамиды: минимум и максимум по каждой группе точек
+struct LodLevel {
+  std::size_t bucket;        // количество исходных точек в группе
+  std::vector<double> min;   // минимумы групп
+  std::vector<double> max;   // максимумы групп
+};
+
+// результат запроса: огибающая ряда по пикселям
+struct LodSlice {
+  std::vector<double> x;    // центры пикселей
+  std::vector<double> min;  // минимум значений в пикселе
+  std::vector<double> max;  // максимум значений в пикселе
+};
+
+class LodPyramid {
+ public:
+  LodPyramid() = default;
+
+  // Main methods:
+  void build(const double* y, std::size_t n, unsigned factor = 8);
+  LodSlice query(const double* x, const double* y, std::size_t n,
+                 double xMin, double xMax, unsigned pixels) const;
+
+  void save(const std::string& path) const;
+  void load(const std::string& path, std::size_t n);
+
+  // Accessors:
+  unsigned factor() const { return factor_; }
+  std::size_t size() const { return size_; }
+  const std::vector<LodLevel>& levels() const { return levels_; }
+
+ private:
+  // Auxiliary methods:
+  int chooseLevel(double pointsPerPixel) const;
+  void accumulate(const double* y, std::size_t a, std::size_t b, int level,
+                  double& min, double& max) const;
+  static void merge(double& min, double& max, double lo, double hi);
+
+  unsigned factor_ = 8;
+  std::size_t size_ = 0;
+  std::vector<LodLevel> levels_;
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_LOD_PYRAMID_H
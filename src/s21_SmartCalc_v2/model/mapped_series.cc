@@ -0,0 +1,343 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file mapped_series.cc
+ *
+ * @brief Implementation of the MappedSeries class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the MappedSeries class,
+ * which is part of the SmartCalc v2.0 library.
+ * The MappedSeries class stores a series of evaluated values in a
+ * memory-mapped file that grows in fixed-size chunks, so the size of the
+ * series is limited by disk space rather than by RAM.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "mapped_series.h"
+
+#include <fcntl.h>     // ::open, posix_fallocate
+#include <sys/mman.h>  // mmap, munmap, msync
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // ftruncate, pread, pwrite, sysconf
+
+#include <algorithm>  // std::min
+#include <cerrno>     // errno
+#include <cstring>    // std::memcpy, std::strerror
+#include <utility>    // std::swap
+
+namespace s21 {
+
+namespace {
+
+// заголовок файла ряда
+struct SeriesHeader {
+  char magic[8];              // сигнатура файла
+  std::uint64_t size;         // количество точек
+  std::uint64_t chunkPoints;  // количество точек во фрагменте
+};
+
+const char kMagic[8] = {'S', '2', '1', 'S', 'E', 'R', '0', '1'};
+
+/**
+ * @brief Extends a file, allocating its new blocks on the disk.
+ *
+ * @param fd The file.
+ * @param begin The current size of the file.
+ * @param length The number of bytes to be added.
+ * @return 0 or the error code.
+ */
+int allocate(int fd, off_t begin, off_t length) {
+#if defined(__APPLE__)
+  // в macOS нет posix_fallocate: блоки резервируются через fcntl
+  fstore_t store = {F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, length, 0};
+  if (fcntl(fd, F_PREALLOCATE, &store) == -1) {
+    store.fst_flags = F_ALLOCATEALL;
+    if (fcntl(fd, F_PREALLOCATE, &store) == -1) return errno;
+  }
+  return ftruncate(fd, begin + length) == 0 ? 0 : errno;
+#else
+  return posix_fallocate(fd, begin, length);
+#endif
+}
+
+}  // namespace
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTOR
+ ******************************************************************************/
+
+/**
+ * @brief Creates a new empty series file (an existing file is truncated).
+ *
+ * @param path The path of the file.
+ * @param chunkPoints The number of points in one chunk of the file,
+ * rounded up to a whole number of memory pages.
+ * @throw std::runtime_error If the file cannot be created.
+ */
+MappedSeries::MappedSeries(const std::string& path, std::size_t chunkPoints)
+    : path_(path) {
+  std::size_t pagePoints = sysconf(_SC_PAGESIZE) / sizeof(double);
+  chunkPoints_ = (std::max<std::size_t>(chunkPoints, 1) + pagePoints - 1) /
+                 pagePoints * pagePoints;
+
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    throw error("Cannot create series file", path);
+  }
+  if (ftruncate(fd_, kHeaderSize) != 0) {
+    int code = errno;
+    close();
+    errno = code;
+    throw error("Cannot resize series file", path);
+  }
+  writeHeader();
+}
+
+/**
+ * @brief Saves the header, unmaps the file and closes it.
+ */
+MappedSeries::~MappedSeries() { close(); }
+
+/**
+ * @brief Move constructor.
+ *
+ * @param other The series to be moved from.
+ */
+MappedSeries::MappedSeries(MappedSeries&& other) noexcept {
+  *this = std::move(other);
+}
+
+/**
+ * @brief Move assignment operator.
+ *
+ * @param other The series to be moved from.
+ * @return Reference to this series.
+ */
+MappedSeries& MappedSeries::operator=(MappedSeries&& other) noexcept {
+  if (this != &other) {
+    close();
+    std::swap(path_, other.path_);
+    std::swap(fd_, other.fd_);
+    std::swap(chunkPoints_, other.chunkPoints_);
+    std::swap(size_, other.size_);
+    std::swap(chunk_, other.chunk_);
+    std::swap(chunkIndex_, other.chunkIndex_);
+    std::swap(view_, other.view_);
+    std::swap(viewSize_, other.viewSize_);
+  }
+  return *this;
+}
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Opens an existing series file for reading and appending.
+ *
+ * @param path The path of the file.
+ * @return The opened series.
+ * @throw std::runtime_error If the file is missing or damaged.
+ */
+MappedSeries MappedSeries::open(const std::string& path) {
+  // файл принадлежит ряду только после всех проверок: close() ряда
+  // переписывает заголовок и обрезает файл
+  int fd = ::open(path.c_str(), O_RDWR);
+  if (fd < 0) {
+    throw error("Cannot open series file", path);
+  }
+  std::size_t pagePoints = sysconf(_SC_PAGESIZE) / sizeof(double);
+  SeriesHeader header = {};
+  struct stat info = {};
+  if (pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      fstat(fd, &info) != 0 || header.chunkPoints == 0 ||
+      header.chunkPoints % pagePoints != 0 ||
+      std::uint64_t(info.st_size) < kHeaderSize ||
+      header.size >
+          (std::uint64_t(info.st_size) - kHeaderSize) / sizeof(double)) {
+    ::close(fd);
+    throw std::runtime_error("Invalid series file: " + path);
+  }
+  MappedSeries series;
+  series.path_ = path;
+  series.fd_ = fd;
+  series.size_ = header.size;
+  series.chunkPoints_ = header.chunkPoints;
+  return series;
+}
+
+/**
+ * @brief Appends values to the end of the series.
+ *
+ * The values are copied into the mapped chunk; a new chunk is added to the
+ * file when the current one is full, so only one chunk is mapped for writing
+ * at a time.
+ *
+ * @param values The values to be appended.
+ * @param n The number of values.
+ * @throw std::runtime_error If the file cannot be extended.
+ */
+void MappedSeries::append(const double* values, std::size_t n) {
+  while (n > 0) {
+    std::size_t chunk = size_ / chunkPoints_;
+    std::size_t offset = size_ % chunkPoints_;
+    if (chunk_ == nullptr || chunkIndex_ != chunk) {
+      mapChunk(chunk);
+    }
+    std::size_t count = std::min(n, chunkPoints_ - offset);
+    std::memcpy(chunk_ + offset, values, count * sizeof(double));
+    values += count;
+    n -= count;
+    size_ += count;
+  }
+}
+
+/**
+ * @brief Writes the header and schedules the written data for saving.
+ */
+void MappedSeries::flush() {
+  if (fd_ < 0) return;
+  writeHeader();
+  if (chunk_ != nullptr) {
+    msync(chunk_, chunkPoints_ * sizeof(double), MS_ASYNC);
+  }
+}
+
+/**
+ * @brief Returns a read-only view of the whole series without copying.
+ *
+ * The view is a single mapping of the file, so it can be passed directly
+ * to decimation or plotting. It stays valid until the next append().
+ *
+ * @return Pointer to the first value (nullptr for an empty series).
+ * @throw std::runtime_error If the file cannot be mapped.
+ */
+const double* MappedSeries::data() {
+  if (view_ != nullptr && viewSize_ == size_) {
+    return view_;
+  }
+  unmapView();
+  if (size_ == 0) {
+    return nullptr;
+  }
+  void* view = mmap(nullptr, size_ * sizeof(double), PROT_READ, MAP_SHARED,
+                    fd_, kHeaderSize);
+  if (view == MAP_FAILED) {
+    throw error("Cannot map series file", path_);
+  }
+  view_ = static_cast<const double*>(view);
+  viewSize_ = size_;
+  return view_;
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Maps a chunk of the file for writing, extending the file if needed.
+ *
+ * @param chunk The number of the chunk.
+ * @throw std::runtime_error If the file cannot be extended or mapped.
+ */
+void MappedSeries::mapChunk(std::size_t chunk) {
+  unmapChunk();
+  std::size_t chunkBytes = chunkPoints_ * sizeof(double);
+  off_t begin = kHeaderSize + chunk * chunkBytes;
+
+  struct stat info = {};
+  if (fstat(fd_, &info) != 0) {
+    throw error("Cannot extend series file", path_);
+  }
+  // место на диске выделяется сразу: запись в разреженный фрагмент
+  // на заполненном диске завершила бы процесс сигналом SIGBUS
+  if (info.st_size < off_t(begin + chunkBytes)) {
+    int code = allocate(fd_, info.st_size, begin + chunkBytes - info.st_size);
+    if (code != 0) {
+      errno = code;
+      throw error("Cannot extend series file", path_);
+    }
+  }
+  void* mapping = mmap(nullptr, chunkBytes, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd_, begin);
+  if (mapping == MAP_FAILED) {
+    throw error("Cannot map series file", path_);
+  }
+  chunk_ = static_cast<double*>(mapping);
+  chunkIndex_ = chunk;
+}
+
+/**
+ * @brief Unmaps the chunk mapped for writing.
+ */
+void MappedSeries::unmapChunk() {
+  if (chunk_ != nullptr) {
+    munmap(chunk_, chunkPoints_ * sizeof(double));
+    chunk_ = nullptr;
+  }
+}
+
+/**
+ * @brief Unmaps the read-only view of the series.
+ */
+void MappedSeries::unmapView() {
+  if (view_ != nullptr) {
+    munmap(const_cast<double*>(view_), viewSize_ * sizeof(double));
+    view_ = nullptr;
+    viewSize_ = 0;
+  }
+}
+
+/**
+ * @brief Writes the header with the current number of points.
+ */
+void MappedSeries::writeHeader() {
+  SeriesHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.size = size_;
+  header.chunkPoints = chunkPoints_;
+  if (pwrite(fd_, &header, sizeof(header), 0) != sizeof(header)) {
+    throw error("Cannot write series header", path_);
+  }
+}
+
+/**
+ * @brief Saves the header, trims the unused tail of the last chunk
+ * and closes the file.
+ */
+void MappedSeries::close() {
+  if (fd_ < 0) return;
+  unmapChunk();
+  unmapView();
+  try {
+    writeHeader();
+  } catch (const std::runtime_error&) {
+    // деструктор не должен выбрасывать исключения
+  }
+  if (ftruncate(fd_, kHeaderSize + size_ * sizeof(double)) != 0) {
+    // файл остаётся корректным и с неиспользованным хвостом
+  }
+  ::close(fd_);
+  fd_ = -1;
+}
+
+/**
+ * @brief Builds an exception with the description of the last system error.
+ *
+ * @param what The description of the operation.
+ * @param path The path of the file.
+ * @return The exception to be thrown.
+ */
+std::runtime_error MappedSeries::error(const std::string& what,
+                                       const std::string& path) {
+  return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+}
+
+}  // namespace s21
@@ -0,0 +1,84 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file mapped_series.h
+ *
+ * @brief Declaration of the MappedSeries class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the MappedSeries class,
+ * which is part of the SmartCalc v2.0 library.
+ * The MappedSeries class stores a series of evaluated values in a
+ * memory-mapped file that grows in fixed-size chunks, so the size of the
+ * series is limited by disk space rather than by RAM.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_MAPPED_SERIES_H
+#define CPP3_S21_SMART_CALC_MAPPED_SERIES_H
+
+#include <cstddef>    // size_t
+#include <cstdint>    // SeriesHeader
+#include <stdexcept>  // std::runtime_error
+#include <string>     // path_
+
+namespace s21 {
+
+class MappedSeries {
+ public:
+  // размер заголовка файла (кратен размеру страницы до 64 КБ,
+  // чтобы фрагменты данных можно было отображать в память)
+  static constexpr std::size_t kHeaderSize = 65536;
+  // количество точек в одном фрагменте файла по умолчанию (8 МБ)
+  static constexpr std::size_t kChunkPoints = std::size_t(1) << 20;
+
+  MappedSeries() = default;
+  explicit MappedSeries(const std::string& path,
+                        std::size_t chunkPoints = kChunkPoints);
+  ~MappedSeries();
+
+  MappedSeries(const MappedSeries&) = delete;
+  MappedSeries& operator=(const MappedSeries&) = delete;
+  MappedSeries(MappedSeries&& other) noexcept;
+  MappedSeries& operator=(MappedSeries&& other) noexcept;
+
+  // Main methods:
+  static MappedSeries open(const std::string& path);
+  void append(const double* values, std::size_t n);
+  void flush();
+  const double* data();
+
+  // Accessors:
+  std::size_t size() const { return size_; }
+  std::size_t chunkPoints() const { return chunkPoints_; }
+  const std::string& path() const { return path_; }
+
+ private:
+  // Auxiliary methods:
+  void mapChunk(std::size_t chunk);
+  void unmapChunk();
+  void unmapView();
+  void writeHeader();
+  void close();
+  static std::runtime_error error(const std::string& what,
+                                  const std::string& path);
+
+  std::string path_;
+  int fd_ = -1;
+  std::size_t chunkPoints_ = kChunkPoints;
+  std::size_t size_ = 0;
+
+  double* chunk_ = nullptr;       // отображение текущего фрагмента для записи
+  std::size_t chunkIndex_ = 0;    // номер текущего фрагмента
+  const double* view_ = nullptr;  // отображение всех данных для чтения
+  std::size_t viewSize_ = 0;      // количество точек в отображении для чтения
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_MAPPED_SERIES_H
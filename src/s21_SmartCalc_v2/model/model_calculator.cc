@@ -20,6 +20,8 @@
 
 #include "model_calculator.h"
 
+#include <algorithm>  // std::min, std::copy
+#include <cstdio>     // removeGrafFiles
 #include <iostream>
 
 #include "polish_notation.h"
@@ -38,15 +40,16 @@ namespace s21 {
  * @return The result of the evaluated expression.
  * @throw std::invalid_argument If the expression is invalid.
  */
-double ModelCalculator::calculate(const String &expression, const double &x) {
+double ModelCalculator::calculate(const String &expression,
+                                  const double &x) const {
   String rpn = ReversePolishNotation::toRPN(expression);
-  answer_ = evaluateRPN(rpn, x);
-  return answer_;
+  return evaluateRPN(rpn, x);
 }
 
 Vector ModelCalculator::calculateGraf(std::pair<double, double> xRange,
                                       std::pair<double, double> yRange,
-                                      unsigned pAmount, std::string infix) {
+                                      unsigned pAmount,
+                                      std::string infix) const {
   std::vector<std::vector<double>> vXYOutPut(2, std::vector<double>());
   double vXStep = (xRange.second - xRange.first) / pAmount;
   double vX = xRange.first;
@@ -77,10 +80,282 @@ Vector ModelCalculator::calculateGraf(std::pair<double, double> xRange,
   return vXYOutPut;
 }
 
+/**
+ * @brief Calculates several graphs over a shared grid of x values.
+ *
+ * All expressions are compiled into one fused program, so the grid is
+ * generated once and common subexpressions are evaluated once per point.
+ * The program is translated to machine code by JitProgram where possible.
+ * In single precision the program is evaluated in float by the block
+ * interpreter, which processes twice as many points per vector instruction;
+ * ExpressionProgram::checkAccuracy() tells whether this is visible.
+ * Points that are out of the range of values or cannot be calculated
+ * are returned as NaN, which keeps all columns aligned with the x row.
+ *
+ * @param xRange The domain of the graphs.
+ * @param yRange The range of values of the graphs.
+ * @param pAmount The number of points in the grid.
+ * @param infixes The expressions to be plotted.
+ * @param precision The precision of evaluation.
+ * @return Row 0 holds the x values, row i + 1 holds the values of the i-th
+ * expression.
+ * @throw std::invalid_argument If the ranges or expressions are invalid.
+ */
+Vector ModelCalculator::calculateGrafs(std::pair<double, double> xRange,
+                                       std::pair<double, double> yRange,
+                                       unsigned pAmount,
+                                       const StringVector &infixes,
+                                       Precision precision) const {
+  ExpressionProgram program = ExpressionProgram::compile(infixes);
+  if (precision == Precision::Single) {
+    return tabulate(
+        xRange, yRange, pAmount, program.outputCount(),
+        [&program](const double *x, std::size_t n, double *const *columns) {
+          const std::size_t block = ExpressionProgram::kBlockSize;
+          std::vector<float> scratch, xs(block),
+              values(program.outputCount() * block);
+          std::vector<float *> single(program.outputCount());
+          for (std::size_t j = 0; j < single.size(); ++j) {
+            single[j] = values.data() + j * block;
+          }
+          for (std::size_t start = 0; start < n; start += block) {
+            std::size_t count = std::min(block, n - start);
+            std::copy(x + start, x + start + count, xs.begin());
+            program.evaluateBlock(xs.data(), count, single.data(), scratch);
+            for (std::size_t j = 0; j < single.size(); ++j) {
+              std::copy(single[j], single[j] + count, columns[j] + start);
+            }
+          }
+        });
+  }
+  std::shared_ptr<JitProgram> jit = JitProgram::compile(program);
+  return tabulate(xRange, yRange, pAmount, jit->outputCount(),
+                  [&jit](const double *x, std::size_t n,
+                         double *const *columns) {
+                    jit->evaluate(x, n, columns);
+                  });
+}
+
+/**
+ * @brief Calculates the graphs of a cached expression over a shared grid
+ * of x values.
+ *
+ * The expression counts the evaluated points and moves to a faster tier
+ * as it is plotted again and again.
+ *
+ * @param xRange The domain of the graphs.
+ * @param yRange The range of values of the graphs.
+ * @param pAmount The number of points in the grid.
+ * @param expression The compiled expression.
+ * @return Row 0 holds the x values, row i + 1 holds the values of the i-th
+ * output.
+ * @throw std::invalid_argument If the ranges are invalid.
+ */
+Vector ModelCalculator::calculateGrafs(std::pair<double, double> xRange,
+                                       std::pair<double, double> yRange,
+                                       unsigned pAmount,
+                                       TieredExpression &expression) const {
+  return tabulate(xRange, yRange, pAmount, expression.outputCount(),
+                  [&expression](const double *x, std::size_t n,
+                                double *const *columns) {
+                    expression.evaluate(x, n, columns);
+                  });
+}
+
+/**
+ * @brief Calculates the graph of an expression through its Chebyshev proxy.
+ *
+ * Inside the domain of the proxy only the polynomial pieces are evaluated;
+ * outside it the expression itself is used.
+ *
+ * @param xRange The domain of the graph.
+ * @param yRange The range of values of the graph.
+ * @param pAmount The number of points in the grid.
+ * @param proxy The fitted approximation of the expression.
+ * @return Rows x and y of the graph.
+ * @throw std::invalid_argument If the ranges are invalid.
+ */
+Vector ModelCalculator::calculateGrafs(std::pair<double, double> xRange,
+                                       std::pair<double, double> yRange,
+                                       unsigned pAmount,
+                                       const ChebyshevProxy &proxy) const {
+  return tabulate(xRange, yRange, pAmount, 1,
+                  [&proxy](const double *x, std::size_t n,
+                           double *const *columns) {
+                    proxy.evaluate(x, n, columns[0]);
+                  });
+}
+
+/**
+ * @brief Calculates several graphs over a shared grid of x values and
+ * streams the samples into memory-mapped files.
+ *
+ * Only one block of samples is kept in RAM, so the number of points is
+ * limited by disk space. The files are named pathPrefix + ".x.bin" and
+ * pathPrefix + ".<i>.bin" for the i-th expression. Points that cannot be
+ * calculated are stored as NaN. Once the series are written, the level of
+ * detail pyramid of every series of values is built over the mapped data
+ * and saved next to it as pathPrefix + ".<i>.lod", so the graphs can be
+ * drawn at any zoom without reading all the points and reopened later by
+ * openGrafFiles.
+ *
+ * @param xRange The domain of the graphs.
+ * @param pAmount The number of points in the grid.
+ * @param infixes The expressions to be calculated.
+ * @param pathPrefix The common prefix of the file paths.
+ * @return The x series followed by one series per expression and the
+ * pyramids of the series of values.
+ * @throw std::invalid_argument If the range or expressions are invalid.
+ * @throw std::runtime_error If the files cannot be written.
+ */
+MappedGraf ModelCalculator::calculateGrafToFiles(
+    std::pair<double, double> xRange, std::size_t pAmount,
+    const StringVector &infixes, const String &pathPrefix) const {
+  if (xRange.second < xRange.first) {
+    throw std::invalid_argument(
+        "Не коректно введены граници отображения графика");
+  }
+  ExpressionProgram program = ExpressionProgram::compile(infixes);
+
+  MappedGraf graf;
+  std::vector<MappedSeries> &series = graf.series;
+  series.emplace_back(pathPrefix + ".x.bin");
+  for (size_t i = 0; i < infixes.size(); ++i) {
+    series.emplace_back(pathPrefix + "." + std::to_string(i) + ".bin");
+  }
+
+  // каждый вычисленный блок сразу дописываем в файлы
+  program.evaluateGrid(xRange, pAmount,
+                       [&series](const double *x, std::size_t n,
+                                 const double *const *columns) {
+                         series[0].append(x, n);
+                         for (size_t j = 1; j < series.size(); ++j) {
+                           series[j].append(columns[j - 1], n);
+                         }
+                       });
+  for (auto &column : series) {
+    column.flush();
+  }
+
+  // пирамиды строятся по отображённым данным и сохраняются рядом с ними
+  graf.pyramids.resize(infixes.size());
+  for (size_t i = 0; i < infixes.size(); ++i) {
+    graf.pyramids[i].build(series[i + 1].data(), series[i + 1].size());
+    graf.pyramids[i].save(pathPrefix + "." + std::to_string(i) + ".lod");
+  }
+  return graf;
+}
+
+/**
+ * @brief Opens the graphs written by calculateGrafToFiles.
+ *
+ * @param pathPrefix The common prefix of the file paths.
+ * @param outputs The number of expressions.
+ * @return The mapped series and their saved pyramids.
+ * @throw std::runtime_error If a file is missing, damaged or does not
+ * match the others.
+ */
+MappedGraf ModelCalculator::openGrafFiles(const String &pathPrefix,
+                                          std::size_t outputs) {
+  MappedGraf graf;
+  graf.series.push_back(MappedSeries::open(pathPrefix + ".x.bin"));
+  graf.pyramids.resize(outputs);
+  for (size_t i = 0; i < outputs; ++i) {
+    String path = pathPrefix + "." + std::to_string(i);
+    graf.series.push_back(MappedSeries::open(path + ".bin"));
+    if (graf.series.back().size() != graf.series[0].size()) {
+      throw std::runtime_error("Graph series differ in length: " + path +
+                               ".bin");
+    }
+    graf.pyramids[i].load(path + ".lod", graf.series.back().size());
+  }
+  return graf;
+}
+
+/**
+ * @brief Removes the files written by calculateGrafToFiles.
+ *
+ * Missing files are skipped.
+ *
+ * @param pathPrefix The common prefix of the file paths.
+ * @param outputs The number of expressions.
+ */
+void ModelCalculator::removeGrafFiles(const String &pathPrefix,
+                                      std::size_t outputs) {
+  std::remove((pathPrefix + ".x.bin").c_str());
+  for (size_t i = 0; i < outputs; ++i) {
+    String path = pathPrefix + "." + std::to_string(i);
+    std::remove((path + ".bin").c_str());
+    std::remove((path + ".lod").c_str());
+  }
+}
+
 /******************************************************************************
  * AUXILIARY PRIVATE MAIN METHODS
  ******************************************************************************/
 
+/**
+ * @brief Tabulates the outputs of an expression over a uniform grid of x
+ * and hides the points that are out of the range of values.
+ *
+ * Grids larger than kParallelGrain points are split into parts evaluated
+ * by the workers of TaskScheduler, so evaluate must be thread-safe.
+ *
+ * @param xRange The domain of the graphs.
+ * @param yRange The range of values of the graphs.
+ * @param pAmount The number of points in the grid.
+ * @param outputs The number of outputs of the expression.
+ * @param evaluate The function evaluating all outputs for given x values.
+ * @return Row 0 holds the x values, rows 1..outputs hold the values.
+ * @throw std::invalid_argument If the ranges are invalid or no point is
+ * in the range of values.
+ */
+Vector ModelCalculator::tabulate(
+    std::pair<double, double> xRange, std::pair<double, double> yRange,
+    unsigned pAmount, std::size_t outputs,
+    const std::function<void(const double *, std::size_t, double *const *)>
+        &evaluate) {
+  if ((xRange.second < xRange.first) || (yRange.second < yRange.first)) {
+    throw std::invalid_argument(
+        "Не коректно введены граници отображения графика");
+  }
+  Vector table(outputs + 1, std::vector<double>(pAmount));
+  std::vector<double *> columns(outputs);
+  double step = (xRange.second - xRange.first) / pAmount;
+  for (unsigned i = 0; i < pAmount; ++i) {
+    table[0][i] = xRange.first + i * step;
+  }
+  for (size_t j = 0; j < columns.size(); ++j) {
+    columns[j] = table[j + 1].data();
+  }
+  // части сетки вычисляются параллельно в общем пуле потоков
+  TaskScheduler::instance().parallelFor(
+      0, pAmount, kParallelGrain,
+      [&table, &columns, &evaluate](std::size_t begin, std::size_t end) {
+        std::vector<double *> part(columns.size());
+        for (size_t j = 0; j < part.size(); ++j) {
+          part[j] = columns[j] + begin;
+        }
+        evaluate(table[0].data() + begin, end - begin, part.data());
+      });
+
+  bool anyInRange = false;
+  for (size_t row = 1; row < table.size(); ++row) {
+    for (double &vY : table[row]) {
+      if (vY >= yRange.first && vY <= yRange.second) {
+        anyInRange = true;
+      } else {
+        vY = NAN;
+      }
+    }
+  }
+  if (!anyInRange) {
+    throw std::invalid_argument(
+        "ни одна из точек не находится в заданной области значений");
+  }
+  return table;
+}
+
 /**
  * @brief Evaluates an expression in Reverse Polish Notation (RPN).
  *
@@ -215,7 +490,7 @@ double ModelCalculator::applyBinaryOperator(const char b_op, double a,
       }
       return a / b;
     case '^':
-      return std::pow(a, b);
+      return ExpressionProgram::power(a, b);
     case '%':
       if (b == 0.0) {
         throw std::invalid_argument("Division by zero");
@@ -11,6 +11,13 @@
  * The ModelCalculator class is responsible for evaluating mathematical
  * expressions using Reverse Polish Notation (RPN).
  *
+ * Thread safety: ModelCalculator has no state, so one instance may be used
+ * by any number of threads at once. Compiled programs (ExpressionProgram,
+ * JitProgram, RegisterProgram, NativeProgram, ChebyshevProxy) are immutable
+ * after construction and their const methods may also be called
+ * concurrently; scratch memory is owned by the call or passed by the
+ * caller. TieredExpression is synchronized internally.
+ *
  * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
  *
  * @date 2024-08-11
@@ -22,6 +29,7 @@
 #define CPP3_S21_SMART_CALC_MODEL_CALCULATOR_H
 
 #include <cmath>  // applyBinaryOperator, applyUnaryOperator
+#include <functional>  // tabulate
 #include <iostream>
 #include <set>        // isBinaryOperator, isUnaryOperator
 #include <sstream>    // evaluateRPN
@@ -29,7 +37,14 @@
 #include <stdexcept>  // evaluateRPN, applyBinaryOperator, applyUnaryOperator
 #include <vector>
 
+#include "chebyshev_proxy.h"
+#include "expression_program.h"
+#include "jit_program.h"
+#include "tiered_expression.h"
+#include "lod_pyramid.h"
+#include "mapped_series.h"
 #include "polish_notation.h"
+#include "task_scheduler.h"
 
 namespace s21 {
 
@@ -43,30 +58,61 @@ enum TokenType {
 using String = std::string;
 using Vector = std::vector<std::vector<double>>;
 
+// графики в файлах: ряды точек и пирамиды детализации рядов значений
+struct MappedGraf {
+  std::vector<MappedSeries> series;  // x, затем значения каждого выражения
+  std::vector<LodPyramid> pyramids;  // пирамида каждого ряда значений
+};
+
 class ModelCalculator {
  public:
-  ModelCalculator() : answer_(0) {};
+  // наименьшая часть сетки графика, вычисляемая отдельной задачей
+  static constexpr std::size_t kParallelGrain =
+      16 * ExpressionProgram::kBlockSize;
+
+  ModelCalculator() = default;
 
   // Main methods:
-  double calculate(const String& expression, const double& x);
+  double calculate(const String& expression, const double& x) const;
   Vector calculateGraf(std::pair<double, double> xRange,
                        std::pair<double, double> yRange, unsigned pAmount,
-                       std::string infix);
+                       std::string infix) const;
+  Vector calculateGrafs(std::pair<double, double> xRange,
+                        std::pair<double, double> yRange, unsigned pAmount,
+                        const StringVector& infixes,
+                        Precision precision = Precision::Double) const;
+  Vector calculateGrafs(std::pair<double, double> xRange,
+                        std::pair<double, double> yRange, unsigned pAmount,
+                        TieredExpression& expression) const;
+  Vector calculateGrafs(std::pair<double, double> xRange,
+                        std::pair<double, double> yRange, unsigned pAmount,
+                        const ChebyshevProxy& proxy) const;
+  MappedGraf calculateGrafToFiles(std::pair<double, double> xRange,
+                                  std::size_t pAmount,
+                                  const StringVector& infixes,
+                                  const String& pathPrefix) const;
+  static MappedGraf openGrafFiles(const String& pathPrefix,
+                                  std::size_t outputs);
+  static void removeGrafFiles(const String& pathPrefix, std::size_t outputs);
 
  private:
   // Auxiliary methods:
-  double evaluateRPN(const String& rpn, const double& x);
-
-  TokenType tokenType(const String& token);
-
-  bool isOperand(const String& token);
-  bool isBinaryOperator(const char b_op);
-  bool isUnaryOperator(const char u_op);
-
-  double applyUnaryOperator(const char fn, double operand);
-  double applyBinaryOperator(const char op, double operand_1, double operand_2);
-
-  double answer_;
+  static double evaluateRPN(const String& rpn, const double& x);
+  static Vector tabulate(
+      std::pair<double, double> xRange, std::pair<double, double> yRange,
+      unsigned pAmount, std::size_t outputs,
+      const std::function<void(const double*, std::size_t, double* const*)>&
+          evaluate);
+
+  static TokenType tokenType(const String& token);
+
+  static bool isOperand(const String& token);
+  static bool isBinaryOperator(const char b_op);
+  static bool isUnaryOperator(const char u_op);
+
+  static double applyUnaryOperator(const char fn, double operand);
+  static double applyBinaryOperator(const char op, double operand_1,
+                                    double operand_2);
 };
 
 }  // namespace s21
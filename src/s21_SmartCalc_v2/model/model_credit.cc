@@ -15,8 +15,168 @@
 
 #include "model_credit.h"
 
+#include <algorithm>  // std::min, std::max, std::lower_bound, std::stable_sort
+#include <cstring>    // std::memcpy
+#include <limits>     // std::numeric_limits
+
+#include "task_scheduler.h"
+
 namespace s21 {
 
+namespace {
+
+// 1.5 * 2^52: после прибавления дробная часть округлена (|x| < 2^51)
+const double kRoundShift = 6755399441055744.0;
+const double kTwo52 = 4503599627370496.0;
+const double kLog2e = 1.44269504088896340736;
+// ln 2 = kLn2Hi + kLn2Lo, произведение kLn2Hi на целое точное
+const double kLn2Hi = 6.93147180369123816490e-01;
+const double kLn2Lo = 1.90821492927058770002e-10;
+// показатель степени, за которым expKernel не вычисляется
+const double kExpLimit = 1400;
+
+// Ядра пакетного расчёта не содержат ветвлений и сравнений чисел double:
+// такие сравнения могут вызвать исключение FPU, и компилятор не заменяет
+// их выбором без перехода, а значит не векторизует цикл.
+
+inline std::uint64_t toBits(double x) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+inline double fromBits(std::uint64_t bits) {
+  double x;
+  std::memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+// целое неотрицательное число меньше 2^52 в double
+inline double toDouble(std::uint64_t n) {
+  return fromBits(n | toBits(kTwo52)) - kTwo52;
+}
+
+// 2^k для целого k из [-1022, 1023]
+inline double powerOfTwo(double k) {
+  return fromBits((toBits(k + 1023 + kRoundShift) & 0x7FF) << 52);
+}
+
+// округление до целого, половина от нуля (0 <= y < 2^51)
+inline double roundKernel(double y) {
+  double t = (y + kRoundShift) - kRoundShift;
+  // y - t точно; d == 0, если половина округлена к чётному вниз,
+  // и только тогда старший бит (d - 1) & ~d равен 1
+  std::uint64_t d = toBits(y - t) ^ toBits(0.5);
+  return t + toDouble(((d - 1) & ~d) >> 63);
+}
+
+// ln x для положительного нормального x
+inline double logKernel(double x) {
+  // сдвиг переносит мантиссы из [sqrt(2)/2, sqrt(2)) к одному показателю
+  std::uint64_t bits = toBits(x) + 0x00095F619980C433ull;
+  double e = toDouble(bits >> 52) - 1023;
+  double m = fromBits((bits & 0x000FFFFFFFFFFFFFull) + 0x3FE6A09E667F3BCDull);
+  // ln m = 2 atanh(s), |s| < 0.172: ряд по s^2 до 10-й степени
+  double s = (m - 1) / (m + 1), z = s * s;
+  double p = 1.0 / 21;
+  p = p * z + 1.0 / 19;
+  p = p * z + 1.0 / 17;
+  p = p * z + 1.0 / 15;
+  p = p * z + 1.0 / 13;
+  p = p * z + 1.0 / 11;
+  p = p * z + 1.0 / 9;
+  p = p * z + 1.0 / 7;
+  p = p * z + 1.0 / 5;
+  p = p * z + 1.0 / 3;
+  return e * kLn2Hi + (2 * s + (2 * s * z * p + e * kLn2Lo));
+}
+
+// e^x для |x| <= kExpLimit
+inline double expKernel(double x) {
+  double k = (x * kLog2e + kRoundShift) - kRoundShift;
+  double r = (x - k * kLn2Hi) - k * kLn2Lo;
+  // |r| <= ln(2) / 2: ряд Тейлора до 13-й степени
+  double p = 1.0 / 6227020800;
+  p = p * r + 1.0 / 479001600;
+  p = p * r + 1.0 / 39916800;
+  p = p * r + 1.0 / 3628800;
+  p = p * r + 1.0 / 362880;
+  p = p * r + 1.0 / 40320;
+  p = p * r + 1.0 / 5040;
+  p = p * r + 1.0 / 720;
+  p = p * r + 1.0 / 120;
+  p = p * r + 1.0 / 24;
+  p = p * r + 1.0 / 6;
+  p = p * r + 0.5;
+  p = p * r + 1;
+  p = p * r + 1;
+  // 2^k двумя множителями: каждый остаётся нормальным числом
+  double half = (k * 0.5 + kRoundShift) - kRoundShift;
+  return p * powerOfTwo(half) * powerOfTwo(k - half);
+}
+
+}  // namespace
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTOR
+ ******************************************************************************/
+
+/**
+ * @brief Creates a schedule of payments; no row is calculated yet.
+ *
+ * @param type The type of monthly payment calculation
+ * (ANNUITY or DIFFERENTIAL).
+ * @param in The input data for the calculation.
+ * @param start The date of the first payment.
+ * @throw std::invalid_argument If the term is not positive.
+ */
+PaymentSchedule::PaymentSchedule(TypeOfMonthlyPayments type, CrInput in,
+                                 CrDate start)
+    : type_(type), in_(in), start_(start), term_(in.term) {
+  if (in.term < 1) {
+    throw std::invalid_argument("Term of the credit must be positive");
+  }
+  const_rate_ = in.rate / 12 / 100;
+  const_payment_ = in.credit / in.term;
+  if (type == ANNUITY) {
+    // платёж постоянный и в последний месяц, как в calculateAnnuity
+    double pay = CreditModel::calculateAnnuityPayment(in);
+    segments_.push_back({1, in.term, in.credit, pay, pay, 0});
+  }
+}
+
+/**
+ * @brief Creates the schedule of an annuity with early repayments.
+ *
+ * @param plan The plan made by CreditModel::planAnnuity.
+ * @param in The input data the plan was made for.
+ * @param start The date of the first payment.
+ */
+PaymentSchedule::PaymentSchedule(const AnnuityPlan &plan, CrInput in,
+                                 CrDate start)
+    : type_(ANNUITY),
+      in_(in),
+      start_(start),
+      term_(plan.term),
+      const_rate_(in.rate / 12 / 100),
+      const_payment_(0),
+      segments_(plan.segments) {}
+
+/**
+ * @brief Creates an iterator positioned at a row of the schedule.
+ *
+ * @param schedule The schedule.
+ * @param index The number of the row (term for the end).
+ */
+PaymentSchedule::iterator::iterator(const PaymentSchedule* schedule,
+                                    int index)
+    : schedule_(schedule), index_(index), remainder_(schedule->in_.credit) {
+  if (index_ < schedule_->term_) {
+    row_.date = schedule_->start_;
+    fill();
+  }
+}
+
 /******************************************************************************
  * MAIN METHODS
  ******************************************************************************/
@@ -28,24 +188,978 @@ namespace s21 {
  * (ANNUITY or DIFFERENTIAL).
  * @param in The input data for the calculation.
  * @param monthly_pay The calculated monthly payment
- * (used for annuity calculation).
+ * (the first one for differential calculation).
  * @param out The output data containing the total and overpayment.
- * @param payments The vector of payments (used for differential calculation).
+ * @param payments The vector of payments.
  */
 void CreditModel::calculateCredit(TypeOfMonthlyPayments type, CrInput in,
                                   double &monthly_pay, CrOutput &out,
                                   PaymentVector &payments) {
   if (type == ANNUITY) {
     calculateAnnuity(in, monthly_pay, out);
+    payments.clear();
+    for (const ScheduleRow &row : schedule(ANNUITY, in)) {
+      payments.push_back(toPayment(row));
+    }
   } else if (type == DIFFERENTIAL) {
     payments = calculateDifferential(in, monthly_pay, out);
   }
 }
 
+/**
+ * @brief Calculate the monthly payments into a schedule stored by columns.
+ *
+ * The dates are stored as day numbers and formatted only when displayed.
+ *
+ * @param type The type of monthly payment calculation
+ * (ANNUITY or DIFFERENTIAL).
+ * @param in The input data for the calculation.
+ * @param monthly_pay The calculated monthly payment (the first one for
+ * differential calculation).
+ * @param out The output data containing the total and overpayment.
+ * @param payments The columns of payments.
+ * @throw std::invalid_argument If the term is not positive.
+ */
+void CreditModel::calculateCredit(TypeOfMonthlyPayments type, CrInput in,
+                                  double &monthly_pay, CrOutput &out,
+                                  PaymentColumns &payments) {
+  if (type == ANNUITY) {
+    calculateAnnuity(in, monthly_pay, out);
+    fillColumns(schedule(ANNUITY, in), payments);
+    return;
+  }
+  fillColumns(schedule(DIFFERENTIAL, in), payments);
+  monthly_pay = payments.monthly_pay.front();
+  out.total = sumColumn(payments.monthly_pay.data(), payments.size());
+  out.overpayment = out.total - in.credit;
+}
+
+/**
+ * @brief Calculate an annuity with early repayments into a schedule
+ * stored by columns.
+ *
+ * @param in The input data for the calculation.
+ * @param events The early repayments.
+ * @param monthly_pay The first monthly payment.
+ * @param out The output data containing the total and overpayment,
+ * early repayments included.
+ * @param payments The columns of payments; a row with an early repayment
+ * includes it in the monthly and principal payments.
+ * @throw std::invalid_argument If the term or an early repayment is
+ * invalid.
+ */
+void CreditModel::calculateCredit(CrInput in, const RepaymentVector &events,
+                                  double &monthly_pay, CrOutput &out,
+                                  PaymentColumns &payments) {
+  AnnuityPlan plan = planAnnuity(in, events);
+  fillColumns(schedule(plan, in), payments);
+  monthly_pay = plan.segments.front().payment;
+  out.total = plan.total;
+  out.overpayment = plan.overpayment;
+}
+
+/**
+ * @brief Calculate the schedule of payments in a money type.
+ *
+ * With Money every amount is a whole number of kopecks: the credit, the
+ * annuity payment, the principal part of a differential payment (the
+ * remaining debt divided by the months left) and the interest of every
+ * month are rounded in the given mode, no payment takes more than the
+ * remaining debt and the last payment closes it, so the payments sum up to
+ * the total and the principal parts to the credit exactly. With double only the annuity payment is
+ * rounded, as in calculateCredit, and the rest is kept as is.
+ *
+ * @tparam Amount double or Money.
+ * @param type The type of monthly payment calculation
+ * (ANNUITY or DIFFERENTIAL).
+ * @param in The input data for the calculation.
+ * @param ledger The columns of payments and the totals.
+ * @param rounding The rounding mode of the amounts.
+ * @throw std::invalid_argument If the term is not positive.
+ */
+template <typename Amount>
+void CreditModel::calculateLedger(TypeOfMonthlyPayments type, CrInput in,
+                                  CreditLedger<Amount> &ledger,
+                                  Rounding rounding) {
+  using Traits = MoneyTraits<Amount>;
+  if (in.term < 1) {
+    throw std::invalid_argument("Term of the credit must be positive");
+  }
+  const Amount credit = Traits::convert(in.credit, rounding);
+  // ставка в месяц в том же виде, что и в расчёте каждого типа
+  const double const_rate =
+      type == ANNUITY ? in.rate / 1200 : in.rate / 12 / 100;
+  Amount payment{};
+  if (type == ANNUITY) {
+    payment = Traits::round(
+        const_rate == 0
+            ? in.credit / in.term
+            : in.credit * const_rate / (1 - pow(1 + const_rate, -in.term)),
+        rounding);
+  }
+
+  ledger.monthly_pay.clear();
+  ledger.interest_pay.clear();
+  ledger.const_payment.clear();
+  ledger.total_reminder.clear();
+  ledger.monthly_pay.reserve(in.term);
+  ledger.interest_pay.reserve(in.term);
+  ledger.const_payment.reserve(in.term);
+  ledger.total_reminder.reserve(in.term);
+  Amount debt = credit, total{};
+  for (int month = 1; month <= in.term; ++month) {
+    Amount interest = Traits::scale(debt, const_rate, rounding);
+    // дифференцированный платёж делит остаток на оставшиеся месяцы:
+    // округлённая вверх доля всей суммы увела бы остаток ниже нуля
+    Amount principal =
+        type == ANNUITY ? payment - interest
+                        : Traits::divide(debt, in.term - month + 1, rounding);
+    // последний платёж закрывает долг, и долг не становится отрицательным
+    if (month == in.term || debt < principal) principal = debt;
+    debt = debt - principal;
+    ledger.monthly_pay.push_back(principal + interest);
+    ledger.interest_pay.push_back(interest);
+    ledger.const_payment.push_back(principal);
+    ledger.total_reminder.push_back(debt);
+    total += principal + interest;
+  }
+  ledger.total = total;
+  ledger.overpayment = total - credit;
+}
+
+/**
+ * @brief Calculate the totals and the first and last payments without
+ * building the schedule of payments.
+ *
+ * The cost does not depend on the term, so this is the method to be used
+ * when the rows of the schedule are not displayed.
+ *
+ * @param type The type of monthly payment calculation
+ * (ANNUITY or DIFFERENTIAL).
+ * @param in The input data for the calculation.
+ * @return The total payment, the overpayment and the first and last
+ * payments.
+ * @throw std::invalid_argument If the term is not positive.
+ */
+CrSummary CreditModel::summarizeCredit(TypeOfMonthlyPayments type,
+                                       CrInput in) {
+  if (in.term < 1) {
+    throw std::invalid_argument("Term of the credit must be positive");
+  }
+  if (type == DIFFERENTIAL) {
+    return summarizeDifferential(in);
+  }
+  double monthly_pay = 0;
+  CrOutput out = {0, 0};
+  calculateAnnuity(in, monthly_pay, out);
+  return {out.total, out.overpayment, monthly_pay, monthly_pay};
+}
+
+/**
+ * @brief Plan an annuity with early repayments.
+ *
+ * The plan is recalculated only at the early repayments: the debt at the
+ * next event is found by the closed formula of the annuity, then either
+ * the payment is recalculated for the remaining term or the term is
+ * recalculated for the same payment. The cost depends on the number of
+ * events, not on the term. The last payment of the credit closes the
+ * debt exactly.
+ *
+ * @param in The input data for the calculation.
+ * @param events The early repayments in any order; the ones with the last
+ * payment of the credit or after it are ignored.
+ * @return The segments of the annuity between the events and the totals.
+ * @throw std::invalid_argument If the term is not positive or an early
+ * repayment is before the first payment or has a non-positive amount.
+ */
+AnnuityPlan CreditModel::planAnnuity(CrInput in,
+                                     const RepaymentVector &events) {
+  if (in.term < 1) {
+    throw std::invalid_argument("Term of the credit must be positive");
+  }
+  RepaymentVector sorted = events;
+  for (const EarlyRepayment &event : sorted) {
+    if (event.month < 1 || !(event.amount > 0)) {
+      throw std::invalid_argument("Invalid early repayment");
+    }
+  }
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const EarlyRepayment &a, const EarlyRepayment &b) {
+                     return a.month < b.month;
+                   });
+
+  const double const_rate = in.rate / 12 / 100;
+  AnnuityPlan plan = {{}, 0, 0, 0};
+  double debt = in.credit;
+  int months = in.term; // оставшиеся платежи
+  double payment = calculateAnnuityPayment(in);
+  for (const EarlyRepayment &event : sorted) {
+    int passed = event.month - plan.term;
+    if (passed >= months) break;
+    if (passed == 0) {
+      // второе погашение в тот же месяц добавляется к первому
+      AnnuitySegment &last = plan.segments.back();
+      double prepayment = std::min(event.amount, debt);
+      last.prepayment += prepayment;
+      debt -= prepayment;
+    } else {
+      double before = calculateDebtAfter(debt, payment, const_rate, passed);
+      double prepayment = std::min(event.amount, before);
+      plan.segments.push_back(
+          {plan.term + 1, passed, debt, payment, payment, prepayment});
+      debt = before - prepayment;
+      plan.term += passed;
+      months -= passed;
+    }
+    // долг меньше копейки считается погашенным
+    if (debt < 0.005 || months == 0) {
+      plan.segments.back().prepayment += debt;
+      debt = 0;
+      break;
+    }
+    if (event.mode == RepaymentMode::ReducePayment) {
+      payment = calculateAnnuityPayment({debt, months, in.rate});
+    } else {
+      months = calculateTermFor(debt, payment, const_rate);
+    }
+  }
+  if (debt > 0) {
+    double before = calculateDebtAfter(debt, payment, const_rate, months - 1);
+    plan.segments.push_back({plan.term + 1, months, debt, payment,
+                             before * (1 + const_rate), 0});
+    plan.term += months;
+  }
+
+  plan.total = 0;
+  for (const AnnuitySegment &segment : plan.segments) {
+    plan.total += segment.payment * (segment.months - 1) +
+                  segment.last_payment + segment.prepayment;
+  }
+  plan.overpayment = plan.total - in.credit;
+  return plan;
+}
+
+/**
+ * @brief Price a portfolio of credits stored by columns.
+ *
+ * The portfolio is split into parts priced by the workers of
+ * TaskScheduler. Every part is processed in blocks of kBatchBlock credits
+ * by loops of constant length without calls and branches, which the
+ * compiler turns into SIMD code; (1 + r)^-n is computed as exp(-n ln(1+r))
+ * by inline polynomial kernels. The results are not bit-identical to
+ * calculateCredit and summarizeCredit, which use std::pow: the unrounded
+ * values may differ in the last bits, so a value that falls on the border
+ * of a kopeck may be rounded the other way. A payment then differs by one
+ * kopeck and the total by at most one kopeck per month of the term.
+ *
+ * @param in The credits.
+ * @param out The payments (the first one for differential credits) and
+ * the totals; NaN for credits with a non-positive term.
+ * @throw std::invalid_argument If the columns of the portfolio differ in
+ * length.
+ */
+void CreditModel::priceBatch(const CreditPortfolio &in, PortfolioQuotes &out) {
+  const std::size_t n = in.credit.size();
+  if (in.term.size() != n || in.rate.size() != n || in.type.size() != n) {
+    throw std::invalid_argument("Columns of the portfolio differ in length");
+  }
+  out.monthly_pay.resize(n);
+  out.total.resize(n);
+  out.overpayment.resize(n);
+  TaskScheduler::instance().parallelFor(
+      0, n, kBatchGrain, [&in, &out](std::size_t begin, std::size_t end) {
+        for (std::size_t start = begin; start < end; start += kBatchBlock) {
+          priceBlock(in, out, start, std::min(kBatchBlock, end - start));
+        }
+      });
+}
+
+/**
+ * @brief Price every credit of a grid of rates, terms and amounts.
+ *
+ * ln(1 + r) is computed once per rate and (1 + r)^-n once per rate and
+ * term; these factors are shared by all the amounts. The terms are priced
+ * by the workers of TaskScheduler, every amount by a loop over the rates
+ * without branches, which the compiler turns into SIMD code. The results
+ * are the same as those of priceBatch.
+ *
+ * @param type The type of monthly payments.
+ * @param axes The rates, the terms and the amounts of the grid.
+ * @param out The payments (the first one for differential credits) and
+ * the totals in the order of CreditCube::index.
+ * @throw std::invalid_argument If a term is not positive.
+ */
+void CreditModel::priceGrid(TypeOfMonthlyPayments type,
+                            const CreditGridAxes &axes, CreditCube &out) {
+  for (int term : axes.term) {
+    if (term < 1) {
+      throw std::invalid_argument("Term of the credit must be positive");
+    }
+  }
+  out.rates = axes.rate.size();
+  out.terms = axes.term.size();
+  out.credits = axes.credit.size();
+  const std::size_t size = out.rates * out.terms * out.credits;
+  out.monthly_pay.resize(size);
+  out.total.resize(size);
+  out.overpayment.resize(size);
+
+  std::vector<double> logarithm(out.rates);
+  for (std::size_t i = 0; i < out.rates; ++i) {
+    logarithm[i] = logKernel(1 + axes.rate[i] / 1200);
+  }
+  TaskScheduler::instance().parallelFor(
+      0, out.terms, 1,
+      [type, &axes, &logarithm, &out](std::size_t begin, std::size_t end) {
+        for (std::size_t t = begin; t < end; ++t) {
+          priceGridTerm(type, axes, logarithm, t, out);
+        }
+      });
+}
+
+/**
+ * @brief Find the annual rate giving a monthly payment.
+ *
+ * For annuities the payment is an increasing function of the rate, so the
+ * root is bracketed by [0, payment / credit]; Newton's method with the
+ * analytic derivative starts from the expansion of the payment for small
+ * rates and falls back to bisection whenever a step leaves the bracket.
+ * For differential credits the first payment is linear in the rate.
+ * Payments are not rounded to kopecks.
+ *
+ * @param type The type of monthly payments; for differential credits
+ * the payment is the first one.
+ * @param credit The amount of the credit.
+ * @param term The term in months.
+ * @param payment The monthly payment.
+ * @return The annual rate in percent and the number of iterations.
+ * @throw std::invalid_argument If the input is invalid or the payment is
+ * less than credit / term.
+ */
+CrSolution CreditModel::solveRate(TypeOfMonthlyPayments type, double credit,
+                                  int term, double payment) {
+  if (term < 1 || !(credit > 0) || !(payment >= credit / term)) {
+    throw std::invalid_argument("No rate gives this payment");
+  }
+  if (type == DIFFERENTIAL) {
+    return {(payment - credit / term) / credit * 1200, 0};
+  }
+  if (payment == credit / term) {
+    return {0, 0};
+  }
+  double low = 0, high = payment / credit;
+  // P = C / n + C r (n + 1) / (2 n) + O(r^2)
+  double rate = 2 * (payment * term - credit) / (credit * (term + 1));
+  if (!(rate > low && rate < high)) {
+    rate = high / 2;
+  }
+  int iterations = 0;
+  while (iterations < kSolverIterations) {
+    ++iterations;
+    double slope = 0;
+    double error =
+        calculateExactAnnuity(credit, term, rate, slope) - payment;
+    (error > 0 ? high : low) = rate;
+    if (std::fabs(error) <= 1e-12 * payment) break;
+    double next = rate - error / slope;
+    // шаг за пределы отрезка заменяется делением пополам
+    if (!(next > low && next < high)) {
+      next = low + (high - low) / 2;
+    }
+    bool converged = std::fabs(next - rate) <= 1e-15 * rate;
+    rate = next;
+    if (converged) break;
+  }
+  return {rate * 1200, iterations};
+}
+
+/**
+ * @brief Find the shortest term with a monthly payment not above a limit.
+ *
+ * The continuous term is found in closed form and then corrected by
+ * integer steps: one or two evaluations of the payment.
+ *
+ * @param type The type of monthly payments; for differential credits
+ * the payment is the first one.
+ * @param credit The amount of the credit.
+ * @param rate The annual rate in percent.
+ * @param payment The largest monthly payment.
+ * @return The term in months and the number of evaluations.
+ * @throw std::invalid_argument If the input is invalid or the payment
+ * does not exceed the monthly interest.
+ */
+CrSolution CreditModel::solveTerm(TypeOfMonthlyPayments type, double credit,
+                                  double rate, double payment) {
+  const double const_rate = rate / 1200;
+  if (!(credit > 0) || !(rate >= 0) || !(payment > credit * const_rate)) {
+    throw std::invalid_argument("No term gives this payment");
+  }
+  auto pay = [=](int term) {
+    double slope = 0;
+    return type == DIFFERENTIAL
+               ? credit / term + credit * const_rate
+               : calculateExactAnnuity(credit, term, const_rate, slope);
+  };
+  int term = type == DIFFERENTIAL
+                 ? std::max(1, static_cast<int>(ceil(
+                                   credit / (payment - credit * const_rate) -
+                                   1e-9)))
+                 : calculateTermFor(credit, payment, const_rate);
+  int iterations = 1;
+  for (; term > 1 && pay(term - 1) <= payment; ++iterations) --term;
+  for (; pay(term) > payment; ++iterations) ++term;
+  return {static_cast<double>(term), iterations};
+}
+
+/**
+ * @brief Find the largest credit with a given monthly payment.
+ *
+ * The payment is proportional to the credit, so the credit is found in
+ * closed form.
+ *
+ * @param type The type of monthly payments; for differential credits
+ * the payment is the first one.
+ * @param term The term in months.
+ * @param rate The annual rate in percent.
+ * @param payment The monthly payment.
+ * @return The amount of the credit; no iterations are made.
+ * @throw std::invalid_argument If the input is invalid.
+ */
+CrSolution CreditModel::solvePrincipal(TypeOfMonthlyPayments type, int term,
+                                       double rate, double payment) {
+  if (term < 1 || !(rate >= 0) || !(payment > 0)) {
+    throw std::invalid_argument("No credit gives this payment");
+  }
+  double slope = 0;
+  // платёж по кредиту в одну единицу
+  double unit = type == DIFFERENTIAL
+                    ? 1.0 / term + rate / 1200
+                    : calculateExactAnnuity(1, term, rate / 1200, slope);
+  return {payment / unit, 0};
+}
+
+/**
+ * @brief Solve the inverse problem for every credit of a portfolio.
+ *
+ * The unknown column of the portfolio is overwritten; the other columns
+ * and the payments are the input. Credits without a solution get NaN
+ * (term 0 when the term is solved). The portfolio is split into parts
+ * solved by the workers of TaskScheduler.
+ *
+ * @param unknown The column to be found.
+ * @param payments The monthly payments (the first ones for differential
+ * credits).
+ * @param portfolio The credits.
+ * @throw std::invalid_argument If the columns differ in length.
+ */
+void CreditModel::solveBatch(SolveFor unknown,
+                             const std::vector<double> &payments,
+                             CreditPortfolio &portfolio) {
+  const std::size_t n = payments.size();
+  if (portfolio.credit.size() != n || portfolio.term.size() != n ||
+      portfolio.rate.size() != n || portfolio.type.size() != n) {
+    throw std::invalid_argument("Columns of the portfolio differ in length");
+  }
+  TaskScheduler::instance().parallelFor(
+      0, n, kBatchGrain / 4,
+      [unknown, &payments, &portfolio](std::size_t begin, std::size_t end) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for (std::size_t i = begin; i < end; ++i) {
+          TypeOfMonthlyPayments type = portfolio.type[i];
+          try {
+            if (unknown == SolveFor::Rate) {
+              portfolio.rate[i] = solveRate(type, portfolio.credit[i],
+                                            portfolio.term[i], payments[i])
+                                      .value;
+            } else if (unknown == SolveFor::Term) {
+              portfolio.term[i] = static_cast<int>(
+                  solveTerm(type, portfolio.credit[i], portfolio.rate[i],
+                            payments[i])
+                      .value);
+            } else {
+              portfolio.credit[i] =
+                  solvePrincipal(type, portfolio.term[i], portfolio.rate[i],
+                                 payments[i])
+                      .value;
+            }
+          } catch (const std::invalid_argument &) {
+            if (unknown == SolveFor::Rate) portfolio.rate[i] = nan;
+            if (unknown == SolveFor::Term) portfolio.term[i] = 0;
+            if (unknown == SolveFor::Principal) portfolio.credit[i] = nan;
+          }
+        }
+      });
+}
+
+/**
+ * @brief Create a lazy schedule of payments starting today.
+ *
+ * @param type The type of monthly payment calculation
+ * (ANNUITY or DIFFERENTIAL).
+ * @param in The input data for the calculation.
+ * @return The schedule.
+ * @throw std::invalid_argument If the term is not positive.
+ */
+PaymentSchedule CreditModel::schedule(TypeOfMonthlyPayments type,
+                                      CrInput in) {
+  return schedule(type, in, getStartDate());
+}
+
+/**
+ * @brief Create a lazy schedule of payments.
+ *
+ * The rows are calculated one by one while the schedule is iterated, so
+ * the memory used does not depend on the term and no string is built.
+ *
+ * @param type The type of monthly payment calculation
+ * (ANNUITY or DIFFERENTIAL).
+ * @param in The input data for the calculation.
+ * @param start The date of the first payment.
+ * @return The schedule.
+ * @throw std::invalid_argument If the term is not positive.
+ */
+PaymentSchedule CreditModel::schedule(TypeOfMonthlyPayments type, CrInput in,
+                                      CrDate start) {
+  return PaymentSchedule(type, in, start);
+}
+
+/**
+ * @brief Create a lazy schedule of an annuity with early repayments
+ * starting today.
+ *
+ * @param plan The plan made by planAnnuity.
+ * @param in The input data the plan was made for.
+ * @return The schedule.
+ */
+PaymentSchedule CreditModel::schedule(const AnnuityPlan &plan, CrInput in) {
+  return schedule(plan, in, getStartDate());
+}
+
+/**
+ * @brief Create a lazy schedule of an annuity with early repayments.
+ *
+ * @param plan The plan made by planAnnuity.
+ * @param in The input data the plan was made for.
+ * @param start The date of the first payment.
+ * @return The schedule.
+ */
+PaymentSchedule CreditModel::schedule(const AnnuityPlan &plan, CrInput in,
+                                      CrDate start) {
+  return PaymentSchedule(plan, in, start);
+}
+
+/**
+ * @brief Format a date of payment as a string in the format "DD.MM.YYYY".
+ *
+ * @param date The date.
+ * @return The formatted date as a string.
+ */
+String CreditModel::formatDate(CrDate date) {
+  return formatDate(date.day, date.month, date.year);
+}
+
+/**
+ * @brief Converts a date to the number of days since 01.01.1970.
+ *
+ * @param date The date.
+ * @return The day number (negative before 1970).
+ */
+std::int32_t CreditModel::toDayNumber(CrDate date) {
+  return calendar::daysFromCivil(date.year, date.month, date.day);
+}
+
+/**
+ * @brief Converts the number of days since 01.01.1970 to a date.
+ *
+ * @param day The day number.
+ * @return The date.
+ */
+CrDate CreditModel::fromDayNumber(std::int32_t day) {
+  calendar::Date date = calendar::civilFromDays(day);
+  return {static_cast<std::int16_t>(date.year),
+          static_cast<std::int8_t>(date.month),
+          static_cast<std::int8_t>(date.day)};
+}
+
+/**
+ * @brief Removes all payments.
+ */
+void PaymentColumns::clear() {
+  monthly_pay.clear();
+  interest_pay.clear();
+  const_payment.clear();
+  total_reminder.clear();
+  day.clear();
+}
+
+/**
+ * @brief Reserves memory for payments.
+ *
+ * @param n The number of payments.
+ */
+void PaymentColumns::reserve(std::size_t n) {
+  monthly_pay.reserve(n);
+  interest_pay.reserve(n);
+  const_payment.reserve(n);
+  total_reminder.reserve(n);
+  day.reserve(n);
+}
+
+/**
+ * @brief Appends a row of a schedule.
+ *
+ * @param row The row.
+ */
+void PaymentColumns::append(const ScheduleRow &row) {
+  monthly_pay.push_back(row.monthly_pay);
+  interest_pay.push_back(row.interest_pay);
+  const_payment.push_back(row.const_payment);
+  total_reminder.push_back(row.total_reminder);
+  day.push_back(CreditModel::toDayNumber(row.date));
+}
+
+/**
+ * @brief Sums the interest paid in a calendar year.
+ *
+ * The days are sorted, so the payments of the year are found by binary
+ * search and the interest is summed over a contiguous part of its column.
+ *
+ * @param year The year.
+ * @return The interest paid in the year.
+ */
+double PaymentColumns::interestInYear(int year) const {
+  auto first = std::lower_bound(
+      day.begin(), day.end(),
+      CreditModel::toDayNumber({static_cast<std::int16_t>(year), 1, 1}));
+  auto last = std::lower_bound(
+      first, day.end(),
+      CreditModel::toDayNumber({static_cast<std::int16_t>(year + 1), 1, 1}));
+  return CreditModel::sumColumn(
+      interest_pay.data() + (first - day.begin()), last - first);
+}
+
+/**
+ * @brief Moves to the next row of the schedule.
+ *
+ * @return The iterator.
+ */
+PaymentSchedule::iterator& PaymentSchedule::iterator::operator++() {
+  remainder_ = row_.total_reminder;
+  if (++index_ < schedule_->term_) {
+    int day = row_.date.day, month = row_.date.month, year = row_.date.year;
+    CreditModel::incrementMonthAndYear(schedule_->start_.day, day, month,
+                                       year);
+    row_.date = {static_cast<std::int16_t>(year),
+                 static_cast<std::int8_t>(month),
+                 static_cast<std::int8_t>(day)};
+    fill();
+  }
+  return *this;
+}
+
+/**
+ * @brief Moves to the next row of the schedule.
+ *
+ * @return The iterator before the move.
+ */
+PaymentSchedule::iterator PaymentSchedule::iterator::operator++(int) {
+  iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
 /******************************************************************************
  * AUXILIARY PRIVATE MAIN METHODS
  ******************************************************************************/
 
+/**
+ * @brief Calculates the current row from the debt before the payment.
+ */
+void PaymentSchedule::iterator::fill() {
+  row_.interest_pay = remainder_ * schedule_->const_rate_;
+  if (schedule_->type_ == ANNUITY) {
+    const std::vector<AnnuitySegment> &segments = schedule_->segments_;
+    while (index_ >= segments[segment_].first_month - 1 +
+                         segments[segment_].months) {
+      ++segment_;
+    }
+    const AnnuitySegment &segment = segments[segment_];
+    bool last = index_ == segment.first_month + segment.months - 2;
+    row_.monthly_pay =
+        last ? segment.last_payment + segment.prepayment : segment.payment;
+    row_.const_payment = row_.monthly_pay - row_.interest_pay;
+  } else {
+    row_.const_payment = schedule_->const_payment_;
+    row_.monthly_pay = row_.const_payment + row_.interest_pay;
+  }
+  row_.total_reminder = remainder_ - row_.const_payment;
+}
+
+/**
+ * @brief Sums a column of values.
+ *
+ * Four independent partial sums let the compiler keep them in one vector
+ * register instead of waiting for every addition in turn.
+ *
+ * @param values Pointer to the values.
+ * @param n The number of values.
+ * @return The sum.
+ */
+double CreditModel::sumColumn(const double *values, std::size_t n) {
+  double sum[4] = {0, 0, 0, 0};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    for (std::size_t lane = 0; lane < 4; ++lane) {
+      sum[lane] += values[i + lane];
+    }
+  }
+  for (; i < n; ++i) {
+    sum[0] += values[i];
+  }
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+/**
+ * @brief Prices a block of credits of a portfolio.
+ *
+ * The inputs are copied into arrays of kBatchBlock elements, padded with
+ * a harmless credit, so every loop has a constant length.
+ *
+ * @param in The credits.
+ * @param out The results.
+ * @param start The first credit of the block.
+ * @param count The number of credits, at most kBatchBlock.
+ */
+void CreditModel::priceBlock(const CreditPortfolio &in, PortfolioQuotes &out,
+                             std::size_t start, std::size_t count) {
+  double credit[kBatchBlock], term[kBatchBlock], rate[kBatchBlock];
+  double annual[kBatchBlock], differential[kBatchBlock];
+  for (std::size_t i = 0; i < count; ++i) {
+    credit[i] = in.credit[start + i];
+    term[i] = in.term[start + i];
+    annual[i] = in.rate[start + i];
+    rate[i] = annual[i] / 1200;
+    differential[i] = in.type[start + i] == DIFFERENTIAL ? 1 : 0;
+  }
+  for (std::size_t i = count; i < kBatchBlock; ++i) {
+    credit[i] = 0;
+    term[i] = 1;
+    annual[i] = 0;
+    rate[i] = 0;
+    differential[i] = 0;
+  }
+  // (1 + r)^-n = e^x, x = -n ln(1 + r)
+  double exponent[kBatchBlock], annuity[kBatchBlock];
+  for (std::size_t i = 0; i < kBatchBlock; ++i) {
+    exponent[i] = -term[i] * logKernel(1 + rate[i]);
+    annuity[i] = credit[i] * rate[i] / (1 - expKernel(exponent[i]));
+  }
+  // редкие случаи с ветвлениями: нулевая ставка и степень вне ядра
+  for (std::size_t i = 0; i < count; ++i) {
+    if (rate[i] == 0) {
+      annuity[i] = credit[i] / term[i];
+    } else if (!(std::fabs(exponent[i]) <= kExpLimit)) {
+      annuity[i] = exponent[i] < 0 ? credit[i] * rate[i] : 0;
+    }
+  }
+  // тип платежей выбирается весами 0 и 1: результат точный
+  double pay[kBatchBlock], total[kBatchBlock], overpayment[kBatchBlock];
+  for (std::size_t i = 0; i < kBatchBlock; ++i) {
+    double c = credit[i], n = term[i], d = differential[i];
+    // ставка в месяц в том же порядке операций, что и в summarizeDifferential
+    double r = annual[i] / 12 / 100;
+    double a = roundKernel(annuity[i] * 100) / 100;
+    double interest = c * r * (n + 1) / 2;
+    pay[i] = d * (c / n + c * r) + (1 - d) * a;
+    total[i] = d * (c + interest) + (1 - d) * (a * n);
+    overpayment[i] = d * interest + (1 - d) * (a * n - c);
+  }
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  for (std::size_t i = 0; i < count; ++i) {
+    bool valid = in.term[start + i] >= 1;
+    out.monthly_pay[start + i] = valid ? pay[i] : nan;
+    out.total[start + i] = valid ? total[i] : nan;
+    out.overpayment[start + i] = valid ? overpayment[i] : nan;
+  }
+}
+
+/**
+ * @brief Calculate the rounded annuity payment.
+ *
+ * @param in The input data for the calculation.
+ * @return The monthly payment rounded to kopecks.
+ */
+double CreditModel::calculateAnnuityPayment(CrInput in) {
+  if (in.rate == 0) {
+    return round(in.credit / in.term * 100) / 100;
+  }
+  return round(in.credit * (in.rate / 1200) /
+               (1 - pow(1 + in.rate / 1200, -in.term)) * 100) /
+         100;
+}
+
+/**
+ * @brief Price the credits of a grid with one term.
+ *
+ * The rates are processed in blocks of kBatchBlock. An annuity payment is
+ * C m / s with m = r and s = 1 - (1 + r)^-n; the rare cases are folded
+ * into m and s once per rate (m = 1, s = n for a zero rate), so the loops
+ * over the amounts have constant length and no branches.
+ *
+ * @param type The type of monthly payments.
+ * @param axes The rates, the terms and the amounts of the grid.
+ * @param logarithm ln(1 + r) for every rate.
+ * @param term_index The index of the term.
+ * @param out The results of the grid.
+ */
+void CreditModel::priceGridTerm(TypeOfMonthlyPayments type,
+                                const CreditGridAxes &axes,
+                                const std::vector<double> &logarithm,
+                                std::size_t term_index, CreditCube &out) {
+  const double n = axes.term[term_index];
+  const double d = type == DIFFERENTIAL ? 1 : 0;
+  for (std::size_t start = 0; start < out.rates; start += kBatchBlock) {
+    const std::size_t count = std::min(kBatchBlock, out.rates - start);
+    double m[kBatchBlock], s[kBatchBlock], exponent[kBatchBlock];
+    for (std::size_t i = 0; i < count; ++i) {
+      exponent[i] = -n * logarithm[start + i];
+      m[i] = axes.rate[start + i] / 1200;
+    }
+    for (std::size_t i = count; i < kBatchBlock; ++i) {
+      exponent[i] = 0;
+      m[i] = 0;
+    }
+    for (std::size_t i = 0; i < kBatchBlock; ++i) {
+      s[i] = 1 - expKernel(exponent[i]);
+    }
+    for (std::size_t i = 0; i < kBatchBlock; ++i) {
+      if (type == DIFFERENTIAL) {
+        // ставка в месяц в том же порядке операций, что и в priceBlock
+        m[i] = i < count ? axes.rate[start + i] / 12 / 100 : 0;
+        s[i] = 1;
+      } else if (m[i] == 0) {
+        m[i] = 1;
+        s[i] = n;
+      } else if (!(std::fabs(exponent[i]) <= kExpLimit)) {
+        m[i] = exponent[i] < 0 ? m[i] : 0;
+        s[i] = 1;
+      }
+    }
+
+    double pay[kBatchBlock], total[kBatchBlock], overpayment[kBatchBlock];
+    for (std::size_t k = 0; k < out.credits; ++k) {
+      const double c = axes.credit[k];
+      // тип платежей выбирается весами 0 и 1: результат точный
+      for (std::size_t i = 0; i < kBatchBlock; ++i) {
+        double a = roundKernel(c * m[i] / s[i] * 100) / 100;
+        double interest = c * m[i] * (n + 1) / 2;
+        pay[i] = d * (c / n + c * m[i]) + (1 - d) * a;
+        total[i] = d * (c + interest) + (1 - d) * (a * n);
+        overpayment[i] = d * interest + (1 - d) * (a * n - c);
+      }
+      const std::size_t offset = out.index(start, term_index, k);
+      std::copy(pay, pay + count, out.monthly_pay.begin() + offset);
+      std::copy(total, total + count, out.total.begin() + offset);
+      std::copy(overpayment, overpayment + count,
+                out.overpayment.begin() + offset);
+    }
+  }
+}
+
+/**
+ * @brief Calculate the exact (not rounded) annuity payment and its
+ * derivative with respect to the monthly rate.
+ *
+ * A = C r / (1 - g), g = (1 + r)^-n,
+ * dA/dr = C ((1 - g) - r n g / (1 + r)) / (1 - g)^2.
+ *
+ * @param credit The amount of the credit.
+ * @param term The term in months.
+ * @param const_rate The interest rate per month.
+ * @param slope The derivative of the payment.
+ * @return The payment.
+ */
+double CreditModel::calculateExactAnnuity(double credit, int term,
+                                          double const_rate, double &slope) {
+  if (const_rate == 0) {
+    slope = credit * (term + 1) / (2.0 * term);
+    return credit / term;
+  }
+  double exponent = -term * std::log1p(const_rate);
+  double growth = std::exp(exponent);
+  double share = -std::expm1(exponent);  // 1 - g без потери точности
+  slope = credit * (share - const_rate * term * growth / (1 + const_rate)) /
+          (share * share);
+  return credit * const_rate / share;
+}
+
+/**
+ * @brief Calculate the debt of an annuity after some payments.
+ *
+ * D(k) = D * (1 + r)^k - P * ((1 + r)^k - 1) / r.
+ *
+ * @param debt The debt before the payments.
+ * @param payment The monthly payment.
+ * @param const_rate The interest rate per month.
+ * @param months The number of payments.
+ * @return The debt after the payments.
+ */
+double CreditModel::calculateDebtAfter(double debt, double payment,
+                                       double const_rate, int months) {
+  if (const_rate == 0) {
+    return debt - payment * months;
+  }
+  double growth = pow(1 + const_rate, months);
+  return debt * growth - payment * (growth - 1) / const_rate;
+}
+
+/**
+ * @brief Calculate the number of payments repaying a debt.
+ *
+ * n = -ln(1 - D * r / P) / ln(1 + r), rounded up; the last payment is
+ * smaller than the others.
+ *
+ * @param debt The debt.
+ * @param payment The monthly payment, larger than the monthly interest.
+ * @param const_rate The interest rate per month.
+ * @return The number of payments.
+ */
+int CreditModel::calculateTermFor(double debt, double payment,
+                                  double const_rate) {
+  double months = const_rate == 0
+                      ? debt / payment
+                      : -log(1 - debt * const_rate / payment) /
+                            log(1 + const_rate);
+  // допуск не даёт погрешности добавить лишний месяц
+  return std::max(1, static_cast<int>(ceil(months - 1e-9)));
+}
+
+/**
+ * @brief Converts a row of a schedule to a payment with a formatted date.
+ *
+ * @param row The row.
+ * @return The payment.
+ */
+Payment CreditModel::toPayment(const ScheduleRow &row) {
+  return {row.monthly_pay, row.interest_pay, formatDate(row.date),
+          row.total_reminder, row.const_payment};
+}
+
+/**
+ * @brief Stores the rows of a schedule by columns.
+ *
+ * @param rows The schedule.
+ * @param payments The columns, replaced by the rows.
+ */
+void CreditModel::fillColumns(const PaymentSchedule &rows,
+                              PaymentColumns &payments) {
+  payments.clear();
+  payments.reserve(rows.size());
+  for (const ScheduleRow &row : rows) {
+    payments.append(row);
+  }
+}
+
 /**
  * @brief Calculate the annuity payment.
  *
@@ -55,9 +1169,7 @@ void CreditModel::calculateCredit(TypeOfMonthlyPayments type, CrInput in,
  */
 void CreditModel::calculateAnnuity(CrInput in, double &monthly_pay,
                                    CrOutput &out) {
-  monthly_pay = round(in.credit * (in.rate / 1200) /
-                      (1 - pow(1 + in.rate / 1200, -in.term)) * 100) /
-                100;
+  monthly_pay = calculateAnnuityPayment(in);
   out.total = monthly_pay * in.term;
   out.overpayment = out.total - in.credit;
 }
@@ -68,6 +1180,8 @@ void CreditModel::calculateAnnuity(CrInput in, double &monthly_pay,
  * This function calculates the differential payments for a given credit term
  * and rate. It returns a vector of payments, each containing the payment
  * amount, the remaining debt, and the formatted date of the payment.
+ * The rows are taken from the lazy schedule, which should be iterated
+ * directly when the rows are not kept.
  *
  * @param in The input data for the calculation, including the credit amount,
  * term and rate.
@@ -78,29 +1192,15 @@ void CreditModel::calculateAnnuity(CrInput in, double &monthly_pay,
  */
 PaymentVector CreditModel::calculateDifferential(CrInput in, double& first_month_pay, CrOutput &out) {
     PaymentVector payments;
-    double total_reminder = in.credit;
-    double const_payment = in.credit / in.term;
-    double const_rate = in.rate / 12 / 100; // процентная ставка в месяц
-    double monthly_pay;
-    double interest_pay;
+    payments.reserve(in.term);
     out.total = 0;
 
-    int current_day, current_month, current_year;
-    getCurrentDateAndTime(current_day, current_month, current_year);
-
-    // вычисляем платёж в первый месяц
-    first_month_pay = calculateFirstMonthPayment(total_reminder, const_rate, const_payment);
-
-    for (int i = 0; i < in.term; i++) {
-        // вычисляем платеж за месяц
-        calculateMonthlyPayment(total_reminder, const_payment, const_rate, monthly_pay, interest_pay, out);
-
+    PaymentSchedule rows = schedule(DIFFERENTIAL, in);
+    first_month_pay = rows.begin()->monthly_pay;
+    for (const ScheduleRow& row : rows) {
         // отформатируем дату и добавим детали платежа в вектор платежей
-        std::string formatted_date = formatDate(current_day, current_month, current_year);
-        payments.push_back({monthly_pay, interest_pay, formatted_date, total_reminder, const_payment});
-
-        // увеличение месяца и года
-        incrementMonthAndYear(current_day, current_month, current_year);
+        payments.push_back(toPayment(row));
+        out.total += row.monthly_pay;
     }
 
     // расчитаем переплату
@@ -109,31 +1209,24 @@ PaymentVector CreditModel::calculateDifferential(CrInput in, double& first_month
 }
 
 /**
- * @brief Calculate the monthly payment based on the credit, rate,
- * days in year and days in month.
+ * @brief Calculate the totals of the differential payments in closed form.
  *
- * This function calculates the monthly payment for a given credit amount, rate,
- * number of days in the month, and number of days in the year.
+ * The debt decreases by C / n every month, so the interest forms an
+ * arithmetic series: C * r * (n + (n - 1) + ... + 1) / n, that is
+ * C * r * (n + 1) / 2.
  *
- * @param total_reminder The remaining credit amount.
- * @param const_payment The constant payment part.
- * @param const_rate The interest rate.
- * @param monthly_pay The calculated monthly payment.
- * @param interest_pay The calculated interest for the month.
- * @param out The output data containing the total payment and overpayment.
+ * @param in The input data for the calculation, including the credit amount,
+ * term and rate.
+ * @return The total payment, the overpayment and the first and last
+ * payments.
  */
-void CreditModel::calculateMonthlyPayment(double& total_reminder, double const_payment, double const_rate, double& monthly_pay, double& interest_pay, CrOutput& out) {
-    // Вычисляем проценты на оставшуюся сумму долга
-    interest_pay = total_reminder * const_rate;
-
-    // общий платеж за месяц
-    monthly_pay = const_payment + interest_pay;
-
-    // обновляем оставшуюся сумму долга
-    total_reminder -= const_payment;
-
-    // добавляем общий платеж к общей сумме
-    out.total += monthly_pay;
+CrSummary CreditModel::summarizeDifferential(CrInput in) {
+  double const_payment = in.credit / in.term;
+  double const_rate = in.rate / 12 / 100; // процентная ставка в месяц
+  double overpayment = in.credit * const_rate * (in.term + 1) / 2;
+  return {in.credit + overpayment, overpayment,
+          calculateFirstMonthPayment(in.credit, const_rate, const_payment),
+          const_payment * (1 + const_rate)};
 }
 
 /**
@@ -156,62 +1249,27 @@ double CreditModel::calculateFirstMonthPayment(double total_reminder, double con
  * @brief Get the current date as a string.
  *
  * @return The current date as a string in the format "YYYY-MM-DD".
+ * @throw std::runtime_error If the local time cannot be converted.
  */
 String CreditModel::getCurrentDate() {
-  std::time_t now_time = std::time(nullptr);
-  std::tm *now_tm = std::localtime(&now_time);
+  calendar::Date now = calendar::localDate(std::time(nullptr));
   std::ostringstream oss;
-  oss << std::put_time(now_tm, "%Y-%m-%d");
+  oss << now.year << '-' << std::setfill('0') << std::setw(2) << now.month
+      << '-' << std::setw(2) << now.day;
   return oss.str();
 }
 
 /**
- * @brief Check if a year is a leap year.
+ * @brief Get the current date as the date of the first payment.
  *
- * @param year The year to check.
- * @return True if the year is a leap year, false otherwise.
+ * @return The current date.
  */
-bool CreditModel::isLeapYear(int year) {
-  return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-}
-
-/**
- * @brief Get the number of days in a year.
- *
- * @param year The year to check.
- * @return The number of days in the year (366 for leap years, 365 otherwise).
- */
-int CreditModel::getDaysInYear(int year) {
-  return isLeapYear(year) ? 366 : 365;
-}
-
-/**
- * @brief Get the number of days in a month.
- *
- * @param month The month to check.
- * @param year The year to check.
- * @return The number of days in the month.
- */
-int CreditModel::getDaysInMonth(int month, int year) {
-  switch (month) {
-    case JANUARY:
-    case MARCH:
-    case MAY:
-    case JULY:
-    case AUGUST:
-    case OCTOBER:
-    case DECEMBER:
-      return 31;
-    case APRIL:
-    case JUNE:
-    case SEPTEMBER:
-    case NOVEMBER:
-      return 30;
-    case FEBRUARY:
-      return isLeapYear(year) ? 29 : 28;
-    default:
-      return UNKNOWN;
-  }
+CrDate CreditModel::getStartDate() {
+  int current_day, current_month, current_year;
+  getCurrentDateAndTime(current_day, current_month, current_year);
+  return {static_cast<std::int16_t>(current_year),
+          static_cast<std::int8_t>(current_month),
+          static_cast<std::int8_t>(current_day)};
 }
 
 /**
@@ -220,14 +1278,15 @@ int CreditModel::getDaysInMonth(int month, int year) {
  * @param current_day The current day.
  * @param current_month The current month.
  * @param current_year The current year.
+ * @throw std::runtime_error If the local time cannot be converted.
  */
 void CreditModel::getCurrentDateAndTime(int &current_day, int &current_month,
                                         int &current_year) {
-  std::time_t now_time = std::time(nullptr);
-  std::tm *now_tm = std::localtime(&now_time);
-  current_year = now_tm->tm_year + 1900;
-  current_month = now_tm->tm_mon + 1;
-  current_day = now_tm->tm_mday;
+  // localtime_r вместо std::localtime: кредиты считаются параллельно
+  calendar::Date now = calendar::localDate(std::time(nullptr));
+  current_year = now.year;
+  current_month = now.month;
+  current_day = now.day;
 }
 
 /**
@@ -249,11 +1308,16 @@ String CreditModel::formatDate(int day, int month, int year) {
 /**
  * @brief Increment the month and year.
  *
+ * The day of payment is kept, except in the months that are too short
+ * for it.
+ *
+ * @param anchor_day The day of the first payment.
  * @param current_day The current day.
  * @param current_month The current month.
  * @param current_year The current year.
  */
-void CreditModel::incrementMonthAndYear(int &current_day, int &current_month,
+void CreditModel::incrementMonthAndYear(int anchor_day, int &current_day,
+                                        int &current_month,
                                         int &current_year) {
   current_month++;
   if (current_month > 12) {
@@ -261,10 +1325,18 @@ void CreditModel::incrementMonthAndYear(int &current_day, int &current_month,
     current_year++;
   }
 
-  int days_in_month = getDaysInMonth(current_month, current_year);
-  if (current_day > days_in_month) {
-    current_day = days_in_month;
-  }
+  current_day =
+      std::min(anchor_day, calendar::daysInMonth(current_year, current_month));
 }
 
+// денежные типы графика платежей
+template void CreditModel::calculateLedger<double>(TypeOfMonthlyPayments,
+                                                   CrInput,
+                                                   CreditLedger<double> &,
+                                                   Rounding);
+template void CreditModel::calculateLedger<Money>(TypeOfMonthlyPayments,
+                                                  CrInput,
+                                                  CreditLedger<Money> &,
+                                                  Rounding);
+
 }  // namespace s21
@@ -18,11 +18,18 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstddef>  // PaymentSchedule::iterator
+#include <cstdint>  // CrDate, PaymentColumns
 #include <ctime>    // getCurrentDate, getCurrentDateAndTime
 #include <iomanip>  // getCurrentDate, getCurrentDateAndTime
+#include <iterator>  // PaymentSchedule::iterator
 #include <sstream>  // getCurrentDate, formatDate
+#include <stdexcept>  // summarizeCredit
 #include <string>   // calculateDifferential, getCurrentDate, formatDate
-#include <vector>   // calculateDifferential
+#include <vector>   // calculateDifferential, PaymentColumns
+
+#include "calendar.h"
+#include "money.h"
 
 namespace s21 {
 
@@ -39,6 +46,14 @@ struct CrOutput {
   double overpayment;
 };
 
+// итоги кредита без графика платежей
+struct CrSummary {
+  double total; // общая выплата
+  double overpayment; // переплата
+  double first_pay; // первый платёж
+  double last_pay; // последний платёж
+};
+
 struct Payment {
   double monthly_pay; // ежемесячный платёж
   double interest_pay; // платёж по процентам
@@ -50,42 +65,251 @@ struct Payment {
 using PaymentVector = std::vector<Payment>;
 using String = std::string;
 
+// дата платежа без выделения памяти
+struct CrDate {
+  std::int16_t year; // год
+  std::int8_t month; // месяц
+  std::int8_t day; // число
+};
+
+// строка графика платежей, вычисляемая по запросу
+struct ScheduleRow {
+  double monthly_pay; // ежемесячный платёж
+  double interest_pay; // платёж по процентам
+  CrDate date; // число платежа
+  double total_reminder; // остаток долга
+  double const_payment; // платёж по основному долгу
+};
+
+// портфель кредитов по столбцам
+struct CreditPortfolio {
+  std::vector<double> credit; // сумма кредита
+  std::vector<int> term; // срок в месяцах
+  std::vector<double> rate; // годовая ставка в процентах
+  std::vector<TypeOfMonthlyPayments> type; // тип платежей
+};
+
+// итоги кредитов портфеля по столбцам
+struct PortfolioQuotes {
+  std::vector<double> monthly_pay; // платёж (первый для дифференцированного)
+  std::vector<double> total; // общая выплата
+  std::vector<double> overpayment; // переплата
+};
+
+// оси сетки чувствительности
+struct CreditGridAxes {
+  std::vector<double> rate; // годовые ставки в процентах
+  std::vector<int> term; // сроки в месяцах
+  std::vector<double> credit; // суммы кредита
+};
+
+// итоги по всем узлам сетки; быстрее всего меняется ставка, поэтому
+// срез с одной суммой кредита - непрерывная матрица срок x ставка
+struct CreditCube {
+  std::size_t rates = 0; // количество ставок
+  std::size_t terms = 0; // количество сроков
+  std::size_t credits = 0; // количество сумм
+  std::vector<double> monthly_pay; // платёж (первый для дифференцированного)
+  std::vector<double> total; // общая выплата
+  std::vector<double> overpayment; // переплата
+
+  std::size_t index(std::size_t rate, std::size_t term,
+                    std::size_t credit) const {
+    return (credit * terms + term) * rates + rate;
+  }
+};
+
+// график платежей в денежном типе Amount (double или Money)
+template <typename Amount>
+struct CreditLedger {
+  std::vector<Amount> monthly_pay; // ежемесячный платёж
+  std::vector<Amount> interest_pay; // платёж по процентам
+  std::vector<Amount> const_payment; // платёж по основному долгу
+  std::vector<Amount> total_reminder; // остаток долга
+  Amount total{}; // общая выплата
+  Amount overpayment{}; // переплата
+};
+
+// неизвестная величина обратной задачи
+enum class SolveFor { Rate, Term, Principal };
+
+// решение обратной задачи
+struct CrSolution {
+  double value; // ставка в процентах, срок в месяцах или сумма кредита
+  int iterations; // число итераций
+};
+
+// график платежей по столбцам: каждая величина в своём массиве
+struct PaymentColumns {
+  std::vector<double> monthly_pay; // ежемесячный платёж
+  std::vector<double> interest_pay; // платёж по процентам
+  std::vector<double> const_payment; // платёж по основному долгу
+  std::vector<double> total_reminder; // остаток долга
+  std::vector<std::int32_t> day; // число платежа: дни от 01.01.1970
+
+  std::size_t size() const { return day.size(); }
+  void clear();
+  void reserve(std::size_t n);
+  void append(const ScheduleRow& row);
+  double interestInYear(int year) const;
+};
+
+// как пересчитывается кредит после досрочного погашения
+enum class RepaymentMode { ReduceTerm, ReducePayment };
+
+// досрочное погашение
+struct EarlyRepayment {
+  int month; // номер платежа (с 1), вместе с которым вносится сумма
+  double amount; // сумма (не меньше остатка - полное погашение)
+  RepaymentMode mode; // уменьшить срок или платёж
+};
+
+using RepaymentVector = std::vector<EarlyRepayment>;
+
+// участок аннуитета между досрочными погашениями
+struct AnnuitySegment {
+  int first_month; // номер первого платежа участка (с 1)
+  int months; // количество платежей
+  double debt; // долг перед первым платежом
+  double payment; // ежемесячный платёж
+  double last_payment; // последний платёж (закрывает долг в конце кредита)
+  double prepayment; // досрочное погашение вместе с последним платежом
+};
+
+// аннуитет с досрочными погашениями
+struct AnnuityPlan {
+  std::vector<AnnuitySegment> segments; // участки по порядку
+  int term; // фактический срок в месяцах
+  double total; // общая выплата, включая досрочные погашения
+  double overpayment; // переплата
+};
+
+class PaymentSchedule {
+ public:
+  // однопроходный итератор: строка вычисляется при переходе к ней
+  class iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = ScheduleRow;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const ScheduleRow*;
+    using reference = const ScheduleRow&;
+
+    iterator() = default;
+    reference operator*() const { return row_; }
+    pointer operator->() const { return &row_; }
+    iterator& operator++();
+    iterator operator++(int);
+    bool operator==(const iterator& other) const {
+      return index_ == other.index_;
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class PaymentSchedule;
+    iterator(const PaymentSchedule* schedule, int index);
+    void fill();
+
+    const PaymentSchedule* schedule_ = nullptr;
+    int index_ = 0;
+    std::size_t segment_ = 0; // участок аннуитета текущей строки
+    double remainder_ = 0; // долг перед платежом
+    ScheduleRow row_{};
+  };
+
+  PaymentSchedule(TypeOfMonthlyPayments type, CrInput in, CrDate start);
+  PaymentSchedule(const AnnuityPlan& plan, CrInput in, CrDate start);
+
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, term_); }
+  int size() const { return term_; }
+
+ private:
+  TypeOfMonthlyPayments type_;
+  CrInput in_;
+  CrDate start_;
+  int term_; // количество платежей
+  double const_rate_; // процентная ставка в месяц
+  double const_payment_; // платёж по основному долгу (дифференцированный)
+  std::vector<AnnuitySegment> segments_; // участки аннуитета
+};
+
 class CreditModel {
  public:
   void calculateCredit(TypeOfMonthlyPayments type, CrInput in,
                        double& monthly_pay, CrOutput& out,
                        PaymentVector& payments);
+  void calculateCredit(TypeOfMonthlyPayments type, CrInput in,
+                       double& monthly_pay, CrOutput& out,
+                       PaymentColumns& payments);
+  void calculateCredit(CrInput in, const RepaymentVector& events,
+                       double& monthly_pay, CrOutput& out,
+                       PaymentColumns& payments);
+  CrSummary summarizeCredit(TypeOfMonthlyPayments type, CrInput in);
+  AnnuityPlan planAnnuity(CrInput in, const RepaymentVector& events);
+  template <typename Amount>
+  static void calculateLedger(
+      TypeOfMonthlyPayments type, CrInput in, CreditLedger<Amount>& ledger,
+      Rounding rounding = Rounding::HalfAwayFromZero);
+  static void priceBatch(const CreditPortfolio& in, PortfolioQuotes& out);
+  static void priceGrid(TypeOfMonthlyPayments type,
+                        const CreditGridAxes& axes, CreditCube& out);
+  static CrSolution solveRate(TypeOfMonthlyPayments type, double credit,
+                              int term, double payment);
+  static CrSolution solveTerm(TypeOfMonthlyPayments type, double credit,
+                              double rate, double payment);
+  static CrSolution solvePrincipal(TypeOfMonthlyPayments type, int term,
+                                   double rate, double payment);
+  static void solveBatch(SolveFor unknown,
+                         const std::vector<double>& payments,
+                         CreditPortfolio& portfolio);
+  PaymentSchedule schedule(TypeOfMonthlyPayments type, CrInput in);
+  PaymentSchedule schedule(TypeOfMonthlyPayments type, CrInput in,
+                           CrDate start);
+  PaymentSchedule schedule(const AnnuityPlan& plan, CrInput in);
+  PaymentSchedule schedule(const AnnuityPlan& plan, CrInput in, CrDate start);
+  static String formatDate(CrDate date);
+  static std::int32_t toDayNumber(CrDate date);
+  static CrDate fromDayNumber(std::int32_t day);
 
  private:
+  friend class PaymentSchedule;
+  friend struct PaymentColumns;
+
   void calculateAnnuity(CrInput in, double& monthly_pay, CrOutput& out);
   PaymentVector calculateDifferential(CrInput in, double& first_month_pay, CrOutput& out);
-  void calculateMonthlyPayment(double& total_reminder, double const_payment, double const_rate, double& payment, double& interest, CrOutput& out);
+  CrSummary summarizeDifferential(CrInput in);
+  static double sumColumn(const double* values, std::size_t n);
+  static void priceBlock(const CreditPortfolio& in, PortfolioQuotes& out,
+                         std::size_t start, std::size_t count);
+  static void priceGridTerm(TypeOfMonthlyPayments type,
+                            const CreditGridAxes& axes,
+                            const std::vector<double>& logarithm,
+                            std::size_t term_index, CreditCube& out);
+  // предел итераций решателей
+  static constexpr int kSolverIterations = 100;
+  // кредиты в одной задаче пакетного расчёта
+  static constexpr std::size_t kBatchGrain = 16384;
+  // кредиты в блоке: циклы постоянной длины векторизуются целиком
+  static constexpr std::size_t kBatchBlock = 256;
+
+  static double calculateAnnuityPayment(CrInput in);
+  static double calculateExactAnnuity(double credit, int term,
+                                      double const_rate, double& slope);
+  static double calculateDebtAfter(double debt, double payment,
+                                   double const_rate, int months);
+  static int calculateTermFor(double debt, double payment, double const_rate);
+  static Payment toPayment(const ScheduleRow& row);
+  static void fillColumns(const PaymentSchedule& rows,
+                          PaymentColumns& payments);
+  CrDate getStartDate();
   double calculateFirstMonthPayment(double total_reminder, double const_rate, double const_payment);
   String getCurrentDate();
-  bool isLeapYear(int year);
-  int getDaysInYear(int year);
-  int getDaysInMonth(int month, int year);
   void getCurrentDateAndTime(int& current_day, int& current_month,
                              int& current_year);
-  String formatDate(int day, int month, int year);
-  void incrementMonthAndYear(int& current_day, int& current_month,
-                             int& current_year);
-
-  enum Month {
-    UNKNOWN,
-    JANUARY,
-    FEBRUARY,
-    MARCH,
-    APRIL,
-    MAY,
-    JUNE,
-    JULY,
-    AUGUST,
-    SEPTEMBER,
-    OCTOBER,
-    NOVEMBER,
-    DECEMBER
-  };
+  static String formatDate(int day, int month, int year);
+  static void incrementMonthAndYear(int anchor_day, int& current_day,
+                                    int& current_month, int& current_year);
 };
 
 }  // namespace s21
@@ -0,0 +1,194 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file model_curve.cc
+ *
+ * @brief Implementation of the CurveModel class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the CurveModel class,
+ * which is part of the SmartCalc v2.0 library.
+ * The CurveModel class calculates parametric (x(t), y(t)) and polar r(θ)
+ * curves with adaptive sampling of the parameter, so that the length of
+ * every segment of the curve stays within a given number of pixels.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "model_curve.h"
+
+#include <algorithm>  // std::min
+
+namespace s21 {
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Calculates a parametric curve (x(t), y(t)).
+ *
+ * Both component expressions are compiled into one fused program and
+ * evaluated together in blocks.
+ *
+ * @param in The input data; the parameter t is written as 'x'.
+ * @return Rows t, x and y of the sampled curve.
+ * @throw std::invalid_argument If the input or expressions are invalid.
+ */
+Vector CurveModel::calculateParametric(const CurveInput& in) {
+  validateInput(in);
+  ExpressionProgram program =
+      ExpressionProgram::compile(StringVector{in.first, in.second});
+  return sample(program, CurveType::Parametric, in);
+}
+
+/**
+ * @brief Calculates a polar curve r(θ).
+ *
+ * @param in The input data; the angle θ is written as 'x',
+ * the field second is ignored.
+ * @return Rows θ, x and y of the sampled curve.
+ * @throw std::invalid_argument If the input or expression is invalid.
+ */
+Vector CurveModel::calculatePolar(const CurveInput& in) {
+  validateInput(in);
+  ExpressionProgram program = ExpressionProgram::compile(in.first);
+  return sample(program, CurveType::Polar, in);
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Samples a curve adaptively.
+ *
+ * The curve is first evaluated on a uniform grid of the parameter.
+ * Then every segment longer than maxSegment pixels gets a midpoint, all
+ * midpoints of one pass are evaluated as a single batch, and the passes
+ * repeat until all segments are short enough, kMaxDepth is reached or the
+ * limit of points is exhausted. Segments with an undefined end are not
+ * refined.
+ *
+ * @param program The compiled component expressions.
+ * @param type The type of the curve.
+ * @param in The input data.
+ * @return Rows t, x and y of the sampled curve.
+ */
+Vector CurveModel::sample(const ExpressionProgram& program, CurveType type,
+                          const CurveInput& in) {
+  Vector curve(3);
+  std::vector<double>& t = curve[0];
+  std::vector<double>& x = curve[1];
+  std::vector<double>& y = curve[2];
+
+  // начальная равномерная сетка, включая конец диапазона
+  double step = (in.tRange.second - in.tRange.first) / in.initialPoints;
+  for (unsigned i = 0; i <= in.initialPoints; ++i) {
+    t.push_back(in.tRange.first + i * step);
+  }
+  evaluatePoints(program, type, t, x, y);
+
+  std::vector<double> midT, midX, midY;
+  for (int depth = 0; depth < kMaxDepth; ++depth) {
+    // собираем середины слишком длинных отрезков
+    midT.clear();
+    std::vector<bool> split(t.size(), false);
+    for (size_t i = 0; i + 1 < t.size(); ++i) {
+      double length = segmentLength(x[i], y[i], x[i + 1], y[i + 1], in);
+      if (std::isfinite(length) && length > in.maxSegment &&
+          t.size() + midT.size() < in.maxPoints) {
+        split[i] = true;
+        midT.push_back((t[i] + t[i + 1]) / 2);
+      }
+    }
+    if (midT.empty()) break;
+    evaluatePoints(program, type, midT, midX, midY);
+
+    // вставляем новые точки между старыми, сохраняя порядок по t
+    Vector merged(3);
+    for (auto& row : merged) row.reserve(t.size() + midT.size());
+    for (size_t i = 0, k = 0; i < t.size(); ++i) {
+      merged[0].push_back(t[i]);
+      merged[1].push_back(x[i]);
+      merged[2].push_back(y[i]);
+      if (split[i]) {
+        merged[0].push_back(midT[k]);
+        merged[1].push_back(midX[k]);
+        merged[2].push_back(midY[k]);
+        ++k;
+      }
+    }
+    t.swap(merged[0]);
+    x.swap(merged[1]);
+    y.swap(merged[2]);
+  }
+  return curve;
+}
+
+/**
+ * @brief Evaluates the curve at the given values of the parameter.
+ *
+ * @param program The compiled component expressions.
+ * @param type The type of the curve.
+ * @param t The values of the parameter.
+ * @param x The calculated x coordinates.
+ * @param y The calculated y coordinates.
+ */
+void CurveModel::evaluatePoints(const ExpressionProgram& program,
+                                CurveType type, const std::vector<double>& t,
+                                std::vector<double>& x,
+                                std::vector<double>& y) {
+  x.resize(t.size());
+  y.resize(t.size());
+  std::vector<double> scratch;
+  for (size_t start = 0; start < t.size();
+       start += ExpressionProgram::kBlockSize) {
+    size_t n = std::min(ExpressionProgram::kBlockSize, t.size() - start);
+    // для полярной кривой во второй столбец пишем r, затем переводим в x, y
+    double* columns[2] = {x.data() + start, y.data() + start};
+    if (type == CurveType::Polar) columns[0] = y.data() + start;
+    program.evaluateBlock(t.data() + start, n, columns, scratch);
+    if (type == CurveType::Polar) {
+      for (size_t k = start; k < start + n; ++k) {
+        double r = y[k];
+        x[k] = r * std::cos(t[k]);
+        y[k] = r * std::sin(t[k]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Calculates the length of a segment in pixels.
+ *
+ * @param x1 The x coordinate of the first end.
+ * @param y1 The y coordinate of the first end.
+ * @param x2 The x coordinate of the second end.
+ * @param y2 The y coordinate of the second end.
+ * @param in The input data with the size of a pixel.
+ * @return The length of the segment in pixels (NaN if an end is undefined).
+ */
+double CurveModel::segmentLength(double x1, double y1, double x2, double y2,
+                                 const CurveInput& in) {
+  return std::hypot((x2 - x1) / in.pixelX, (y2 - y1) / in.pixelY);
+}
+
+/**
+ * @brief Checks the input data of a curve.
+ *
+ * @param in The input data.
+ * @throw std::invalid_argument If the input data is invalid.
+ */
+void CurveModel::validateInput(const CurveInput& in) {
+  if (!(in.tRange.first < in.tRange.second) || in.initialPoints == 0 ||
+      !(in.pixelX > 0) || !(in.pixelY > 0) || !(in.maxSegment > 0)) {
+    throw std::invalid_argument("Invalid curve parameters");
+  }
+}
+
+}  // namespace s21
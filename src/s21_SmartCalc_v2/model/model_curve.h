@@ -0,0 +1,73 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file model_curve.h
+ *
+ * @brief Declaration of the CurveModel class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the CurveModel class,
+ * which is part of the SmartCalc v2.0 library.
+ * The CurveModel class calculates parametric (x(t), y(t)) and polar r(θ)
+ * curves with adaptive sampling of the parameter, so that the length of
+ * every segment of the curve stays within a given number of pixels.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_MODEL_CURVE_H
+#define CPP3_S21_SMART_CALC_MODEL_CURVE_H
+
+#include <cmath>      // calculatePolar, segmentLength
+#include <stdexcept>  // validateInput
+#include <string>     // CurveInput
+#include <utility>    // CurveInput
+#include <vector>     // sample
+
+#include "expression_program.h"
+
+namespace s21 {
+
+enum class CurveType { Parametric, Polar };
+
+// входные данные для построения кривой
+// параметр t (или угол θ) записывается в выражениях как x
+struct CurveInput {
+  std::pair<double, double> tRange;  // диапазон параметра
+  String first;                      // x(t) или r(θ)
+  String second;                     // y(t), не используется для r(θ)
+  double pixelX;          // размер пикселя по оси x в единицах графика
+  double pixelY;          // размер пикселя по оси y в единицах графика
+  double maxSegment;      // максимальная длина отрезка в пикселях
+  unsigned initialPoints; // число точек начальной равномерной сетки
+  unsigned maxPoints;     // ограничение на общее число точек
+};
+
+class CurveModel {
+ public:
+  // максимальное число делений каждого начального отрезка пополам
+  static constexpr int kMaxDepth = 20;
+
+  // Main methods:
+  Vector calculateParametric(const CurveInput& in);
+  Vector calculatePolar(const CurveInput& in);
+
+ private:
+  // Auxiliary methods:
+  Vector sample(const ExpressionProgram& program, CurveType type,
+                const CurveInput& in);
+  void evaluatePoints(const ExpressionProgram& program, CurveType type,
+                      const std::vector<double>& t, std::vector<double>& x,
+                      std::vector<double>& y);
+  double segmentLength(double x1, double y1, double x2, double y2,
+                       const CurveInput& in);
+  void validateInput(const CurveInput& in);
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_MODEL_CURVE_H
@@ -22,7 +22,8 @@
 
 namespace s21 {
 
-DepositModel::DepositModel() {}
+template <typename Amount>
+BasicDepositModel<Amount>::BasicDepositModel() {}
 
 /******************************************************************************
  * MAIN METHODS
@@ -35,7 +36,8 @@ DepositModel::DepositModel() {}
  * @param in Input parameters for the deposit calculation.
  * @param out Output parameters to be updated with the calculation results.
  */
-void DepositModel::calculateDeposit(const Input& in, Output& out) {
+template <typename Amount>
+void BasicDepositModel<Amount>::calculateDeposit(const Input& in, Output& out) {
   // инициализация векторов изменений
   ChangeVector additions = in.additions;
   ChangeVector payments = in.payments;
@@ -49,13 +51,18 @@ void DepositModel::calculateDeposit(const Input& in, Output& out) {
   // инициализация выходных данных
   initializeOutput(out, in);
 
-  // цикл по дням от текущего момента до конца срока вклада
+  // цикл по дням от текущего момента до конца срока вклада; номер дня
+  // идёт вместе с моментом времени, календарь считается по номеру
+  std::int32_t day = data.firstDay;
   for (auto current = in.now; current <= data.end;
-       current += std::chrono::hours(24)) {
+       current += std::chrono::hours(24), ++day) {
     // обработка текущего дня
-    processDay(current, data, out, in, additions, payments);
+    processDay(current, day, data, out, in, additions, payments);
   }
 
+  // проценты округляются один раз, от точной суммы начислений
+  out.totalPercents = MoneyTraits<Amount>::convert(data.accrued, in.rounding);
+
   // обновление начальной записи отчета
   updateInitialReportRecord(out, in);
 }
@@ -70,10 +77,11 @@ void DepositModel::calculateDeposit(const Input& in, Output& out) {
  * @param out Output parameters to be initialized.
  * @param in Input parameters for the deposit calculation.
  */
-void DepositModel::initializeOutput(Output& out, const Input& in) {
+template <typename Amount>
+void BasicDepositModel<Amount>::initializeOutput(Output& out, const Input& in) {
   // инициализация выходных данных
-  out.totalPercents = 0;
-  out.totalTax = 0;
+  out.totalPercents = Amount();
+  out.totalTax = Amount();
   out.remainderDeposit = in.deposit;
 }
 
@@ -83,11 +91,13 @@ void DepositModel::initializeOutput(Output& out, const Input& in) {
  * @param out Output parameters to be updated.
  * @param in Input parameters for the deposit calculation.
  */
-void DepositModel::updateInitialReportRecord(Output& out, const Input& in) {
+template <typename Amount>
+void BasicDepositModel<Amount>::updateInitialReportRecord(Output& out,
+                                                          const Input& in) {
   // обновление начальной записи отчета
   if (!out.report.empty()) {
     out.report.front().addition = in.deposit;
-    out.report.front().percents = 0;
+    out.report.front().percents = Amount();
   }
 }
 
@@ -99,24 +109,22 @@ void DepositModel::updateInitialReportRecord(Output& out, const Input& in) {
  * @param additions Vector of addition changes.
  * @param payments Vector of payment changes.
  */
-void DepositModel::initializeCalculationData(CalcData& data,
-                                             const Input& params,
-                                             ChangeVector& additions,
-                                             ChangeVector& payments) {
+template <typename Amount>
+void BasicDepositModel<Amount>::initializeCalculationData(
+    CalcData& data, const Input& params, ChangeVector& additions,
+    ChangeVector& payments) {
   // инициализация данных для расчета
-  auto current = params.now;
-  int totalDays = 0;
+  data.firstDay = toDayNumber(params.now);
+  std::int32_t day = data.firstDay;
 
   // расчет общего количества дней вклада
   for (int i = 0; i < params.monthsTerm; ++i) {
-    int daysInMonth = getDaysInMonthFromDate(current);
-    totalDays += daysInMonth;
     // переход к следующему месяцу
-    current += std::chrono::hours(24 * daysInMonth);
+    day += calendar::daysInMonthOf(day);
   }
 
   // установка конечной даты вклада
-  data.end = params.now + std::chrono::hours(24 * totalDays);
+  data.end = params.now + std::chrono::hours(24 * (day - data.firstDay));
 
   // сортировка записей изменений
   sortChangeRecords(additions);
@@ -128,6 +136,7 @@ void DepositModel::initializeCalculationData(CalcData& data,
   // инициализация начальных значений процентов
   data.percents = 0;
   data.percentsByYear = 0;
+  data.accrued = 0;
 }
 
 /**
@@ -135,7 +144,8 @@ void DepositModel::initializeCalculationData(CalcData& data,
  *
  * @param changes Vector of change records to be sorted.
  */
-void DepositModel::sortChangeRecords(ChangeVector& changes) {
+template <typename Amount>
+void BasicDepositModel<Amount>::sortChangeRecords(ChangeVector& changes) {
   // сортировка записей изменений по дате
   std::sort(changes.begin(), changes.end(),
             [](const Change& a, const Change& b) { return a.date < b.date; });
@@ -147,29 +157,33 @@ void DepositModel::sortChangeRecords(ChangeVector& changes) {
  * @param data Calculation data to be updated.
  * @param params Input parameters for the deposit calculation.
  */
-void DepositModel::initPercentsVector(CalcData& data, const Input& params) {
+template <typename Amount>
+void BasicDepositModel<Amount>::initPercentsVector(CalcData& data,
+                                                   const Input& params) {
   // инициализация вектора дат начисления процентов
   data.percentsDate.clear();
 
   auto current = params.now;
+  std::int32_t day = data.firstDay;
   while (current < data.end) {
+    data.percentsDate.push_back(current);
+    int step = 0;
     switch (params.period) {
       case Period::EveryDay:
-        data.percentsDate.push_back(current);
         // переход к следующему дню
-        current += std::chrono::hours(24);
+        step = 1;
         break;
       case Period::EveryMonth:
-        data.percentsDate.push_back(current);
         // переход к следующему месяцу
-        current += std::chrono::hours(24 * getDaysInMonthFromDate(current));
+        step = calendar::daysInMonthOf(day);
         break;
       case Period::EveryYear:
-        data.percentsDate.push_back(current);
         // переход к следующему году
-        current += std::chrono::hours(24 * 365);
+        step = 365;
         break;
     }
+    current += std::chrono::hours(24 * step);
+    day += step;
   }
 
   // добавление конечной даты в вектор
@@ -184,21 +198,26 @@ void DepositModel::initPercentsVector(CalcData& data, const Input& params) {
  * @brief Processes the current day and updates the calculation data and output.
  *
  * @param current The current date being processed.
+ * @param day The number of the current day since 01.01.1970.
  * @param data Calculation data to be updated.
  * @param out Output parameters to be updated.
  * @param params Input parameters for the deposit calculation.
  * @param additions Vector of addition changes.
  * @param payments Vector of payment changes.
  */
-void DepositModel::processDay(const TimePoint& current, CalcData& data,
-                              Output& out, const Input& params,
-                              ChangeVector& additions, ChangeVector& payments) {
+template <typename Amount>
+void BasicDepositModel<Amount>::processDay(const TimePoint& current,
+                                           std::int32_t day, CalcData& data,
+                                           Output& out,
+                                           const Input& params,
+                                           ChangeVector& additions,
+                                           ChangeVector& payments) {
   // обработка текущего дня
   data.havingRecord = false;
   Report add;
   add.date = current;
-  add.percents = 0;
-  add.addition = 0;
+  add.percents = Amount();
+  add.addition = Amount();
   add.remainder = out.remainderDeposit;
 
   // обработка начисления процентов
@@ -212,7 +231,7 @@ void DepositModel::processDay(const TimePoint& current, CalcData& data,
   addToReport(out, add, data.havingRecord);
 
   // расчет процентов и налогов
-  calculateInterestAndTax(current, data, out, params);
+  calculateInterestAndTax(day, data, out, params);
 }
 
 /**
@@ -225,22 +244,27 @@ void DepositModel::processDay(const TimePoint& current, CalcData& data,
  * @param out Output parameters to be updated.
  * @param params Input parameters for the deposit calculation.
  */
-void DepositModel::processInterest(const TimePoint& current, Report& add,
-                                   CalcData& data, Output& out,
-                                   const Input& params) {
+template <typename Amount>
+void BasicDepositModel<Amount>::processInterest(const TimePoint& current,
+                                                Report& add, CalcData& data,
+                                                Output& out,
+                                                const Input& params) {
   // обработка начисления процентов
   if (!data.percentsDate.empty() && current == data.percentsDate.front()) {
     data.havingRecord = true;
 
+    // выплата округляется, остаток от округления переходит в следующий
+    // период (для double он равен нулю)
+    Amount paid = MoneyTraits<Amount>::convert(data.percents, params.rounding);
     if (params.capitalisation) {
       // обновление записи отчета и остатка вклада при капитализации
-      updateReportRecord(add, data.percents, data.havingRecord);
-      out.remainderDeposit += data.percents;
+      updateReportRecord(add, paid, data.havingRecord);
+      out.remainderDeposit += paid;
     }
 
     // обновление записи отчета
-    add.percents += data.percents;
-    data.percents = 0;
+    add.percents += paid;
+    data.percents -= MoneyTraits<Amount>::toDouble(paid);
     data.percentsDate.erase(data.percentsDate.begin());
   }
 }
@@ -255,9 +279,11 @@ void DepositModel::processInterest(const TimePoint& current, Report& add,
  * @param out Output parameters to be updated.
  * @param additions Vector of addition changes.
  */
-void DepositModel::processAdditions(const TimePoint& current, Report& add,
-                                    CalcData& data, Output& out,
-                                    ChangeVector& additions) {
+template <typename Amount>
+void BasicDepositModel<Amount>::processAdditions(const TimePoint& current,
+                                                 Report& add, CalcData& data,
+                                                 Output& out,
+                                                 ChangeVector& additions) {
   // обработка пополнений
   processChangeRecord(current, add, data, out, additions, true);
 }
@@ -272,9 +298,11 @@ void DepositModel::processAdditions(const TimePoint& current, Report& add,
  * @param out Output parameters to be updated.
  * @param payments Vector of payment changes.
  */
-void DepositModel::processPayments(const TimePoint& current, Report& add,
-                                   CalcData& data, Output& out,
-                                   ChangeVector& payments) {
+template <typename Amount>
+void BasicDepositModel<Amount>::processPayments(const TimePoint& current,
+                                                Report& add, CalcData& data,
+                                                Output& out,
+                                                ChangeVector& payments) {
   // обработка снятий
   processChangeRecord(current, add, data, out, payments, false);
 }
@@ -283,25 +311,30 @@ void DepositModel::processPayments(const TimePoint& current, Report& add,
  * @brief Calculates the interest and tax for the current day
  * and updates the calculation data and output.
  *
- * @param current The current date being processed.
+ * @param day The number of the current day since 01.01.1970.
  * @param data Calculation data to be updated.
  * @param out Output parameters to be updated.
  * @param params Input parameters for the deposit calculation.
  */
-void DepositModel::calculateInterestAndTax(const TimePoint& current,
-                                           CalcData& data, Output& out,
-                                           const Input& params) {
+template <typename Amount>
+void BasicDepositModel<Amount>::calculateInterestAndTax(std::int32_t day,
+                                                        CalcData& data,
+                                                        Output& out,
+                                                        const Input& params) {
   // расчет процентов за день
-  double interest = depositProfitForDay(out.remainderDeposit, params.rate,
-                                        daysInYear(current));
+  double interest = depositProfitForDay(
+      MoneyTraits<Amount>::toDouble(out.remainderDeposit), params.rate,
+      daysInYear(day));
   data.percents += interest;
-  out.totalPercents += interest;
+  data.accrued += interest;
   data.percentsByYear += interest;
 
   // расчет налогов, если текущий день - первый день года
-  if (isFirstDayOfYear(current)) {
-    out.totalTax += calculateTax(&data.percentsByYear, params.taxRate,
-                                 params.maxNonTaxableIncome);
+  if (isFirstDayOfYear(day)) {
+    out.totalTax += MoneyTraits<Amount>::convert(
+        calculateTax(&data.percentsByYear, params.taxRate,
+                     params.maxNonTaxableIncome),
+        params.rounding);
   }
 }
 
@@ -316,8 +349,9 @@ void DepositModel::calculateInterestAndTax(const TimePoint& current,
  * @param add The report record to be added.
  * @param havingRecord Flag indicating if there are changes.
  */
-void DepositModel::addToReport(Output& out, const Report& add,
-                               bool havingRecord) {
+template <typename Amount>
+void BasicDepositModel<Amount>::addToReport(Output& out, const Report& add,
+                                            bool havingRecord) {
   // добавление записи в отчет, если есть изменения
   if (havingRecord) {
     out.report.push_back(add);
@@ -331,8 +365,9 @@ void DepositModel::addToReport(Output& out, const Report& add,
  * @param addition The amount to be added.
  * @param havingRecord Flag indicating if there are changes.
  */
-void DepositModel::updateReportRecord(Report& add, double addition,
-                                      bool& havingRecord) {
+template <typename Amount>
+void BasicDepositModel<Amount>::updateReportRecord(Report& add, Amount addition,
+                                                   bool& havingRecord) {
   // обновление записи отчета
   add.addition += addition;
   add.remainder += addition;
@@ -354,9 +389,12 @@ void DepositModel::updateReportRecord(Report& add, double addition,
  * @param changes Vector of change records.
  * @param isAddition Flag indicating if the change is an addition.
  */
-void DepositModel::processChangeRecord(const TimePoint& current, Report& add,
-                                       CalcData& data, Output& out,
-                                       ChangeVector& changes, bool isAddition) {
+template <typename Amount>
+void BasicDepositModel<Amount>::processChangeRecord(const TimePoint& current,
+                                                    Report& add, CalcData& data,
+                                                    Output& out,
+                                                    ChangeVector& changes,
+                                                    bool isAddition) {
   // обработка записи изменения
   if (hasChanges(changes, current)) {
     if (isValidChange(changes.front(), isAddition, out.remainderDeposit)) {
@@ -376,8 +414,9 @@ void DepositModel::processChangeRecord(const TimePoint& current, Report& add,
  * @param current The current date being processed.
  * @return True if there are changes for the current date, false otherwise.
  */
-bool DepositModel::hasChanges(const ChangeVector& changes,
-                              const TimePoint& current) {
+template <typename Amount>
+bool BasicDepositModel<Amount>::hasChanges(const ChangeVector& changes,
+                                           const TimePoint& current) {
   // проверка наличия изменений на текущую дату
   return !changes.empty() && current == changes.front().date;
 }
@@ -390,11 +429,13 @@ bool DepositModel::hasChanges(const ChangeVector& changes,
  * @param remainderDeposit The current remainder of the deposit.
  * @return True if the change record is valid, false otherwise.
  */
-bool DepositModel::isValidChange(const Change& change, bool isAddition,
-                                 double remainderDeposit) {
+template <typename Amount>
+bool BasicDepositModel<Amount>::isValidChange(const Change& change,
+                                              bool isAddition,
+                                              Amount remainderDeposit) {
   // проверка корректности записи изменения
-  return (isAddition && change.sum > 0) ||
-         (!isAddition && remainderDeposit - change.sum >= 0);
+  return (isAddition && change.sum > Amount()) ||
+         (!isAddition && remainderDeposit - change.sum >= Amount());
 }
 
 /**
@@ -407,10 +448,13 @@ bool DepositModel::isValidChange(const Change& change, bool isAddition,
  * @param changes Vector of change records.
  * @param isAddition Flag indicating if the change is an addition.
  */
-void DepositModel::processValidChange(Report& add, CalcData& data, Output& out,
-                                      ChangeVector& changes, bool isAddition) {
+template <typename Amount>
+void BasicDepositModel<Amount>::processValidChange(Report& add, CalcData& data,
+                                                   Output& out,
+                                                   ChangeVector& changes,
+                                                   bool isAddition) {
   // обработка корректной записи изменения (пополнение или снятие средств)
-  double changeSum = isAddition ? changes.front().sum : -changes.front().sum;
+  Amount changeSum = isAddition ? changes.front().sum : -changes.front().sum;
   updateReportRecord(add, changeSum, data.havingRecord);
   out.remainderDeposit += changeSum;
   changes.erase(changes.begin());
@@ -422,8 +466,9 @@ void DepositModel::processValidChange(Report& add, CalcData& data, Output& out,
  * @param changes Vector of change records.
  * @param isAddition Flag indicating if the change is an addition.
  */
-void DepositModel::processInvalidChange(ChangeVector& changes,
-                                        bool isAddition) {
+template <typename Amount>
+void BasicDepositModel<Amount>::processInvalidChange(ChangeVector& changes,
+                                                     bool isAddition) {
   // обработка некорректной записи изменения
   std::cerr << (isAddition ? "Error: Addition sum must be positive."
                            : "Error: Insufficient funds for payment.")
@@ -443,8 +488,10 @@ void DepositModel::processInvalidChange(ChangeVector& changes,
  * @param days_in_year The number of days in the year.
  * @return The deposit profit for the day.
  */
-double DepositModel::depositProfitForDay(double deposit, double rate,
-                                         int days_in_year) {
+template <typename Amount>
+double BasicDepositModel<Amount>::depositProfitForDay(double deposit,
+                                                      double rate,
+                                                      int days_in_year) {
   // расчет дохода за день
   return (deposit * rate / days_in_year) / 100;
 }
@@ -457,8 +504,9 @@ double DepositModel::depositProfitForDay(double deposit, double rate,
  * @param maxNonTaxableIncome The maximum non-taxable income.
  * @return The calculated tax.
  */
-double DepositModel::calculateTax(double* sum, double rate,
-                                  double maxNonTaxableIncome) {
+template <typename Amount>
+double BasicDepositModel<Amount>::calculateTax(double* sum, double rate,
+                                               double maxNonTaxableIncome) {
   // расчет налога
   double border = maxNonTaxableIncome * rate;
   double res = 0;
@@ -470,104 +518,50 @@ double DepositModel::calculateTax(double* sum, double rate,
 }
 
 /**
- * @brief Determines the number of days in the year for the given date.
+ * @brief Determines the number of days in the year of the given day.
  *
- * @param date The date for which the number
- * of days in the year is to be determined.
+ * @param day The number of the day since 01.01.1970.
  * @return The number of days in the year.
  */
-int DepositModel::daysInYear(const TimePoint& date) {
+template <typename Amount>
+int BasicDepositModel<Amount>::daysInYear(std::int32_t day) {
   // определение количества дней в году
-  auto timeinfo = convertToTm(date);
-  int year = timeinfo->tm_year + 1900;
-  if (isLeapYear(year)) {
-    return 366;
-  } else {
-    return 365;
-  }
+  return calendar::daysInYear(calendar::civilFromDays(day).year);
 }
 
 /**
- * @brief Checks if the given date is the first day of the year.
+ * @brief Checks if the given day is the first day of the year.
  *
- * @param date The date to be checked.
- * @return True if the date is the first day of the year, false otherwise.
+ * @param day The number of the day since 01.01.1970.
+ * @return True if the day is the first day of the year, false otherwise.
  */
-bool DepositModel::isFirstDayOfYear(const TimePoint& date) {
+template <typename Amount>
+bool BasicDepositModel<Amount>::isFirstDayOfYear(std::int32_t day) {
   // проверка, является ли дата первым днем года
-  auto timeinfo = convertToTm(date);
-  return timeinfo->tm_mon == 0 && timeinfo->tm_mday == 1;
-}
-
-/**
- * @brief Determines the number of days in the given month and year.
- *
- * @param month The month for which the number of days is to be determined.
- * @param year The year for which the number of days is to be determined.
- * @return The number of days in the month.
- */
-int DepositModel::getDaysInMonth(int month, int year) {
-  // определение количества дней в месяце
-  switch (month) {
-    case JANUARY:
-    case MARCH:
-    case MAY:
-    case JULY:
-    case AUGUST:
-    case OCTOBER:
-    case DECEMBER:
-      return 31;
-    case APRIL:
-    case JUNE:
-    case SEPTEMBER:
-    case NOVEMBER:
-      return 30;
-    case FEBRUARY:
-      return isLeapYear(year) ? 29 : 28;
-    default:
-      return UNKNOWN;
-  }
+  calendar::Date date = calendar::civilFromDays(day);
+  return date.month == 1 && date.day == 1;
 }
 
 /**
- * @brief Checks if the given year is a leap year.
+ * @brief Converts a moment of time to the number of its local day.
  *
- * @param year The year to be checked.
- * @return True if the year is a leap year, false otherwise.
- */
-bool DepositModel::isLeapYear(int year) {
-  // проверка, является ли год високосным
-  return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0));
-}
-
-/**
- * @brief Converts the given date to a tm structure.
+ * The local time zone is read once per calculation with
+ * calendar::localDate; the following days are counted by the calendar.
  *
- * @param date The date to be converted.
- * @return A pointer to the tm structure representing the date.
+ * @param date The moment of time.
+ * @return The number of the local day since 01.01.1970.
+ * @throw std::runtime_error If the time cannot be converted.
  */
-std::tm* DepositModel::convertToTm(const TimePoint& date) {
-  // преобразование даты в структуру tm
-  auto time_t_date = std::chrono::system_clock::to_time_t(date);
-  return std::localtime(&time_t_date);
+template <typename Amount>
+std::int32_t BasicDepositModel<Amount>::toDayNumber(const TimePoint& date) {
+  // преобразование даты в номер дня по местному времени
+  calendar::Date local =
+      calendar::localDate(std::chrono::system_clock::to_time_t(date));
+  return calendar::daysFromCivil(local.year, local.month, local.day);
 }
 
-/**
- * @brief Determines the number of days in the month for the given date.
- *
- * @param date The date for which the number of days
- * in the month is to be determined.
- * @return The number of days in the month.
- */
-int DepositModel::getDaysInMonthFromDate(const TimePoint& date) {
-  // определение количества дней от заданной даты
-  // до той же даты следующего месяца
-  auto timeinfo = convertToTm(date);
-
-  // месяцы в tm_mon начинаются с 0
-  int month = timeinfo->tm_mon + 1;
-  int year = timeinfo->tm_year + 1900;
-  return getDaysInMonth(month, year);
-}
+// денежные типы вклада
+template class BasicDepositModel<double>;
+template class BasicDepositModel<Money>;
 
 }  // namespace s21
@@ -26,50 +26,41 @@
 #include <algorithm>  // sortChangeRecords
 #include <chrono>     // calculateDeposit, processDay, initPercentsVector
 #include <cmath>      // depositProfitForDay
-#include <ctime>      // daysInYear, isFirstDayOfYear, convertToTm
+#include <cstdint>    // CalcData, toDayNumber
+#include <ctime>      // toDayNumber
 #include <vector>     // sortChangeRecords, processChangeRecord
 
+#include "calendar.h"
+#include "money.h"
+
 namespace s21 {
 
 using TimePoint = std::chrono::system_clock::time_point;
 
-enum Month {
-  UNKNOWN,
-  JANUARY,
-  FEBRUARY,
-  MARCH,
-  APRIL,
-  MAY,
-  JUNE,
-  JULY,
-  AUGUST,
-  SEPTEMBER,
-  OCTOBER,
-  NOVEMBER,
-  DECEMBER
-};
-
-// добавление или снятие средств
-struct Change {
+// добавление или снятие средств в денежном типе Amount (double или Money)
+template <typename Amount>
+struct BasicChange {
   TimePoint date;  // дата изменения
-  double sum;      // сумма изменения
+  Amount sum;      // сумма изменения
 };
 
 // запись отчета о состоянии депозита
-struct Report {
+template <typename Amount>
+struct BasicReport {
   TimePoint date;    // дата отчета
-  double percents;   // проценты
-  double addition;   // добавление
-  double remainder;  // остаток
+  Amount percents;   // проценты
+  Amount addition;   // добавление
+  Amount remainder;  // остаток
 };
 
 enum class Period { EveryDay, EveryMonth, EveryYear };
 
 // изначальные входные данные
-struct Input {
-  using ChangeVector = std::vector<Change>;
+template <typename Amount>
+struct BasicInput {
+  using ChangeVector = std::vector<BasicChange<Amount>>;
 
-  double deposit;              // сумма вклада
+  Amount deposit;              // сумма вклада
   double rate;                 // годовая процентная ставка по вкладу
   double taxRate;              // ставка центрального банка
   int monthsTerm;              // срок (в месяцах) размещения вклада
@@ -79,35 +70,51 @@ struct Input {
   ChangeVector payments;       // массив частичных снятий вклада
   TimePoint now;               // дата начала вклада
   double maxNonTaxableIncome;  // максимальный доход, не облагаемый налогом НДФЛ
+  Rounding rounding = Rounding::HalfAwayFromZero;  // округление сумм Money
 };
 
 // выходные данные - резульраты расчётов
-struct Output {
-  std::vector<Report> report;  // отчет
-  double totalPercents;        // общие проценты
-  double totalTax;             // общий налог
-  double remainderDeposit;     // остаток депозита
+template <typename Amount>
+struct BasicOutput {
+  std::vector<BasicReport<Amount>> report;  // отчет
+  Amount totalPercents;                     // общие проценты
+  Amount totalTax;                          // общий налог
+  Amount remainderDeposit;                  // остаток депозита
 };
 
+using Change = BasicChange<double>;
+using Report = BasicReport<double>;
+using Input = BasicInput<double>;
+using Output = BasicOutput<double>;
+
 // данные для расчетов
 struct CalcData {
   using TimePointVector = std::vector<TimePoint>;
 
   TimePointVector percentsDate;  // даты начисления процентов
   TimePoint end;                 // дата окончания вклада
+  std::int32_t firstDay;         // номер дня начала вклада (от 01.01.1970)
   bool havingRecord;             // флаг наличия записи
-  double percents;               // проценты
+  double percents;               // проценты, ещё не выплаченные
   double percentsByYear;         // проценты за год
+  double accrued;                // все начисленные проценты без округления
 };
 
-class DepositModel {
+// расчёт вклада; с Money все суммы - целые копейки, проценты
+// начисляются точно и округляются при выплате
+template <typename Amount>
+class BasicDepositModel {
  public:
+  using Change = BasicChange<Amount>;
+  using Report = BasicReport<Amount>;
+  using Input = BasicInput<Amount>;
+  using Output = BasicOutput<Amount>;
   using ChangeVector = std::vector<Change>;
   using ReportVector = std::vector<Report>;
   using TimePoint = std::chrono::system_clock::time_point;
   using TimePointVector = std::vector<TimePoint>;
 
-  DepositModel();
+  BasicDepositModel();
 
   // основной метод
   void calculateDeposit(const Input& in, Output& out);
@@ -123,8 +130,8 @@ class DepositModel {
   void initPercentsVector(CalcData& data, const Input& params);
 
   // обработка дней и изменений
-  void processDay(const TimePoint& current, CalcData& data, Output& out,
-                  const Input& params, ChangeVector& additions,
+  void processDay(const TimePoint& current, std::int32_t day, CalcData& data,
+                  Output& out, const Input& params, ChangeVector& additions,
                   ChangeVector& payments);
   void processInterest(const TimePoint& current, Report& add, CalcData& data,
                        Output& out, const Input& params);
@@ -132,12 +139,12 @@ class DepositModel {
                         Output& out, ChangeVector& additions);
   void processPayments(const TimePoint& current, Report& add, CalcData& data,
                        Output& out, ChangeVector& payments);
-  void calculateInterestAndTax(const TimePoint& current, CalcData& data,
-                               Output& out, const Input& params);
+  void calculateInterestAndTax(std::int32_t day, CalcData& data, Output& out,
+                               const Input& params);
 
   // обновление отчета
   void addToReport(Output& out, const Report& add, bool havingRecord);
-  void updateReportRecord(Report& add, double addition, bool& havingRecord);
+  void updateReportRecord(Report& add, Amount addition, bool& havingRecord);
 
   // обработка изменений вклада
   void processChangeRecord(const TimePoint& current, Report& add,
@@ -145,7 +152,7 @@ class DepositModel {
                            bool isAddition);
   bool hasChanges(const ChangeVector& changes, const TimePoint& current);
   bool isValidChange(const Change& change, bool isAddition,
-                     double remainderDeposit);
+                     Amount remainderDeposit);
   void processValidChange(Report& add, CalcData& data, Output& out,
                           ChangeVector& changes, bool isAddition);
   void processInvalidChange(ChangeVector& changes, bool isAddition);
@@ -153,14 +160,13 @@ class DepositModel {
   // вспомогательные методы
   double depositProfitForDay(double deposit, double rate, int days_in_year);
   double calculateTax(double* sum, double rate, double maxNonTaxableIncome);
-  int daysInYear(const TimePoint& date);
-  bool isFirstDayOfYear(const TimePoint& date);
-  int getDaysInMonth(int month, int year);
-  bool isLeapYear(int year);
-  std::tm* convertToTm(const TimePoint& date);
-  int getDaysInMonthFromDate(const TimePoint& date);
+  int daysInYear(std::int32_t day);
+  bool isFirstDayOfYear(std::int32_t day);
+  std::int32_t toDayNumber(const TimePoint& date);
 };
 
+using DepositModel = BasicDepositModel<double>;
+
 }  // namespace s21
 
 #endif  // CPP3_S21_SMART_CALC_MODEL_DEPOSIT_H
@@ -0,0 +1,322 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file money.h
+ *
+ * @brief Declaration and implementation of the Money class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the Money class, which is part of the SmartCalc v2.0
+ * library. Money keeps an amount as a 64-bit number of minor units
+ * (kopecks), so sums and differences are exact and the same on every
+ * platform, and an overflow throws instead of wrapping around; every
+ * conversion from double names its rounding mode.
+ * MoneyTraits lets the credit and deposit models run on double or on Money
+ * with the same code.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_MONEY_H
+#define CPP3_S21_SMART_CALC_MONEY_H
+
+#include <cmath>      // std::round, std::floor, std::ceil, std::trunc
+#include <cstdint>    // int64_t
+#include <stdexcept>  // std::invalid_argument
+
+namespace s21 {
+
+// способ округления до целого числа минимальных единиц
+enum class Rounding {
+  HalfAwayFromZero,  // половина - от нуля (как std::round)
+  HalfEven,          // половина - к чётному (банковское)
+  TowardZero,        // отбрасывание дробной части
+  AwayFromZero,      // любая дробная часть - от нуля
+  Down,              // к минус бесконечности
+  Up                 // к плюс бесконечности
+};
+
+/**
+ * @brief Rounds a double to an integer value.
+ *
+ * @param value The value.
+ * @param rounding The rounding mode.
+ * @return The rounded value.
+ */
+inline double roundValue(double value, Rounding rounding) {
+  switch (rounding) {
+    case Rounding::HalfEven: {
+      double rounded = std::round(value);
+      // ровно половина: из двух соседних целых берётся чётное
+      if (std::fabs(value - std::trunc(value)) == 0.5) {
+        rounded = 2 * std::round(value / 2);
+      }
+      return rounded;
+    }
+    case Rounding::TowardZero:
+      return std::trunc(value);
+    case Rounding::AwayFromZero:
+      return value < 0 ? std::floor(value) : std::ceil(value);
+    case Rounding::Down:
+      return std::floor(value);
+    case Rounding::Up:
+      return std::ceil(value);
+    default:
+      return std::round(value);
+  }
+}
+
+/**
+ * @brief Divides integers, rounding the quotient.
+ *
+ * @param dividend The dividend.
+ * @param divisor The divisor (not zero).
+ * @param rounding The rounding mode.
+ * @return The rounded quotient.
+ */
+inline std::int64_t divideRounded(std::int64_t dividend, std::int64_t divisor,
+                                  Rounding rounding) {
+  std::int64_t quotient = dividend / divisor, remainder = dividend % divisor;
+  if (remainder == 0) return quotient;
+  bool negative = (dividend < 0) != (divisor < 0);
+  std::int64_t away = negative ? -1 : 1;
+  // сравнение остатка с половиной делителя без переполнения
+  std::int64_t rest = remainder < 0 ? -remainder : remainder;
+  std::int64_t half = (divisor < 0 ? -divisor : divisor) - rest;
+  switch (rounding) {
+    case Rounding::HalfEven:
+      return rest > half || (rest == half && quotient % 2 != 0)
+                 ? quotient + away
+                 : quotient;
+    case Rounding::TowardZero:
+      return quotient;
+    case Rounding::AwayFromZero:
+      return quotient + away;
+    case Rounding::Down:
+      return negative ? quotient - 1 : quotient;
+    case Rounding::Up:
+      return negative ? quotient : quotient + 1;
+    default:
+      return rest >= half ? quotient + away : quotient;
+  }
+}
+
+class Money {
+ public:
+  // минимальных единиц (копеек) в основной
+  static constexpr std::int64_t kScale = 100;
+
+  constexpr Money() = default;
+
+  // Main methods:
+  static constexpr Money fromMinor(std::int64_t minor) { return Money(minor); }
+  static Money fromDouble(double value,
+                          Rounding rounding = Rounding::HalfAwayFromZero);
+
+  Money scale(double factor,
+              Rounding rounding = Rounding::HalfAwayFromZero) const;
+  Money divide(std::int64_t divisor,
+               Rounding rounding = Rounding::HalfAwayFromZero) const;
+
+  // Accessors:
+  constexpr std::int64_t minor() const { return minor_; }
+  constexpr double toDouble() const {
+    return static_cast<double>(minor_) / kScale;
+  }
+
+  // Operators:
+  Money operator+(Money other) const;
+  Money operator-(Money other) const;
+  Money operator-() const;
+  Money operator*(std::int64_t n) const;
+  Money& operator+=(Money other) { return *this = *this + other; }
+  Money& operator-=(Money other) { return *this = *this - other; }
+  constexpr bool operator==(Money other) const {
+    return minor_ == other.minor_;
+  }
+  constexpr bool operator!=(Money other) const {
+    return minor_ != other.minor_;
+  }
+  constexpr bool operator<(Money other) const { return minor_ < other.minor_; }
+  constexpr bool operator<=(Money other) const {
+    return minor_ <= other.minor_;
+  }
+  constexpr bool operator>(Money other) const { return minor_ > other.minor_; }
+  constexpr bool operator>=(Money other) const {
+    return minor_ >= other.minor_;
+  }
+
+ private:
+  explicit constexpr Money(std::int64_t minor) : minor_(minor) {}
+
+  // Auxiliary methods:
+  static Money fromMinorValue(double minor);
+  static Money fromChecked(bool overflow, std::int64_t minor);
+
+  std::int64_t minor_ = 0;  // сумма в минимальных единицах
+};
+
+/**
+ * @brief Converts an amount in major units (roubles) to Money.
+ *
+ * The value is multiplied by kScale and rounded, the same as
+ * round(value * 100) / 100 for doubles.
+ *
+ * @param value The amount.
+ * @param rounding The rounding mode.
+ * @return The amount in minor units.
+ * @throw std::invalid_argument If the amount is not finite or too large.
+ */
+inline Money Money::fromDouble(double value, Rounding rounding) {
+  return fromMinorValue(roundValue(value * kScale, rounding));
+}
+
+/**
+ * @brief Multiplies the amount by a factor (a rate, a share).
+ *
+ * @param factor The factor.
+ * @param rounding The rounding mode of the product.
+ * @return The product in minor units.
+ * @throw std::invalid_argument If the product is too large.
+ */
+inline Money Money::scale(double factor, Rounding rounding) const {
+  return fromMinorValue(
+      roundValue(static_cast<double>(minor_) * factor, rounding));
+}
+
+/**
+ * @brief Divides the amount exactly in integers.
+ *
+ * @param divisor The divisor.
+ * @param rounding The rounding mode of the quotient.
+ * @return The quotient in minor units.
+ * @throw std::invalid_argument If the divisor is zero.
+ */
+inline Money Money::divide(std::int64_t divisor, Rounding rounding) const {
+  if (divisor == 0) {
+    throw std::invalid_argument("Division of money by zero");
+  }
+  return Money(divideRounded(minor_, divisor, rounding));
+}
+
+/**
+ * @brief Converts a rounded number of minor units to Money.
+ *
+ * @param minor The number of minor units, an integer value.
+ * @return The amount.
+ * @throw std::invalid_argument If the value does not fit into 64 bits.
+ */
+inline Money Money::fromMinorValue(double minor) {
+  // 2^63: первое значение, не помещающееся в int64_t
+  if (!(std::fabs(minor) < 9223372036854775808.0)) {
+    throw std::invalid_argument("Amount of money is out of range");
+  }
+  return Money(static_cast<std::int64_t>(minor));
+}
+
+/**
+ * @brief Adds two amounts.
+ *
+ * @param other The second amount.
+ * @return The sum.
+ * @throw std::invalid_argument If the sum does not fit into 64 bits.
+ */
+inline Money Money::operator+(Money other) const {
+  std::int64_t sum = 0;
+  bool overflow = __builtin_add_overflow(minor_, other.minor_, &sum);
+  return fromChecked(overflow, sum);
+}
+
+/**
+ * @brief Subtracts an amount.
+ *
+ * @param other The amount to subtract.
+ * @return The difference.
+ * @throw std::invalid_argument If the difference does not fit into 64 bits.
+ */
+inline Money Money::operator-(Money other) const {
+  std::int64_t difference = 0;
+  bool overflow = __builtin_sub_overflow(minor_, other.minor_, &difference);
+  return fromChecked(overflow, difference);
+}
+
+/**
+ * @brief Negates the amount.
+ *
+ * @return The amount with the opposite sign.
+ * @throw std::invalid_argument If the amount is the smallest 64-bit value.
+ */
+inline Money Money::operator-() const { return Money() - *this; }
+
+/**
+ * @brief Multiplies the amount by an integer.
+ *
+ * @param n The multiplier.
+ * @return The product.
+ * @throw std::invalid_argument If the product does not fit into 64 bits.
+ */
+inline Money Money::operator*(std::int64_t n) const {
+  std::int64_t product = 0;
+  bool overflow = __builtin_mul_overflow(minor_, n, &product);
+  return fromChecked(overflow, product);
+}
+
+/**
+ * @brief Returns the result of an integer operation unless it overflowed.
+ *
+ * @param overflow True if the operation overflowed.
+ * @param minor The result in minor units.
+ * @return The amount.
+ * @throw std::invalid_argument If the operation overflowed.
+ */
+inline Money Money::fromChecked(bool overflow, std::int64_t minor) {
+  if (overflow) {
+    throw std::invalid_argument("Amount of money is out of range");
+  }
+  return Money(minor);
+}
+
+// операции моделей над суммами: double хранит значения как есть,
+// Money округляет каждое значение до копеек
+template <typename Amount>
+struct MoneyTraits;
+
+template <>
+struct MoneyTraits<double> {
+  static double convert(double value, Rounding) { return value; }
+  static double round(double value, Rounding rounding) {
+    return roundValue(value * Money::kScale, rounding) / Money::kScale;
+  }
+  static double scale(double amount, double factor, Rounding) {
+    return amount * factor;
+  }
+  static double divide(double amount, int divisor, Rounding) {
+    return amount / divisor;
+  }
+  static double toDouble(double amount) { return amount; }
+};
+
+template <>
+struct MoneyTraits<Money> {
+  static Money convert(double value, Rounding rounding) {
+    return Money::fromDouble(value, rounding);
+  }
+  static Money round(double value, Rounding rounding) {
+    return Money::fromDouble(value, rounding);
+  }
+  static Money scale(Money amount, double factor, Rounding rounding) {
+    return amount.scale(factor, rounding);
+  }
+  static Money divide(Money amount, int divisor, Rounding rounding) {
+    return amount.divide(divisor, rounding);
+  }
+  static double toDouble(Money amount) { return amount.toDouble(); }
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_MONEY_H
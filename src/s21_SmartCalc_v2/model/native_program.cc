@@ -0,0 +1,486 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file native_program.cc
+ *
+ * @brief Implementation of the NativeProgram class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the NativeProgram class,
+ * which is part of the SmartCalc v2.0 library.
+ * The NativeProgram class lowers a compiled ExpressionProgram to a C++
+ * translation unit, builds it with the installed compiler into a shared
+ * object and loads it with dlopen. Built objects are cached in a private
+ * directory of the user by the hash of their source, build command and
+ * host CPU.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "native_program.h"
+
+#include <dlfcn.h>        // dlopen, dlsym, dlclose
+#include <fcntl.h>        // O_WRONLY, O_CREAT, O_TRUNC
+#include <spawn.h>        // posix_spawnp
+#include <sys/stat.h>     // mkdir, lstat, chmod
+#include <sys/utsname.h>  // uname
+#include <sys/wait.h>     // waitpid
+#include <unistd.h>       // getpid, geteuid
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>  // __get_cpuid
+#endif
+
+#include <atomic>      // buildLibrary
+#include <cerrno>      // errno
+
+#include <cmath>       // std::isnan, std::isinf
+#include <cstdio>      // std::rename
+#include <cstdlib>     // std::getenv
+#include <filesystem>  // create_directories
+#include <fstream>     // buildLibrary
+#include <iomanip>     // std::hexfloat
+#include <sstream>     // generateSource, buildLibrary
+
+namespace s21 {
+
+namespace {
+
+// имя функции в сгенерированной библиотеке
+const char kKernelName[] = "s21_native_evaluate";
+
+// флаг, добавляемый к любым флагам сборки: без слияния в FMA
+const char kStrictFlag[] = "-ffp-contract=off";
+
+extern "C" char** environ;
+
+}  // namespace
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Unloads the shared object.
+ */
+NativeProgram::~NativeProgram() {
+  if (handle_ != nullptr) {
+    dlclose(handle_);
+  }
+}
+
+/**
+ * @brief Builds (or takes from the cache) and loads native code
+ * for a compiled program.
+ *
+ * @param program The compiled program.
+ * @param options The compiler, its flags and the cache directory.
+ * @return The loaded native program.
+ * @throw std::runtime_error If the code cannot be built or loaded.
+ */
+std::shared_ptr<NativeProgram> NativeProgram::compile(
+    const ExpressionProgram& program, const NativeOptions& options) {
+  std::string library = buildLibrary(generateSource(program), options);
+
+  std::shared_ptr<NativeProgram> native(new NativeProgram());
+  native->library_ = library;
+  native->outputs_ = program.outputCount();
+  native->handle_ = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (native->handle_ == nullptr) {
+    throw std::runtime_error(std::string("Cannot load native code: ") +
+                             dlerror());
+  }
+  native->kernel_ =
+      reinterpret_cast<Kernel>(dlsym(native->handle_, kKernelName));
+  if (native->kernel_ == nullptr) {
+    throw std::runtime_error("Native code has no entry point: " + library);
+  }
+  return native;
+}
+
+/**
+ * @brief Lowers a compiled program to a C++ translation unit.
+ *
+ * Every instruction becomes a local constant inside a loop over the points,
+ * so the compiler sees straight-line code it can schedule and vectorize.
+ * Invalid operations produce NaN exactly like the interpreter does.
+ *
+ * @param program The compiled program.
+ * @return The source code of the translation unit.
+ */
+std::string NativeProgram::generateSource(const ExpressionProgram& program) {
+  std::ostringstream src;
+  src << "// сгенерировано SmartCalc v2.0\n"
+         "#include <cmath>\n#include <cstddef>\n#include <limits>\n\n"
+         "// степень так же, как ExpressionProgram::power\n"
+         "static inline double s21_pow(double a, double b) {\n"
+         "  if (!(b >= 0.0 && b <= "
+      << ExpressionProgram::kMaxPower
+      << ".0 && b == std::floor(b))) return std::pow(a, b);\n"
+         "  unsigned n = static_cast<unsigned>(b);\n"
+         "  double r = 1.0;\n"
+         "  while (n != 0) {\n"
+         "    if (n & 1u) r *= a;\n"
+         "    n >>= 1;\n"
+         "    if (n != 0) a *= a;\n"
+         "  }\n"
+         "  return r;\n"
+         "}\n\n"
+      << "extern \"C\" void " << kKernelName
+      << "(const double* __restrict xs, std::size_t n, "
+         "double* const* out) {\n"
+         "  const double nan = std::numeric_limits<double>::quiet_NaN();\n";
+  for (std::size_t j = 0; j < program.outputCount(); ++j) {
+    src << "  double* __restrict o" << j << " = out[" << j << "];\n";
+  }
+  src << "  for (std::size_t k = 0; k < n; ++k) {\n"
+         "    const double x = xs[k];\n";
+
+  const InstructionVector& code = program.instructions();
+  for (std::size_t i = 0; i < code.size(); ++i) {
+    const Instruction& in = code[i];
+    std::string a = "v" + std::to_string(in.lhs);
+    std::string b = "v" + std::to_string(in.rhs);
+    src << "    const double v" << i << " = ";
+    switch (in.op) {
+      case OP_CONST:
+        src << constantLiteral(in.value);
+        break;
+      case OP_X:
+        src << "x";
+        break;
+      case OP_ADD:
+        src << a << " + " << b;
+        break;
+      case OP_SUB:
+        src << a << " - " << b;
+        break;
+      case OP_MUL:
+        src << a << " * " << b;
+        break;
+      case OP_DIV:
+        src << b << " == 0.0 ? nan : " << a << " / " << b;
+        break;
+      case OP_MOD:
+        src << b << " == 0.0 ? nan : std::fmod(" << a << ", " << b << ")";
+        break;
+      case OP_SQRT:
+        src << a << " < 0.0 ? nan : std::sqrt(" << a << ")";
+        break;
+      case OP_LN:
+        src << a << " <= 0.0 ? nan : std::log(" << a << ")";
+        break;
+      case OP_LOG:
+        src << a << " <= 0.0 ? nan : std::log10(" << a << ")";
+        break;
+      case OP_NEG:
+        src << "-" << a;
+        break;
+      case OP_POW:
+        src << "s21_pow(" << a << ", " << b << ")";
+        break;
+      default:
+        src << functionName(in.op) << "(" << a << ")";
+    }
+    src << ";\n";
+  }
+  for (std::size_t j = 0; j < program.outputCount(); ++j) {
+    src << "    o" << j << "[k] = v" << program.outputs()[j] << ";\n";
+  }
+  src << "  }\n}\n";
+  return src.str();
+}
+
+/**
+ * @brief Evaluates all outputs of the program for the given x values.
+ *
+ * @param x Pointer to the x values.
+ * @param n The number of values (any).
+ * @param columns Array of outputCount() pointers to the output columns.
+ */
+void NativeProgram::evaluate(const double* x, std::size_t n,
+                             double* const* columns) const {
+  kernel_(x, n, columns);
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Builds a shared object from the source unless it is already cached.
+ *
+ * The cache is a private directory of the user, and a cached object is
+ * used only if it is a regular file of the user that nobody else can
+ * write, otherwise it is rebuilt. The source and the object are first
+ * written under names unique for the process and the call and then
+ * renamed, so concurrent builders never see half-written files. The name
+ * of the object hashes the source, the build command and the host CPU,
+ * so objects built with -march=native are never loaded on another CPU.
+ * The compiler is run without a shell, always with -ffp-contract=off.
+ *
+ * @param source The source code of the translation unit.
+ * @param options The compiler, its flags and the cache directory.
+ * @return The path of the shared object.
+ * @throw std::runtime_error If the cache is not private, the source cannot
+ * be written or the compiler fails.
+ */
+std::string NativeProgram::buildLibrary(const std::string& source,
+                                        const NativeOptions& options) {
+  std::string compiler = options.compiler;
+  if (compiler.empty()) {
+    const char* env = std::getenv("CXX");
+    compiler = env != nullptr ? env : "c++";
+  }
+  std::string dir = cacheDirectory(options);
+
+  // команда собирается как список аргументов: пути и флаги не проходят
+  // через оболочку, поэтому кавычки и спецсимволы в них безопасны
+  std::vector<std::string> arguments;
+  std::istringstream words(compiler + ' ' + options.flags);
+  for (std::string word; words >> word;) arguments.push_back(word);
+  arguments.push_back(kStrictFlag);
+
+  // в хэш входят исходный код, команда сборки и процессор
+  std::string command;
+  for (const std::string& argument : arguments) command += argument + ' ';
+  std::ostringstream name;
+  name << std::hex << sourceHash(source + '\n' + command + '\n' +
+                                 hostIdentity());
+  std::string base = dir + "/s21_" + name.str();
+  std::string library = base + ".so";
+  if (isPrivateFile(library)) {
+    return library;
+  }
+
+  // временные имена различаются и между процессами, и между потоками
+  static std::atomic<unsigned> builds{0};
+  std::string tmp = base + "." + std::to_string(getpid()) + "." +
+                    std::to_string(builds++) + ".tmp";
+  std::ofstream file(tmp + ".cc");
+  file << source;
+  file.close();
+  if (!file) {
+    std::remove((tmp + ".cc").c_str());
+    throw std::runtime_error("Cannot write native source: " + tmp + ".cc");
+  }
+
+  arguments.insert(arguments.end(), {"-o", tmp + ".so", tmp + ".cc"});
+  if (runCompiler(arguments, tmp + ".log") != 0) {
+    std::ifstream log(tmp + ".log");
+    std::string message((std::istreambuf_iterator<char>(log)),
+                        std::istreambuf_iterator<char>());
+    std::remove((tmp + ".log").c_str());
+    std::remove((tmp + ".cc").c_str());
+    std::remove((tmp + ".so").c_str());
+    throw std::runtime_error("Native build failed: " + command + "\n" +
+                             message);
+  }
+  std::remove((tmp + ".log").c_str());
+  std::rename((tmp + ".cc").c_str(), (base + ".cc").c_str());
+  if (std::rename((tmp + ".so").c_str(), library.c_str()) != 0 ||
+      !isPrivateFile(library)) {
+    throw std::runtime_error("Cannot store native code: " + library);
+  }
+  return library;
+}
+
+/**
+ * @brief Runs the compiler without a shell and waits for it.
+ *
+ * The standard error of the compiler is written to the log file.
+ *
+ * @param arguments The program (searched in PATH) and its arguments.
+ * @param log The path of the log file.
+ * @return The exit status of the compiler, -1 if it could not be run.
+ */
+int NativeProgram::runCompiler(const std::vector<std::string>& arguments,
+                               const std::string& log) {
+  std::vector<char*> argv;
+  for (const std::string& argument : arguments) {
+    argv.push_back(const_cast<char*>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  posix_spawn_file_actions_t actions;
+  if (posix_spawn_file_actions_init(&actions) != 0) return -1;
+  pid_t pid = 0;
+  int code = posix_spawn_file_actions_addopen(
+      &actions, STDERR_FILENO, log.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+      0600);
+  if (code == 0) {
+    code = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(),
+                        environ);
+  }
+  posix_spawn_file_actions_destroy(&actions);
+  if (code != 0) return -1;
+
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) return -1;
+  }
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/**
+ * @brief Returns the cache directory, creating it private to the user.
+ *
+ * The directory is options.cacheDir, $S21_NATIVE_CACHE,
+ * $XDG_CACHE_HOME/s21_native or ~/.cache/s21_native. It is created with
+ * mode 0700; an existing directory must belong to the user and is made
+ * private if it is not.
+ *
+ * @param options The options of the build.
+ * @return The path of the directory.
+ * @throw std::runtime_error If the directory cannot be created or belongs
+ * to another user.
+ */
+std::string NativeProgram::cacheDirectory(const NativeOptions& options) {
+  std::string dir = options.cacheDir;
+  if (dir.empty()) {
+    const char* cache = std::getenv("S21_NATIVE_CACHE");
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    if (cache != nullptr && *cache != '\0') {
+      dir = cache;
+    } else if (xdg != nullptr && *xdg != '\0') {
+      dir = std::string(xdg) + "/s21_native";
+    } else if (home != nullptr && *home != '\0') {
+      dir = std::string(home) + "/.cache/s21_native";
+    } else {
+      throw std::runtime_error("No cache directory for native code");
+    }
+  }
+
+  std::error_code code;
+  std::filesystem::create_directories(
+      std::filesystem::path(dir).parent_path(), code);
+  if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+    throw std::runtime_error("Cannot create native code cache: " + dir);
+  }
+  // каталог не может быть ссылкой и должен принадлежать пользователю:
+  // иначе другой пользователь может подложить библиотеку
+  struct stat info = {};
+  if (lstat(dir.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) ||
+      info.st_uid != geteuid() ||
+      ((info.st_mode & 077) != 0 && chmod(dir.c_str(), 0700) != 0)) {
+    throw std::runtime_error("Native code cache is not private: " + dir);
+  }
+  return dir;
+}
+
+/**
+ * @brief Checks that a file is a regular file of the user that nobody
+ * else can write.
+ *
+ * @param path The path of the file.
+ * @return True if the file can be loaded safely.
+ */
+bool NativeProgram::isPrivateFile(const std::string& path) {
+  struct stat info = {};
+  return lstat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode) &&
+         info.st_uid == geteuid() && (info.st_mode & 022) == 0;
+}
+
+/**
+ * @brief Describes the processor the code is built for.
+ *
+ * On x86 the vendor, the signature and the feature bits of CPUID are used,
+ * elsewhere the architecture and the CPU description of the kernel.
+ *
+ * @return The description of the host processor.
+ */
+std::string NativeProgram::hostIdentity() {
+  // строка не разрушается при выходе: её может читать фоновая сборка
+  static const std::string* identity = new std::string([] {
+    std::ostringstream id;
+    struct utsname system = {};
+    if (uname(&system) == 0) id << system.machine;
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned a = 0, b = 0, c = 0, d = 0;
+    if (__get_cpuid(0, &a, &b, &c, &d)) {
+      id << std::hex << ' ' << b << d << c;
+    }
+    if (__get_cpuid(1, &a, &b, &c, &d)) {
+      id << ' ' << a << ' ' << c << ' ' << d;
+    }
+    if (__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+      id << ' ' << b << ' ' << c << ' ' << d;
+    }
+#else
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+      if (line.rfind("Features", 0) == 0 || line.rfind("CPU part", 0) == 0 ||
+          line.rfind("CPU implementer", 0) == 0) {
+        id << '\n' << line;
+      }
+    }
+#endif
+    return id.str();
+  }());
+  return *identity;
+}
+
+/**
+ * @brief Returns the name of the standard function for an operation.
+ *
+ * @param op The operation code of a function.
+ * @return The qualified name of the function.
+ * @throw std::invalid_argument If the operation is not a plain function call.
+ */
+const char* NativeProgram::functionName(OpCode op) {
+  switch (op) {
+    case OP_SIN:
+      return "std::sin";
+    case OP_COS:
+      return "std::cos";
+    case OP_TAN:
+      return "std::tan";
+    case OP_ASIN:
+      return "std::asin";
+    case OP_ACOS:
+      return "std::acos";
+    case OP_ATAN:
+      return "std::atan";
+    default:
+      throw std::invalid_argument("Unsupported operation");
+  }
+}
+
+/**
+ * @brief Calculates the 64-bit FNV-1a hash of a text.
+ *
+ * @param text The text to be hashed.
+ * @return The hash of the text.
+ */
+std::uint64_t NativeProgram::sourceHash(const std::string& text) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : text) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  return hash;
+}
+
+/**
+ * @brief Formats a constant as an exact C++ literal.
+ *
+ * @param value The value of the constant.
+ * @return The literal (hexadecimal for finite values).
+ */
+std::string NativeProgram::constantLiteral(double value) {
+  if (std::isnan(value)) return "nan";
+  if (std::isinf(value)) {
+    return value > 0 ? "std::numeric_limits<double>::infinity()"
+                     : "-std::numeric_limits<double>::infinity()";
+  }
+  std::ostringstream literal;
+  literal << std::hexfloat << value;
+  return literal.str();
+}
+
+}  // namespace s21
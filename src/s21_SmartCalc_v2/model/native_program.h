@@ -0,0 +1,96 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file native_program.h
+ *
+ * @brief Declaration of the NativeProgram class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the NativeProgram class,
+ * which is part of the SmartCalc v2.0 library.
+ * The NativeProgram class lowers a compiled ExpressionProgram to a C++
+ * translation unit, builds it with the installed compiler into a shared
+ * object and loads it with dlopen. Built objects are cached in a private
+ * directory of the user by the hash of their source, build command and
+ * host CPU.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_NATIVE_PROGRAM_H
+#define CPP3_S21_SMART_CALC_NATIVE_PROGRAM_H
+
+#include <cstddef>    // size_t
+#include <cstdint>    // sourceHash
+#include <memory>     // compile
+#include <stdexcept>  // std::runtime_error
+#include <string>     // NativeOptions
+#include <vector>     // runCompiler
+
+#include "expression_program.h"
+
+namespace s21 {
+
+// параметры сборки машинного кода
+struct NativeOptions {
+  // компилятор (пусто - $CXX или c++); слова разделяются пробелами и
+  // передаются компилятору без оболочки
+  std::string compiler;
+  // флаги сборки; к ним всегда добавляется -ffp-contract=off, чтобы
+  // компилятор не сливал умножение и сложение в FMA и результаты
+  // совпадали с интерпретатором побитно
+  std::string flags = "-O3 -march=native -ffp-contract=off -fPIC -shared";
+  // каталог кэша (пусто - $S21_NATIVE_CACHE, $XDG_CACHE_HOME/s21_native
+  // или ~/.cache/s21_native); создаётся с правами 0700
+  std::string cacheDir;
+};
+
+class NativeProgram {
+ public:
+  // сигнатура сгенерированной функции: x, количество точек, столбцы
+  using Kernel = void (*)(const double*, std::size_t, double* const*);
+
+  ~NativeProgram();
+  NativeProgram(const NativeProgram&) = delete;
+  NativeProgram& operator=(const NativeProgram&) = delete;
+
+  // Main methods:
+  static std::shared_ptr<NativeProgram> compile(
+      const ExpressionProgram& program,
+      const NativeOptions& options = NativeOptions());
+  static std::string generateSource(const ExpressionProgram& program);
+
+  void evaluate(const double* x, std::size_t n, double* const* columns) const;
+
+  // Accessors:
+  std::size_t outputCount() const { return outputs_; }
+  const std::string& libraryPath() const { return library_; }
+
+ private:
+  NativeProgram() = default;
+
+  // Auxiliary methods:
+  static std::string buildLibrary(const std::string& source,
+                                  const NativeOptions& options);
+  static int runCompiler(const std::vector<std::string>& arguments,
+                         const std::string& log);
+  static std::string cacheDirectory(const NativeOptions& options);
+  static bool isPrivateFile(const std::string& path);
+  static std::string hostIdentity();
+  static std::uint64_t sourceHash(const std::string& text);
+  static std::string constantLiteral(double value);
+  static const char* functionName(OpCode op);
+
+  void* handle_ = nullptr;
+  Kernel kernel_ = nullptr;
+  std::size_t outputs_ = 0;
+  std::string library_;
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_NATIVE_PROGRAM_H
@@ -70,77 +70,6 @@ String ReversePolishNotation::toRPN(const String& infix) {
  * AUXILIARY PRIVATE MAIN METHODS
  ******************************************************************************/
 
-/**
- * @brief Map of operator priorities.
- */
-const OperatorPriorityMap
-    ReversePolishNotation::operatorPriority = {
-        {'(', OP_PARENTHESIS},    {')', OP_PARENTHESIS},
-        {'+', OP_ADDITIVE},       {'-', OP_ADDITIVE},
-        {'*', OP_MULTIPLICATIVE}, {'/', OP_MULTIPLICATIVE},
-        {'%', OP_MULTIPLICATIVE}, {'s', OP_FUNCTION},
-        {'c', OP_FUNCTION},       {'t', OP_FUNCTION},
-        {'i', OP_FUNCTION},       {'o', OP_FUNCTION},
-        {'n', OP_FUNCTION},       {'q', OP_FUNCTION},
-        {'l', OP_FUNCTION},       {'g', OP_FUNCTION},
-        {'^', OP_EXPONENTIAL},    {'~', OP_UNARY_MINUS},
-};
-
-/**
- * @brief Map of function names to their corresponding characters.
- */
-const FunctionMap ReversePolishNotation::functions = {
-    {"sin", 's'},  {"cos", 'c'},  {"tan", 't'}, {"asin", 'i'}, {"acos", 'o'},
-    {"atan", 'n'}, {"sqrt", 'q'}, {"ln", 'l'},  {"log", 'g'}};
-
-/**
- * @brief Checks if a character represents a function.
- *
- * @param fn The character to be checked.
- * @return True if the character represents a function, false otherwise.
- */
-bool ReversePolishNotation::isFunction(const char fn) {
-  static const std::unordered_set<char> functions = {'s', 'c', 't', 'i', 'o',
-                                                     'n', 'q', 'l', 'g'};
-  return functions.find(fn) != functions.end();
-}
-
-/**
- * @brief Gets the priority of an operator.
- *
- * @param op The operator to be checked.
- * @return The priority of the operator.
- */
-int ReversePolishNotation::getOperatorPriority(const char op) {
-  auto it = operatorPriority.find(op);
-  if (it != operatorPriority.end()) {
-    return it->second;  // если существует - возвращаем приоритет
-  }
-  throw std::invalid_argument("Unknown operator");
-}
-
-/**
- * @brief Checks if a character is an operand (digit, dot, or 'x').
- *
- * @param c The character to be checked.
- * @return True if the character is an operand, false otherwise.
- */
-bool ReversePolishNotation::isOperand(const char c) {
-  return std::isdigit(c) || c == '.' || c == 'x';
-}
-
-/**
- * @brief Checks if a character is an operator.
- *
- * @param op The character to be checked.
- * @return True if the character is an operator, false otherwise.
- */
-bool ReversePolishNotation::isOperator(const char op) {
-  static const std::unordered_set<char> functions = {'+', '-', '*', '/',
-                                                     '^', '%', '~'};
-  return functions.find(op) != functions.end();
-}
-
 /**
  * @brief Determines if a character is an operand, operator, or function.
  *
@@ -205,10 +134,11 @@ void ReversePolishNotation::flushOperators(StringStack& operators,
 String ReversePolishNotation::renameFunctions(const String& infix) {
   String result = infix;
 
-  for (const auto& pair : functions) {
+  for (const FunctionName& function : kFunctionNames) {
     size_t pos = 0;
-    while ((pos = result.find(pair.first, pos)) != String::npos) {
-      result.replace(pos, pair.first.length(), String(1, pair.second));
+    while ((pos = result.find(function.name, pos, function.length)) !=
+           String::npos) {
+      result.replace(pos, function.length, String(1, function.code));
       pos += 1;
     }
   }
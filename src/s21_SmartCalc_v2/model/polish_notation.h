@@ -25,9 +25,8 @@
 #include <iostream>
 #include <string>        // toRPN, renameFunctions, replaceUnaryMinus, processedInfix
 #include <stack>         // toRPN
-#include <unordered_set> // isOperator, isFunction
-#include <unordered_map> // operatorPriority, functions
-#include <cctype>        // isOperand, processExponent (std::isdigit)
+#include <cctype>        // processExponent (std::isdigit)
+#include <cstddef>       // FunctionName
 #include <stdexcept>     // getOperatorPriority
 
 namespace s21 {
@@ -48,26 +47,35 @@ enum isOperandOrOperatorOrFunction {
   FUNCTION = 3
 };
 
+// имя функции и её однобуквенное обозначение
+struct FunctionName {
+  const char* name;    // имя функции во входном выражении
+  std::size_t length;  // длина имени
+  char code;           // обозначение в обработанном выражении
+};
+
+// имена заменяются по порядку: asin, acos и atan раньше sin, cos и tan
+inline constexpr FunctionName kFunctionNames[] = {
+    {"asin", 4, 'i'}, {"acos", 4, 'o'}, {"atan", 4, 'n'},
+    {"sin", 3, 's'},  {"cos", 3, 'c'},  {"tan", 3, 't'},
+    {"sqrt", 4, 'q'}, {"ln", 2, 'l'},   {"log", 3, 'g'}};
+
 using String = std::string;
 using StringStack = std::stack<std::string>;
-using FunctionMap = std::unordered_map<std::string, char>;
-using OperatorPriorityMap = std::unordered_map<char, OperatorPriority>;
 
 class ReversePolishNotation {
  public:
   // Main methods:
   static String toRPN(const String& infix);
 
+  // Grammar (usable in constant expressions):
+  static constexpr int getOperatorPriority(const char op);
+  static constexpr bool isOperand(const char c);
+  static constexpr bool isOperator(const char op);
+  static constexpr bool isFunction(const char fn);
+
  private:
   // Auxiliary methods:
-  static const OperatorPriorityMap operatorPriority;
-  static const FunctionMap functions;
-
-  static int getOperatorPriority(const char c);
-
-  static bool isOperand(const char c);
-  static bool isOperator(const char op);
-  static bool isFunction(const char fn);
   static int isOperandOrOperatorOrFunction(const String& infix, size_t i);
 
   static void processOperand(String& output, const String& token);
@@ -95,6 +103,69 @@ class ReversePolishNotation {
   static String trim(const String& str);
 };
 
+/**
+ * @brief Gets the priority of an operator.
+ *
+ * @param op The operator to be checked.
+ * @return The priority of the operator.
+ * @throw std::invalid_argument If the operator is unknown.
+ */
+constexpr int ReversePolishNotation::getOperatorPriority(const char op) {
+  switch (op) {
+    case '(':
+    case ')':
+      return OP_PARENTHESIS;
+    case '+':
+    case '-':
+      return OP_ADDITIVE;
+    case '*':
+    case '/':
+    case '%':
+      return OP_MULTIPLICATIVE;
+    case '^':
+      return OP_EXPONENTIAL;
+    case '~':
+      return OP_UNARY_MINUS;
+    default:
+      if (isFunction(op)) return OP_FUNCTION;
+  }
+  throw std::invalid_argument("Unknown operator");
+}
+
+/**
+ * @brief Checks if a character is an operand (digit, dot, or 'x').
+ *
+ * @param c The character to be checked.
+ * @return True if the character is an operand, false otherwise.
+ */
+constexpr bool ReversePolishNotation::isOperand(const char c) {
+  return (c >= '0' && c <= '9') || c == '.' || c == 'x';
+}
+
+/**
+ * @brief Checks if a character is an operator.
+ *
+ * @param op The character to be checked.
+ * @return True if the character is an operator, false otherwise.
+ */
+constexpr bool ReversePolishNotation::isOperator(const char op) {
+  return op == '+' || op == '-' || op == '*' || op == '/' || op == '^' ||
+         op == '%' || op == '~';
+}
+
+/**
+ * @brief Checks if a character represents a function.
+ *
+ * @param fn The character to be checked.
+ * @return True if the character represents a function, false otherwise.
+ */
+constexpr bool ReversePolishNotation::isFunction(const char fn) {
+  for (const FunctionName& function : kFunctionNames) {
+    if (function.code == fn) return true;
+  }
+  return false;
+}
+
 }  // namespace s21
 
 #endif  // CPP3_S21_SMARTCALC_REVERSE_POLISH_NOTATION_H
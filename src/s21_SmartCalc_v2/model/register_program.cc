@@ -0,0 +1,287 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file register_program.cc
+ *
+ * @brief Implementation of the RegisterProgram class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the RegisterProgram class,
+ * which is part of the SmartCalc v2.0 library.
+ * The RegisterProgram class compiles the instruction graph of an
+ * ExpressionProgram into register-based bytecode. Every instruction reads
+ * its operands directly from registers, constants or x, so there is no
+ * push/pop traffic, and values are kept in a small register file by
+ * linear-scan allocation.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "register_program.h"
+
+#include <algorithm>  // std::max_element, std::min, std::fill
+#include <cstring>    // std::memcpy
+#include <limits>     // std::numeric_limits
+#include <stdexcept>  // std::invalid_argument
+
+namespace s21 {
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Compiles the instruction graph of a program into register bytecode.
+ *
+ * Constants and x are not copied into registers: instructions read them
+ * from their own cells of the frame. Every other value gets a live
+ * interval from its definition to its last use, and the intervals are
+ * assigned to registers by linear scan. When all registers are busy, the
+ * interval that ends last is moved to a spill cell for its whole life.
+ *
+ * @param program The compiled program.
+ * @param registers The size of the register file.
+ * @return The register program.
+ * @throw std::invalid_argument If the register file is empty or the
+ * program is too large for 16-bit cell numbers.
+ */
+RegisterProgram RegisterProgram::compile(const ExpressionProgram& program,
+                                         std::size_t registers) {
+  if (registers == 0) {
+    throw std::invalid_argument("Register file cannot be empty");
+  }
+  const InstructionVector& dag = program.instructions();
+  const std::size_t n = dag.size();
+  auto isLeaf = [&dag](std::size_t i) {
+    return dag[i].op == OP_CONST || dag[i].op == OP_X;
+  };
+
+  // последнее использование каждого значения (результаты живут до конца)
+  std::vector<std::size_t> end(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    end[i] = i;
+    if (isLeaf(i)) continue;
+    end[dag[i].lhs] = i;
+    if (ExpressionProgram::isBinary(dag[i].op)) end[dag[i].rhs] = i;
+  }
+  for (int out : program.outputs()) end[out] = n;
+
+  std::vector<int> reg(n, -1), spill(n, -1);
+  std::vector<std::size_t> active, spilled;  // значения в регистрах и памяти
+  std::vector<int> freeRegs;
+  for (std::size_t r = registers; r > 0; --r) freeRegs.push_back(r - 1);
+  // свободные ячейки памяти и последнее использование прежнего значения
+  std::vector<std::pair<int, std::size_t>> freeSpills;
+  RegisterProgram result;
+
+  // ячейка памяти, свободная с начала жизни значения start
+  auto takeSpill = [&freeSpills, &result](std::size_t start) {
+    for (std::size_t s = 0; s < freeSpills.size(); ++s) {
+      if (freeSpills[s].second <= start) {
+        int slot = freeSpills[s].first;
+        freeSpills.erase(freeSpills.begin() + s);
+        return slot;
+      }
+    }
+    return static_cast<int>(result.spills_++);
+  };
+
+  for (std::size_t i = 0; i < n; ++i) {
+    if (isLeaf(i)) continue;
+    // освобождение ячеек значений, чьё последнее использование - i
+    for (std::size_t k = active.size(); k > 0; --k) {
+      std::size_t v = active[k - 1];
+      if (end[v] <= i) {
+        freeRegs.push_back(reg[v]);
+        active.erase(active.begin() + (k - 1));
+      }
+    }
+    for (std::size_t k = spilled.size(); k > 0; --k) {
+      std::size_t v = spilled[k - 1];
+      if (end[v] <= i) {
+        freeSpills.emplace_back(spill[v], end[v]);
+        spilled.erase(spilled.begin() + (k - 1));
+      }
+    }
+
+    if (!freeRegs.empty()) {
+      reg[i] = freeRegs.back();
+      freeRegs.pop_back();
+      active.push_back(i);
+      continue;
+    }
+    auto last = std::max_element(
+        active.begin(), active.end(),
+        [&end](std::size_t a, std::size_t b) { return end[a] < end[b]; });
+    std::size_t victim = *last;
+    if (end[victim] > end[i]) {
+      // регистр достаётся значению, которое понадобится раньше
+      reg[i] = reg[victim];
+      reg[victim] = -1;
+      spill[victim] = takeSpill(victim);
+      spilled.push_back(victim);
+      *last = i;
+    } else {
+      spill[i] = takeSpill(i);
+      spilled.push_back(i);
+    }
+  }
+
+  for (std::size_t i = 0; i < n; ++i) {
+    if (reg[i] >= 0) {
+      result.registers_ = std::max<std::size_t>(result.registers_, reg[i] + 1);
+    }
+  }
+  std::vector<std::size_t> constant(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (dag[i].op == OP_CONST) {
+      constant[i] = result.constants_.size();
+      result.constants_.push_back(dag[i].value);
+    }
+  }
+  result.xSlot_ =
+      result.registers_ + result.spills_ + result.constants_.size();
+  if (result.xSlot_ > std::numeric_limits<std::uint16_t>::max()) {
+    throw std::invalid_argument("Expression is too large");
+  }
+
+  auto cell = [&](std::size_t v) {
+    std::size_t slot = result.xSlot_;
+    if (dag[v].op == OP_CONST) {
+      slot = result.registers_ + result.spills_ + constant[v];
+    } else if (reg[v] >= 0) {
+      slot = reg[v];
+    } else if (spill[v] >= 0) {
+      slot = result.registers_ + spill[v];
+    }
+    return static_cast<std::uint16_t>(slot);
+  };
+  for (std::size_t i = 0; i < n; ++i) {
+    if (isLeaf(i)) continue;
+    std::uint16_t lhs = cell(dag[i].lhs);
+    std::uint16_t rhs =
+        ExpressionProgram::isBinary(dag[i].op) ? cell(dag[i].rhs) : lhs;
+    result.code_.push_back(
+        {static_cast<std::uint8_t>(dag[i].op), cell(i), lhs, rhs});
+  }
+  for (int out : program.outputs()) result.outputs_.push_back(cell(out));
+  return result;
+}
+
+/**
+ * @brief Compiles a single infix expression into register bytecode.
+ *
+ * @param infix The expression.
+ * @return The register program.
+ * @throw std::invalid_argument If the expression is invalid.
+ */
+RegisterProgram RegisterProgram::compile(const String& infix) {
+  return compile(ExpressionProgram::compile(infix));
+}
+
+/**
+ * @brief Evaluates one output of the program for a single x value.
+ *
+ * @param x The value of x.
+ * @param output The index of the output.
+ * @return The value of the output (NaN if it cannot be calculated).
+ * @throw std::out_of_range If there is no such output.
+ */
+double RegisterProgram::evaluate(double x, std::size_t output) const {
+  // небольшой кадр размещается на стеке
+  double local[64];
+  std::vector<double> heap;
+  double* frame = local;
+  if (frameSize() > 64) {
+    heap.resize(frameSize());
+    frame = heap.data();
+  }
+  initFrame(frame, 1);
+  frame[xSlot_] = x;
+  for (const RegisterInstruction& in : code_) {
+    frame[in.dst] = ExpressionProgram::applyScalar(
+        static_cast<OpCode>(in.op), frame[in.lhs], frame[in.rhs]);
+  }
+  return frame[outputs_.at(output)];
+}
+
+/**
+ * @brief Evaluates all outputs of the program for any number of x values.
+ *
+ * In batch mode every cell of the frame is a row of kBlockSize lanes and
+ * every instruction is one loop over the lanes, so the register file
+ * stays small enough to be kept in the L1 cache.
+ *
+ * @param x Pointer to the x values.
+ * @param n The number of values.
+ * @param columns Array of outputCount() pointers to the output columns.
+ */
+void RegisterProgram::evaluate(const double* x, std::size_t n,
+                               double* const* columns) const {
+  const std::size_t block = ExpressionProgram::kBlockSize;
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> frame(frameSize() * block);
+  initFrame(frame.data(), block);
+  double* xs = frame.data() + xSlot_ * block;
+
+  for (std::size_t start = 0; start < n; start += block) {
+    std::size_t count = std::min(block, n - start);
+    std::memcpy(xs, x + start, count * sizeof(double));
+    for (const RegisterInstruction& in : code_) {
+      double* r = frame.data() + in.dst * block;
+      const double* a = frame.data() + in.lhs * block;
+      const double* b = frame.data() + in.rhs * block;
+      switch (in.op) {
+        case OP_ADD:
+          for (std::size_t k = 0; k < count; ++k) r[k] = a[k] + b[k];
+          break;
+        case OP_SUB:
+          for (std::size_t k = 0; k < count; ++k) r[k] = a[k] - b[k];
+          break;
+        case OP_MUL:
+          for (std::size_t k = 0; k < count; ++k) r[k] = a[k] * b[k];
+          break;
+        case OP_DIV:
+          for (std::size_t k = 0; k < count; ++k) {
+            r[k] = b[k] == 0.0 ? nan : a[k] / b[k];
+          }
+          break;
+        case OP_NEG:
+          for (std::size_t k = 0; k < count; ++k) r[k] = -a[k];
+          break;
+        default:
+          for (std::size_t k = 0; k < count; ++k) {
+            r[k] = ExpressionProgram::applyScalar(static_cast<OpCode>(in.op),
+                                                  a[k], b[k]);
+          }
+      }
+    }
+    for (std::size_t j = 0; j < outputs_.size(); ++j) {
+      std::memcpy(columns[j] + start, frame.data() + outputs_[j] * block,
+                  count * sizeof(double));
+    }
+  }
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Fills the constant cells of a frame.
+ *
+ * @param frame The frame of frameSize() cells of stride values each.
+ * @param stride The number of lanes in a cell.
+ */
+void RegisterProgram::initFrame(double* frame, std::size_t stride) const {
+  double* cells = frame + (registers_ + spills_) * stride;
+  for (std::size_t c = 0; c < constants_.size(); ++c) {
+    std::fill(cells + c * stride, cells + (c + 1) * stride, constants_[c]);
+  }
+}
+
+}  // namespace s21
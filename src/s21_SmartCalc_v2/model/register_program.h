@@ -0,0 +1,83 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file register_program.h
+ *
+ * @brief Declaration of the RegisterProgram class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the RegisterProgram class,
+ * which is part of the SmartCalc v2.0 library.
+ * The RegisterProgram class compiles the instruction graph of an
+ * ExpressionProgram into register-based bytecode. Every instruction reads
+ * its operands directly from registers, constants or x, so there is no
+ * push/pop traffic, and values are kept in a small register file by
+ * linear-scan allocation.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_REGISTER_PROGRAM_H
+#define CPP3_S21_SMART_CALC_REGISTER_PROGRAM_H
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t, uint16_t
+#include <vector>   // code_, constants_
+
+#include "expression_program.h"
+
+namespace s21 {
+
+// инструкция регистровой машины: frame[dst] = op(frame[lhs], frame[rhs])
+struct RegisterInstruction {
+  std::uint8_t op;    // код операции (OpCode)
+  std::uint16_t dst;  // ячейка результата
+  std::uint16_t lhs;  // ячейка первого операнда
+  std::uint16_t rhs;  // ячейка второго операнда (= lhs для унарных)
+};
+
+using RegisterCode = std::vector<RegisterInstruction>;
+
+class RegisterProgram {
+ public:
+  // количество регистров, доступных распределителю
+  static constexpr std::size_t kRegisters = 16;
+
+  RegisterProgram() = default;
+
+  // Main methods:
+  static RegisterProgram compile(const ExpressionProgram& program,
+                                 std::size_t registers = kRegisters);
+  static RegisterProgram compile(const String& infix);
+
+  double evaluate(double x, std::size_t output = 0) const;
+  void evaluate(const double* x, std::size_t n, double* const* columns) const;
+
+  // Accessors:
+  std::size_t size() const { return code_.size(); }
+  std::size_t outputCount() const { return outputs_.size(); }
+  std::size_t registerCount() const { return registers_; }
+  std::size_t spillCount() const { return spills_; }
+  std::size_t frameSize() const { return xSlot_ + 1; }
+  const RegisterCode& instructions() const { return code_; }
+
+ private:
+  // Auxiliary methods:
+  void initFrame(double* frame, std::size_t stride) const;
+
+  // ячейки кадра: [регистры][вытесненные значения][константы][x]
+  RegisterCode code_;
+  std::vector<double> constants_;
+  std::vector<std::uint16_t> outputs_;  // ячейки результатов
+  std::size_t registers_ = 0;           // использованные регистры
+  std::size_t spills_ = 0;              // ячейки вытесненных значений
+  std::size_t xSlot_ = 0;               // ячейка x
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_REGISTER_PROGRAM_H
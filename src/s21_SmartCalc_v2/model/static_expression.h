@@ -0,0 +1,487 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file static_expression.h
+ *
+ * @brief Declaration and implementation of the StaticCompiler and
+ * StaticExpression classes for the SmartCalc v2.0 library.
+ *
+ * This file contains the StaticCompiler class, which parses an infix
+ * expression in a constant expression with the same grammar as
+ * ReversePolishNotation and ExpressionProgram, and the StaticExpression
+ * class template, which turns a formula fixed in C++ code into straight-line
+ * code the compiler can inline. No parsing and no tables are left for run
+ * time or static initialization.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_STATIC_EXPRESSION_H
+#define CPP3_S21_SMART_CALC_STATIC_EXPRESSION_H
+
+#include <cstddef>    // StaticProgram
+#include <cstdint>    // parseNumber
+#include <limits>     // apply
+#include <stdexcept>  // compile
+#include <string>     // constant
+#include <utility>    // std::index_sequence
+
+#include "expression_program.h"
+#include "polish_notation.h"
+
+namespace s21 {
+
+// инструкция программы, построенной при компиляции
+struct StaticInstruction {
+  OpCode op = OP_CONST;    // код операции
+  int lhs = -1;            // слот первого операнда (-1, если нет)
+  int rhs = -1;            // слот второго операнда (-1, если нет)
+  double value = 0.0;      // значение константы для OP_CONST
+  bool exact = true;       // значение константы найдено при компиляции
+  std::size_t begin = 0;   // начало записи константы во входной строке
+  std::size_t length = 0;  // длина записи константы
+};
+
+class StaticCompiler {
+ public:
+  // наибольшая длина выражения и количество инструкций программы
+  static constexpr std::size_t kCapacity = 256;
+
+  struct Program {
+    StaticInstruction code[kCapacity] = {};  // инструкции программы
+    std::size_t size = 0;                    // количество инструкций
+    int output = -1;                         // слот результата
+  };
+
+  // Main methods:
+  static constexpr Program compile(const char* infix);
+
+ private:
+  // выражение после замены функций и унарного минуса
+  struct Text {
+    char c[kCapacity] = {};            // символы
+    std::size_t origin[kCapacity] = {};  // позиции во входной строке
+    std::size_t size = 0;              // длина
+  };
+
+  // Auxiliary methods:
+  static constexpr Text processedInfix(const char* infix);
+  static constexpr void emitOperand(Program& program, const Text& text,
+                                    std::size_t begin, std::size_t end,
+                                    int* values, std::size_t& depth);
+  static constexpr void emitOperator(Program& program, char op, int* values,
+                                     std::size_t& depth);
+  static constexpr int append(Program& program,
+                              const StaticInstruction& instruction);
+  static constexpr bool parseNumber(const char* s, std::size_t n,
+                                    double& value);
+};
+
+/**
+ * @brief A formula compiled by the C++ compiler.
+ *
+ * The formula must be a named character array with static storage duration:
+ * @code
+ * static constexpr char kFormula[] = "sin(x)^2+1";
+ * double y = s21::StaticExpression<kFormula>::evaluate(0.5);
+ * @endcode
+ * An invalid formula is a compilation error. The results are those of
+ * ExpressionProgram up to the rounding of its polynomial rewrites.
+ */
+template <const char* Infix>
+class StaticExpression {
+ public:
+  static constexpr StaticCompiler::Program kProgram =
+      StaticCompiler::compile(Infix);
+
+  template <typename T = double>
+  static T evaluate(T x);
+  double operator()(double x) const { return evaluate(x); }
+
+  // Accessors:
+  static constexpr std::size_t size() { return kProgram.size; }
+
+ private:
+  template <typename T, std::size_t... I>
+  static T run(T x, std::index_sequence<I...>);
+  template <std::size_t I, typename T>
+  static T step(const T* slots, T x);
+  template <std::size_t I, typename T>
+  static T constant();
+  template <typename T>
+  static T integerPower(T base, unsigned n);
+};
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Compiles an infix expression into a program.
+ *
+ * The conversion repeats ReversePolishNotation::toRPN() and
+ * ExpressionProgram::appendRPN() step by step, but builds the instructions
+ * directly instead of an RPN string, so it can run in a constant
+ * expression.
+ *
+ * @param infix The infix expression.
+ * @return The compiled program.
+ * @throw std::invalid_argument If the expression is invalid or too long.
+ */
+constexpr StaticCompiler::Program StaticCompiler::compile(const char* infix) {
+  Text text = processedInfix(infix);
+  Program program;
+  char operators[kCapacity] = {};
+  int values[kCapacity] = {};
+  std::size_t top = 0, depth = 0;
+
+  for (std::size_t i = 0; i < text.size; ++i) {
+    char c = text.c[i];
+    if (ReversePolishNotation::isOperand(c)) {
+      // число в научной записи: одна экспонента, после неё цифра
+      std::size_t begin = i;
+      bool hasExponent = false;
+      while (i < text.size && (ReversePolishNotation::isOperand(text.c[i]) ||
+                               text.c[i] == 'e' || text.c[i] == 'E')) {
+        if ((text.c[i] == 'e' || text.c[i] == 'E') && !hasExponent) {
+          hasExponent = true;
+          if (i + 1 < text.size &&
+              (text.c[i + 1] == '+' || text.c[i + 1] == '-')) {
+            ++i;
+          }
+          if (!(i + 1 < text.size && text.c[i + 1] >= '0' &&
+                text.c[i + 1] <= '9')) {
+            throw std::invalid_argument("Invalid format: expected digit");
+          }
+          ++i;
+        }
+        ++i;
+      }
+      emitOperand(program, text, begin, i, values, depth);
+      --i;
+    } else if (c == '~' || ReversePolishNotation::isFunction(c)) {
+      operators[top++] = c;
+    } else if (ReversePolishNotation::isOperator(c)) {
+      while (top > 0 && ReversePolishNotation::getOperatorPriority(
+                            operators[top - 1]) >=
+                            ReversePolishNotation::getOperatorPriority(c)) {
+        emitOperator(program, operators[--top], values, depth);
+      }
+      operators[top++] = c;
+    } else if (c == '(') {
+      operators[top++] = c;
+    } else if (c == ')') {
+      while (top > 0 && operators[top - 1] != '(') {
+        emitOperator(program, operators[--top], values, depth);
+      }
+      if (top > 0) --top;
+    }
+  }
+  while (top > 0) {
+    emitOperator(program, operators[--top], values, depth);
+  }
+  if (depth != 1) {
+    throw std::invalid_argument("Invalid RPN expression");
+  }
+  program.output = values[0];
+  return program;
+}
+
+/**
+ * @brief Evaluates the formula.
+ *
+ * @param x The value of x.
+ * @return The value of the formula (NaN if it cannot be calculated).
+ */
+template <const char* Infix>
+template <typename T>
+T StaticExpression<Infix>::evaluate(T x) {
+  return run(x, std::make_index_sequence<kProgram.size>());
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Renames functions and replaces unary minus with '~', like
+ * ReversePolishNotation::processedInfix().
+ *
+ * @param infix The infix expression.
+ * @return The processed expression with the positions of its characters.
+ * @throw std::invalid_argument If the expression is too long.
+ */
+constexpr StaticCompiler::Text StaticCompiler::processedInfix(
+    const char* infix) {
+  Text text;
+  for (; infix[text.size] != '\0'; ++text.size) {
+    if (text.size == kCapacity) {
+      throw std::invalid_argument("Expression is too long");
+    }
+    text.c[text.size] = infix[text.size];
+    text.origin[text.size] = text.size;
+  }
+  for (const FunctionName& function : kFunctionNames) {
+    for (std::size_t pos = 0; pos + function.length <= text.size; ++pos) {
+      std::size_t k = 0;
+      while (k < function.length && text.c[pos + k] == function.name[k]) ++k;
+      if (k < function.length) continue;
+      text.c[pos] = function.code;
+      for (std::size_t j = pos + 1; j + function.length - 1 < text.size; ++j) {
+        text.c[j] = text.c[j + function.length - 1];
+        text.origin[j] = text.origin[j + function.length - 1];
+      }
+      text.size -= function.length - 1;
+    }
+  }
+  for (std::size_t i = 0; i < text.size; ++i) {
+    bool unary = i == 0 || text.c[i - 1] == '(' ||
+                 ReversePolishNotation::isOperator(text.c[i - 1]);
+    if (text.c[i] == '-' && unary) text.c[i] = '~';
+  }
+  return text;
+}
+
+/**
+ * @brief Appends an operand token (x or a number) to the program.
+ *
+ * @param program The program.
+ * @param text The processed expression.
+ * @param begin The first character of the token.
+ * @param end The character after the token.
+ * @param values The stack of operand slots.
+ * @param depth The size of the stack.
+ * @throw std::invalid_argument If the token is not a number.
+ */
+constexpr void StaticCompiler::emitOperand(Program& program, const Text& text,
+                                           std::size_t begin, std::size_t end,
+                                           int* values, std::size_t& depth) {
+  StaticInstruction in;
+  if (end - begin == 1 && text.c[begin] == 'x') {
+    in.op = OP_X;
+  } else {
+    in.begin = text.origin[begin];
+    in.length = end - begin;
+    in.exact = parseNumber(text.c + begin, end - begin, in.value);
+  }
+  values[depth++] = append(program, in);
+}
+
+/**
+ * @brief Appends an operator or a function taking its operands from the
+ * stack of operand slots.
+ *
+ * @param program The program.
+ * @param op The operator or function character.
+ * @param values The stack of operand slots.
+ * @param depth The size of the stack.
+ * @throw std::invalid_argument If there are not enough operands or the
+ * character is an unmatched parenthesis.
+ */
+constexpr void StaticCompiler::emitOperator(Program& program, char op,
+                                            int* values, std::size_t& depth) {
+  // символы операций в порядке кодов от OP_ADD до OP_NEG
+  constexpr char kOperators[] = "+-*/^%sctionqlg~";
+  StaticInstruction in;
+  std::size_t k = 0;
+  while (kOperators[k] != '\0' && kOperators[k] != op) ++k;
+  if (kOperators[k] == '\0') {
+    throw std::invalid_argument("Unknown token");
+  }
+  in.op = static_cast<OpCode>(OP_ADD + k);
+  bool binary = in.op >= OP_ADD && in.op <= OP_MOD;
+  if (depth < (binary ? 2u : 1u)) {
+    throw std::invalid_argument("Invalid RPN expression: not enough operands");
+  }
+  if (binary) in.rhs = values[--depth];
+  in.lhs = values[--depth];
+  values[depth++] = append(program, in);
+}
+
+/**
+ * @brief Appends an instruction to the program.
+ *
+ * @param program The program.
+ * @param instruction The instruction.
+ * @return The slot of the instruction.
+ * @throw std::invalid_argument If the program is too large.
+ */
+constexpr int StaticCompiler::append(Program& program,
+                                     const StaticInstruction& instruction) {
+  if (program.size == kCapacity) {
+    throw std::invalid_argument("Expression is too large");
+  }
+  program.code[program.size] = instruction;
+  return static_cast<int>(program.size++);
+}
+
+/**
+ * @brief Parses the leading number of a token, like std::stod.
+ *
+ * The value is found at compile time when it is exact: at most 2^53 in
+ * the significant digits and a power of ten up to 10^22, both exactly
+ * representable, so one multiplication or division rounds correctly.
+ * Other numbers are parsed by StaticExpression at first use.
+ *
+ * @param s The characters of the token.
+ * @param n The length of the token.
+ * @param value The value of the number.
+ * @return True if the value has been found.
+ * @throw std::invalid_argument If the token does not start with a number.
+ */
+constexpr bool StaticCompiler::parseNumber(const char* s, std::size_t n,
+                                           double& value) {
+  std::uint64_t mantissa = 0;
+  int exponent = 0, digits = 0;
+  bool truncated = false, fraction = false, any = false;
+  std::size_t i = 0;
+  for (; i < n && ((s[i] >= '0' && s[i] <= '9') || (s[i] == '.' && !fraction));
+       ++i) {
+    if (s[i] == '.') {
+      fraction = true;
+      continue;
+    }
+    any = true;
+    if (mantissa == 0 && s[i] == '0') {
+      if (fraction) --exponent;
+    } else if (digits < 19) {
+      mantissa = mantissa * 10 + (s[i] - '0');
+      ++digits;
+      if (fraction) --exponent;
+    } else {
+      truncated = truncated || s[i] != '0';
+      if (!fraction) ++exponent;
+    }
+  }
+  if (!any) {
+    throw std::invalid_argument("Unknown token");
+  }
+  if (i + 1 < n && (s[i] == 'e' || s[i] == 'E')) {
+    std::size_t j = i + 1;
+    bool negative = s[j] == '-';
+    if (s[j] == '+' || s[j] == '-') ++j;
+    int power = 0;
+    for (; j < n && s[j] >= '0' && s[j] <= '9' && power < 10000; ++j) {
+      power = power * 10 + (s[j] - '0');
+    }
+    exponent += negative ? -power : power;
+  }
+
+  value = 0.0;
+  if (mantissa == 0) return true;
+  if (truncated || mantissa > (std::uint64_t(1) << 53) || exponent > 22 ||
+      exponent < -22) {
+    return false;
+  }
+  double scale = 1.0;
+  for (int k = 0; k < (exponent < 0 ? -exponent : exponent); ++k) scale *= 10;
+  value = exponent < 0 ? mantissa / scale : mantissa * scale;
+  return true;
+}
+
+/**
+ * @brief Evaluates all instructions in order as straight-line code.
+ *
+ * @param x The value of x.
+ * @return The value of the output slot.
+ */
+template <const char* Infix>
+template <typename T, std::size_t... I>
+T StaticExpression<Infix>::run(T x, std::index_sequence<I...>) {
+  T slots[sizeof...(I)] = {};
+  ((slots[I] = step<I>(slots, x)), ...);
+  return slots[kProgram.output];
+}
+
+/**
+ * @brief Evaluates one instruction; the operation is known at compile time.
+ *
+ * Arithmetic and integer powers with a constant exponent are expanded in
+ * place; other functions go through ExpressionProgram::applyScalar(), so
+ * their domain checks are the same.
+ *
+ * @param slots The values of the previous instructions.
+ * @param x The value of x.
+ * @return The value of instruction I.
+ */
+template <const char* Infix>
+template <std::size_t I, typename T>
+T StaticExpression<Infix>::step(const T* slots, T x) {
+  constexpr StaticInstruction in = kProgram.code[I];
+  if constexpr (in.op == OP_CONST) {
+    return constant<I, T>();
+  } else if constexpr (in.op == OP_X) {
+    return x;
+  } else if constexpr (in.op == OP_ADD) {
+    return slots[in.lhs] + slots[in.rhs];
+  } else if constexpr (in.op == OP_SUB) {
+    return slots[in.lhs] - slots[in.rhs];
+  } else if constexpr (in.op == OP_MUL) {
+    return slots[in.lhs] * slots[in.rhs];
+  } else if constexpr (in.op == OP_DIV) {
+    return slots[in.rhs] == T(0) ? std::numeric_limits<T>::quiet_NaN()
+                                 : slots[in.lhs] / slots[in.rhs];
+  } else if constexpr (in.op == OP_NEG) {
+    return -slots[in.lhs];
+  } else if constexpr (in.op == OP_POW &&
+                       kProgram.code[in.rhs].op == OP_CONST &&
+                       kProgram.code[in.rhs].exact &&
+                       kProgram.code[in.rhs].value >= 0 &&
+                       kProgram.code[in.rhs].value <=
+                           ExpressionProgram::kMaxPower &&
+                       kProgram.code[in.rhs].value ==
+                           static_cast<unsigned>(kProgram.code[in.rhs].value)) {
+    return integerPower(slots[in.lhs],
+                        static_cast<unsigned>(kProgram.code[in.rhs].value));
+  } else {
+    return ExpressionProgram::applyScalar(
+        in.op, slots[in.lhs], in.rhs >= 0 ? slots[in.rhs] : T(0));
+  }
+}
+
+/**
+ * @brief Returns the value of a constant.
+ *
+ * @return The value found at compile time, or parsed once at first use
+ * if it cannot be found exactly at compile time.
+ */
+template <const char* Infix>
+template <std::size_t I, typename T>
+T StaticExpression<Infix>::constant() {
+  constexpr StaticInstruction in = kProgram.code[I];
+  if constexpr (in.exact) {
+    return static_cast<T>(in.value);
+  } else {
+    static const double value =
+        std::stod(std::string(Infix + in.begin, in.length));
+    return static_cast<T>(value);
+  }
+}
+
+/**
+ * @brief Raises a number to a constant integer power with the same
+ * multiplications as ExpressionProgram::power().
+ *
+ * @param base The base.
+ * @param n The exponent.
+ * @return The base raised to the exponent.
+ */
+template <const char* Infix>
+template <typename T>
+T StaticExpression<Infix>::integerPower(T base, unsigned n) {
+  T result = 1;
+  while (n != 0) {
+    if (n & 1u) result *= base;
+    n >>= 1;
+    if (n != 0) base *= base;
+  }
+  return result;
+}
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_STATIC_EXPRESSION_H
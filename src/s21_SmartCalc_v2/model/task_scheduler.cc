@@ -0,0 +1,386 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file task_scheduler.cc
+ *
+ * @brief Implementation of the TaskScheduler and TaskGroup classes
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the TaskScheduler class,
+ * which is part of the SmartCalc v2.0 library.
+ * The TaskScheduler class is a process-wide work-stealing thread pool
+ * with fork/join task groups and parallel loops over index ranges.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "task_scheduler.h"
+
+#if defined(__linux__)
+#include <pthread.h>  // pthread_setaffinity_np
+#include <sched.h>    // cpu_set_t
+#endif
+
+#include <algorithm>  // std::max
+#include <chrono>     // wait
+#include <stdexcept>  // std::runtime_error
+
+namespace s21 {
+
+namespace {
+
+// планировщик и номер рабочего потока, выполняющего код (если это он)
+thread_local TaskScheduler* currentScheduler = nullptr;
+thread_local std::size_t currentWorker = 0;
+
+}  // namespace
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTOR
+ ******************************************************************************/
+
+/**
+ * @brief Starts the worker threads.
+ *
+ * By default there is one worker less than there are cores, because the
+ * thread waiting for a task group works too.
+ *
+ * @param options The number of workers and their affinity.
+ */
+TaskScheduler::TaskScheduler(const SchedulerOptions& options)
+    : options_(options) {
+  unsigned count = options.workers;
+  if (count == 0) {
+    count = std::max(2u, std::thread::hardware_concurrency()) - 1;
+  }
+  for (unsigned i = 0; i < count; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (std::size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->thread = std::thread(&TaskScheduler::run, this, i);
+  }
+}
+
+/**
+ * @brief Stops and joins the worker threads.
+ */
+TaskScheduler::~TaskScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+/**
+ * @brief Creates an empty task group.
+ *
+ * @param scheduler The scheduler running the tasks.
+ */
+TaskGroup::TaskGroup(TaskScheduler& scheduler) : scheduler_(scheduler) {}
+
+/**
+ * @brief Waits for the tasks of the group; their exceptions are dropped.
+ */
+TaskGroup::~TaskGroup() {
+  try {
+    wait();
+  } catch (...) {
+  }
+}
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the process-wide scheduler, starting it on first use.
+ *
+ * @return The scheduler.
+ */
+TaskScheduler& TaskScheduler::instance() {
+  static TaskScheduler scheduler([] {
+    started() = true;
+    return globalOptions();
+  }());
+  return scheduler;
+}
+
+/**
+ * @brief Sets the options of the process-wide scheduler.
+ *
+ * @param options The number of workers and their affinity.
+ * @throw std::runtime_error If the scheduler is already running.
+ */
+void TaskScheduler::configure(const SchedulerOptions& options) {
+  if (started()) {
+    throw std::runtime_error("Scheduler is already running");
+  }
+  globalOptions() = options;
+}
+
+/**
+ * @brief Calls body for subranges of [begin, end) in parallel.
+ *
+ * The range is split in halves until the parts are not longer than grain;
+ * one half is forked and the other one is processed at once, so idle
+ * workers steal the largest parts first. The call returns when the whole
+ * range has been processed and rethrows the first exception of the body.
+ *
+ * @param begin The first index.
+ * @param end The index after the last one.
+ * @param grain The largest part processed by one call of body.
+ * @param body The function processing a subrange.
+ */
+void TaskScheduler::parallelFor(std::size_t begin, std::size_t end,
+                                std::size_t grain, const RangeBody& body) {
+  if (end <= begin) return;
+  TaskGroup group(*this);
+  split(group, begin, end, std::max<std::size_t>(grain, 1), body);
+  group.wait();
+}
+
+/**
+ * @brief Runs one pending task in the calling thread.
+ *
+ * A worker takes its own newest task first; any thread then takes tasks
+ * submitted from outside and finally steals the oldest task of a worker.
+ *
+ * @return True if a task was run.
+ */
+bool TaskScheduler::runOne() { return runOne(nullptr); }
+
+/**
+ * @brief Forks a task.
+ *
+ * @param task The task.
+ */
+void TaskGroup::run(TaskScheduler::Task task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++pending_;
+  }
+  scheduler_.push(
+      [this, task = std::move(task)] {
+        std::exception_ptr error;
+        try {
+          task();
+        } catch (...) {
+          error = std::current_exception();
+        }
+        // группа может быть удалена сразу после снятия блокировки
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error && !error_) error_ = error;
+        if (--pending_ == 0) done_.notify_all();
+      },
+      this);
+}
+
+/**
+ * @brief Joins the tasks of the group.
+ *
+ * While tasks are pending the thread runs pending tasks of this group
+ * (including the ones forked by its tasks) and sleeps only when there is
+ * none left to run. Tasks of other groups are never taken, so a thread
+ * waiting for a short loop is never caught by a long unrelated task.
+ *
+ * @throw Any exception thrown by a task of the group.
+ */
+void TaskGroup::wait() {
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (pending_ == 0) break;
+    }
+    if (scheduler_.runOne(this)) continue;
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait_for(lock, std::chrono::microseconds(200),
+                   [this] { return pending_ == 0; });
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (error_) {
+    std::exception_ptr error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Runs one pending task in the calling thread.
+ *
+ * @param group The group the task must belong to (nullptr - any task).
+ * @return True if a task was run.
+ */
+bool TaskScheduler::runOne(const TaskGroup* group) {
+  Task task;
+  if (!take(task, group)) return false;
+  task();
+  return true;
+}
+
+/**
+ * @brief Queues a task: to the own deque of a worker of this scheduler,
+ * otherwise to the shared queue.
+ *
+ * @param task The task.
+ * @param group The group of the task.
+ */
+void TaskScheduler::push(Task task, const TaskGroup* group) {
+  // счётчик растёт раньше очереди, поэтому не бывает меньше её длины
+  ++queued_;
+  if (currentScheduler == this) {
+    Worker& worker = *workers_[currentWorker];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(Job{std::move(task), group});
+  } else {
+    std::lock_guard<std::mutex> lock(injectMutex_);
+    injected_.push_back(Job{std::move(task), group});
+  }
+  // блокировка не даёт уведомлению проскочить мимо засыпающего потока
+  { std::lock_guard<std::mutex> lock(sleepMutex_); }
+  wake_.notify_one();
+}
+
+/**
+ * @brief Takes a task for the calling thread.
+ *
+ * @param task The task taken.
+ * @param group The group the task must belong to (nullptr - any task).
+ * @return True if a task was found.
+ */
+bool TaskScheduler::take(Task& task, const TaskGroup* group) {
+  if (queued_ == 0) return false;
+  std::size_t self = currentScheduler == this ? currentWorker : 0;
+  if (currentScheduler == this) {
+    Worker& worker = *workers_[self];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (takeFrom(worker.tasks, true, group, task)) return true;
+  }
+  {
+    std::lock_guard<std::mutex> lock(injectMutex_);
+    if (takeFrom(injected_, false, group, task)) return true;
+  }
+  for (std::size_t k = 1; k <= workers_.size(); ++k) {
+    Worker& victim = *workers_[(self + k) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (takeFrom(victim.tasks, false, group, task)) return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Removes a task from a queue.
+ *
+ * Without a group the newest or the oldest task is taken; with a group the
+ * newest or the oldest task of the group is searched for.
+ *
+ * @param tasks The queue, locked by the caller.
+ * @param newest Take the newest task (the own deque) or the oldest one.
+ * @param group The group the task must belong to (nullptr - any task).
+ * @param task The task taken.
+ * @return True if a task was found.
+ */
+bool TaskScheduler::takeFrom(std::deque<Job>& tasks, bool newest,
+                             const TaskGroup* group, Task& task) {
+  std::size_t count = tasks.size();
+  for (std::size_t k = 0; k < count; ++k) {
+    std::size_t index = newest ? count - 1 - k : k;
+    if (group != nullptr && tasks[index].group != group) continue;
+    task = std::move(tasks[index].task);
+    tasks.erase(tasks.begin() + index);
+    --queued_;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief The loop of a worker thread: runs tasks, sleeps when there are
+ * none.
+ *
+ * @param index The number of the worker.
+ */
+void TaskScheduler::run(std::size_t index) {
+  currentScheduler = this;
+  currentWorker = index;
+  pin(index);
+  while (true) {
+    if (runOne()) continue;
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+    if (stop_) return;
+  }
+}
+
+/**
+ * @brief Binds a worker to a core if requested and supported.
+ *
+ * @param index The number of the worker.
+ */
+void TaskScheduler::pin(std::size_t index) const {
+#if defined(__linux__)
+  if (!options_.pinWorkers) return;
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(index % cores, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)index;  // на других системах потоки не закрепляются
+#endif
+}
+
+/**
+ * @brief Splits a range in halves, forking the right ones.
+ *
+ * @param group The group of the loop.
+ * @param begin The first index.
+ * @param end The index after the last one.
+ * @param grain The largest part processed by one call of body.
+ * @param body The function processing a subrange.
+ */
+void TaskScheduler::split(TaskGroup& group, std::size_t begin,
+                          std::size_t end, std::size_t grain,
+                          const RangeBody& body) {
+  while (end - begin > grain) {
+    std::size_t middle = begin + (end - begin) / 2;
+    group.run([&group, middle, end, grain, &body] {
+      split(group, middle, end, grain, body);
+    });
+    end = middle;
+  }
+  body(begin, end);
+}
+
+/**
+ * @brief Returns the options of the process-wide scheduler.
+ *
+ * @return The options.
+ */
+SchedulerOptions& TaskScheduler::globalOptions() {
+  static SchedulerOptions options;
+  return options;
+}
+
+/**
+ * @brief Returns the flag set when the process-wide scheduler starts.
+ *
+ * @return The flag.
+ */
+std::atomic<bool>& TaskScheduler::started() {
+  static std::atomic<bool> flag{false};
+  return flag;
+}
+
+}  // namespace s21
@@ -0,0 +1,132 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file task_scheduler.h
+ *
+ * @brief Declaration of the TaskScheduler and TaskGroup classes
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the TaskScheduler class,
+ * which is part of the SmartCalc v2.0 library.
+ * The TaskScheduler class is a process-wide work-stealing thread pool:
+ * every worker has its own deque of tasks, takes its newest task first and
+ * steals the oldest task of another worker when its deque is empty.
+ * TaskGroup forks tasks and joins them; a thread waiting for a group runs
+ * pending tasks of that group instead of blocking, so nested parallel loops
+ * share the same workers and never start more threads than there are
+ * cores, and a waiting thread never picks up unrelated work.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_TASK_SCHEDULER_H
+#define CPP3_S21_SMART_CALC_TASK_SCHEDULER_H
+
+#include <atomic>              // queued_, stop_
+#include <condition_variable>  // wake_, done_
+#include <cstddef>             // size_t
+#include <deque>               // Worker
+#include <exception>           // error_
+#include <functional>          // Task
+#include <memory>              // workers_
+#include <mutex>               // Worker, TaskGroup
+#include <thread>              // Worker
+#include <vector>              // workers_
+
+namespace s21 {
+
+class TaskGroup;
+
+// параметры пула потоков
+struct SchedulerOptions {
+  unsigned workers = 0;     // число рабочих потоков (0 - ядра без одного)
+  bool pinWorkers = false;  // закрепить потоки за ядрами (только Linux)
+};
+
+class TaskScheduler {
+ public:
+  using Task = std::function<void()>;
+  // тело параллельного цикла: полуинтервал индексов [begin, end)
+  using RangeBody = std::function<void(std::size_t, std::size_t)>;
+
+  explicit TaskScheduler(const SchedulerOptions& options = SchedulerOptions());
+  ~TaskScheduler();
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  // Main methods:
+  static TaskScheduler& instance();
+  static void configure(const SchedulerOptions& options);
+
+  void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                   const RangeBody& body);
+  bool runOne();
+
+  // Accessors:
+  std::size_t workerCount() const { return workers_.size(); }
+
+ private:
+  friend class TaskGroup;
+
+  // задача и группа, к которой она относится
+  struct Job {
+    Task task;
+    const TaskGroup* group = nullptr;  // группа задачи (nullptr - нет)
+  };
+
+  // рабочий поток и его очередь задач
+  struct Worker {
+    std::mutex mutex;       // защищает tasks
+    std::deque<Job> tasks;  // свои задачи: новые в конце
+    std::thread thread;     // поток
+  };
+
+  // Auxiliary methods:
+  void push(Task task, const TaskGroup* group = nullptr);
+  bool take(Task& task, const TaskGroup* group = nullptr);
+  bool runOne(const TaskGroup* group);
+  bool takeFrom(std::deque<Job>& tasks, bool newest, const TaskGroup* group,
+                Task& task);
+  void run(std::size_t index);
+  void pin(std::size_t index) const;
+  static void split(TaskGroup& group, std::size_t begin, std::size_t end,
+                    std::size_t grain, const RangeBody& body);
+  static SchedulerOptions& globalOptions();
+  static std::atomic<bool>& started();
+
+  SchedulerOptions options_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::mutex injectMutex_;
+  std::deque<Job> injected_;  // задачи, пришедшие из других потоков
+  std::mutex sleepMutex_;
+  std::condition_variable wake_;
+  std::atomic<std::size_t> queued_{0};  // задачи во всех очередях
+  std::atomic<bool> stop_{false};
+};
+
+class TaskGroup {
+ public:
+  explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::instance());
+  ~TaskGroup();
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  // Main methods:
+  void run(TaskScheduler::Task task);
+  void wait();
+
+ private:
+  TaskScheduler& scheduler_;
+  std::mutex mutex_;  // защищает pending_ и error_
+  std::condition_variable done_;
+  std::size_t pending_ = 0;   // незавершённые задачи группы
+  std::exception_ptr error_;  // первое исключение задачи
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_TASK_SCHEDULER_H
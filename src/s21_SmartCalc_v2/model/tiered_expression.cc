@@ -0,0 +1,223 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file tiered_expression.cc
+ *
+ * @brief Implementation of the TieredExpression class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the implementation of the TieredExpression class,
+ * which is part of the SmartCalc v2.0 library.
+ * The TieredExpression class counts evaluations of a compiled expression
+ * and promotes it from the scalar interpreter to the block interpreter,
+ * the JIT and finally the native backend as it becomes hot.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "tiered_expression.h"
+
+#include <algorithm>  // std::min
+#include <stdexcept>  // std::exception
+#include <thread>     // promote
+
+namespace s21 {
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTOR
+ ******************************************************************************/
+
+/**
+ * @brief Creates an expression that starts in the scalar interpreter.
+ *
+ * @param program The compiled program.
+ * @param policy The thresholds of promotion and the native build options.
+ */
+TieredExpression::TieredExpression(const ExpressionProgram& program,
+                                   const TierPolicy& policy)
+    : program_(program),
+      policy_(policy),
+      state_(std::make_shared<State>()) {
+  state_->backend =
+      std::make_shared<const Backend>(Backend{Tier::Scalar, {}, {}});
+}
+
+/******************************************************************************
+ * MAIN METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Evaluates one output of the expression for a single x value.
+ *
+ * The call is counted for promotion, but a single point is always
+ * calculated by the interpreter: the blocks of JIT and native code would
+ * only add the cost of filling their rows. All tiers give the same values.
+ *
+ * @param x The value of x.
+ * @param output The index of the output.
+ * @return The value of the output (NaN if it cannot be calculated).
+ */
+double TieredExpression::evaluate(double x, std::size_t output) {
+  // исполнитель нужен только для перехода на следующий уровень
+  std::uint64_t total = evaluations_.fetch_add(1) + 1;
+  if (targetTier(total) > state_->tier) acquire(0);
+  return program_.evaluate(x, output);
+}
+
+/**
+ * @brief Evaluates all outputs of the expression for the given x values.
+ *
+ * The current backend is taken with an atomic load, so a promotion done
+ * by another thread never blocks or disturbs this call.
+ *
+ * @param x Pointer to the x values.
+ * @param n The number of values.
+ * @param columns Array of outputCount() pointers to the output columns.
+ */
+void TieredExpression::evaluate(const double* x, std::size_t n,
+                                double* const* columns) {
+  std::shared_ptr<const Backend> backend = acquire(n);
+  switch (backend->tier) {
+    case Tier::Scalar:
+      for (std::size_t k = 0; k < n; ++k) {
+        for (std::size_t j = 0; j < program_.outputCount(); ++j) {
+          columns[j][k] = program_.evaluate(x[k], j);
+        }
+      }
+      break;
+    case Tier::Block:
+      program_.evaluate(x, n, columns);
+      break;
+    case Tier::Jit:
+      backend->jit->evaluate(x, n, columns);
+      break;
+    case Tier::Native:
+      backend->native->evaluate(x, n, columns);
+      break;
+  }
+}
+
+/**
+ * @brief Waits until the background build of native code is finished.
+ */
+void TieredExpression::wait() {
+  std::shared_future<void> build;
+  {
+    std::lock_guard<std::mutex> lock(buildMutex_);
+    build = build_;
+  }
+  if (build.valid()) {
+    build.wait();
+  }
+}
+
+/**
+ * @brief Returns the tier currently used for evaluation.
+ *
+ * @return The current tier.
+ */
+Tier TieredExpression::tier() const {
+  return state_->tier;
+}
+
+/******************************************************************************
+ * AUXILIARY PRIVATE METHODS
+ ******************************************************************************/
+
+/**
+ * @brief Counts the evaluation of n points and returns the backend to use,
+ * promoting the expression first if a threshold has been reached.
+ *
+ * Only one thread promotes at a time; the others keep using the current
+ * backend.
+ *
+ * @param n The number of points to be evaluated.
+ * @return The backend for this evaluation.
+ */
+std::shared_ptr<const TieredExpression::Backend> TieredExpression::acquire(
+    std::size_t n) {
+  std::uint64_t total = evaluations_.fetch_add(n) + n;
+  std::shared_ptr<const Backend> backend = std::atomic_load(&state_->backend);
+  Tier target = targetTier(total);
+  if (target > backend->tier && !state_->promoting.exchange(true)) {
+    promote(backend->tier, target);
+    backend = std::atomic_load(&state_->backend);
+  }
+  return backend;
+}
+
+/**
+ * @brief Chooses the tier for a number of evaluated points.
+ *
+ * @param evaluations The number of evaluated points.
+ * @return The tier the expression should run in.
+ */
+Tier TieredExpression::targetTier(std::uint64_t evaluations) const {
+  if (evaluations >= policy_.nativeAfter && !state_->nativeFailed) {
+    return Tier::Native;
+  }
+  if (evaluations >= policy_.jitAfter || evaluations >= policy_.nativeAfter) {
+    return Tier::Jit;
+  }
+  if (evaluations >= policy_.blockAfter) {
+    return Tier::Block;
+  }
+  return Tier::Scalar;
+}
+
+/**
+ * @brief Publishes a backend of a higher tier.
+ *
+ * The interpreters and the JIT are installed at once, since translation
+ * takes microseconds. Native code is built in a separate thread, not in
+ * TaskScheduler, whose threads would be blocked by the compiler, while
+ * the expression keeps running in the JIT; if the build fails the
+ * expression stays in the JIT.
+ *
+ * @param current The current tier.
+ * @param target The tier to be reached.
+ */
+void TieredExpression::promote(Tier current, Tier target) {
+  std::shared_ptr<JitProgram> jit;
+  if (target >= Tier::Jit) {
+    jit = current >= Tier::Jit ? std::atomic_load(&state_->backend)->jit
+                               : JitProgram::compile(program_);
+  }
+  std::atomic_store(&state_->backend,
+                    std::make_shared<const Backend>(Backend{
+                        std::min(target, Tier::Jit), jit, {}}));
+  state_->tier = std::min(target, Tier::Jit);
+  if (target != Tier::Native) {
+    state_->promoting = false;
+    return;
+  }
+
+  // поток сборки владеет своими данными и общим состоянием: выражение
+  // может быть удалено раньше, чем закончится сборка
+  std::promise<void> done;
+  {
+    std::lock_guard<std::mutex> lock(buildMutex_);
+    build_ = done.get_future().share();
+  }
+  std::thread([state = state_, program = program_, options = policy_.options,
+               jit, done = std::move(done)]() mutable {
+    try {
+      std::shared_ptr<NativeProgram> native =
+          NativeProgram::compile(program, options);
+      std::atomic_store(&state->backend,
+                        std::make_shared<const Backend>(
+                            Backend{Tier::Native, jit, native}));
+      state->tier = Tier::Native;
+    } catch (const std::exception&) {
+      state->nativeFailed = true;
+    }
+    state->promoting = false;
+    done.set_value();
+  }).detach();
+}
+
+}  // namespace s21
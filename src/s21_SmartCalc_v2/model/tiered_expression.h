@@ -0,0 +1,112 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file tiered_expression.h
+ *
+ * @brief Declaration of the TieredExpression class
+ * for the SmartCalc v2.0 library.
+ *
+ * This file contains the declaration of the TieredExpression class,
+ * which is part of the SmartCalc v2.0 library.
+ * The TieredExpression class counts evaluations of a compiled expression
+ * and promotes it from the scalar interpreter to the block interpreter,
+ * the JIT and finally the native backend as it becomes hot.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CPP3_S21_SMART_CALC_TIERED_EXPRESSION_H
+#define CPP3_S21_SMART_CALC_TIERED_EXPRESSION_H
+
+#include <atomic>   // evaluations_, State
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <future>   // build_
+#include <limits>   // TierPolicy
+#include <memory>   // state_
+#include <mutex>    // buildMutex_
+
+#include "expression_program.h"
+#include "jit_program.h"
+#include "native_program.h"
+
+namespace s21 {
+
+// уровень исполнения выражения
+enum class Tier { Scalar, Block, Jit, Native };
+
+// пороги перехода между уровнями (в количестве вычисленных точек)
+struct TierPolicy {
+  // порог, который никогда не достигается
+  static constexpr std::uint64_t kNever =
+      std::numeric_limits<std::uint64_t>::max();
+
+  std::uint64_t blockAfter = 64;  // блочный интерпретатор
+  std::uint64_t jitAfter = 4096;  // машинный код JIT
+  // код системного компилятора: запускает внешний компилятор,
+  // поэтому включается только явно
+  std::uint64_t nativeAfter = kNever;
+  NativeOptions options;  // параметры сборки машинного кода
+};
+
+class TieredExpression {
+ public:
+  // порог, который никогда не достигается
+  static constexpr std::uint64_t kNever = TierPolicy::kNever;
+
+  explicit TieredExpression(const ExpressionProgram& program,
+                            const TierPolicy& policy = TierPolicy());
+  ~TieredExpression() = default;
+  TieredExpression(const TieredExpression&) = delete;
+  TieredExpression& operator=(const TieredExpression&) = delete;
+
+  // Main methods:
+  double evaluate(double x, std::size_t output = 0);
+  void evaluate(const double* x, std::size_t n, double* const* columns);
+  void wait();
+
+  // Accessors:
+  Tier tier() const;
+  std::uint64_t evaluations() const { return evaluations_.load(); }
+  std::size_t outputCount() const { return program_.outputCount(); }
+
+ private:
+  // исполнитель выражения на одном уровне; после публикации не меняется
+  struct Backend {
+    Tier tier;                              // уровень
+    std::shared_ptr<JitProgram> jit;        // код JIT (уровни Jit, Native)
+    std::shared_ptr<NativeProgram> native;  // код компилятора (Native)
+  };
+
+  // состояние, общее с фоновой сборкой: сборка держит его сама,
+  // поэтому выражение удаляется, не дожидаясь компилятора
+  struct State {
+    std::shared_ptr<const Backend> backend;  // текущий исполнитель
+    // уровень исполнителя: читается без блокировки, в отличие от backend
+    std::atomic<Tier> tier{Tier::Scalar};
+    std::atomic<bool> promoting{false};      // идёт переход на новый уровень
+    std::atomic<bool> nativeFailed{false};   // сборка компилятором не удалась
+  };
+
+  // Auxiliary methods:
+  std::shared_ptr<const Backend> acquire(std::size_t n);
+  Tier targetTier(std::uint64_t evaluations) const;
+  void promote(Tier current, Tier target);
+
+  ExpressionProgram program_;
+  TierPolicy policy_;
+  std::shared_ptr<State> state_;
+  std::atomic<std::uint64_t> evaluations_{0};
+  std::mutex buildMutex_;
+  // фоновая сборка машинного кода в отдельном потоке: она ждёт компилятор
+  // секундами и не должна занимать потоки TaskScheduler
+  std::shared_future<void> build_;
+};
+
+}  // namespace s21
+
+#endif  // CPP3_S21_SMART_CALC_TIERED_EXPRESSION_H
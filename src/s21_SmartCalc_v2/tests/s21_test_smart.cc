@@ -1,7 +1,33 @@
+#include <sys/stat.h>  // native.compile1
+
+#include <algorithm>  // sched.parallel1
+#include <atomic>     // threads.shared1, sched.parallel1
+#include <chrono>     // sched.isolation1
+#include <cstring>    // lod.persist1
+#include <ctime>      // threads.credit1
+#include <fstream>    // lod.persist1, mapped.foreign1
+#include <iterator>   // lod.persist1, mapped.foreign1
+#include <thread>     // threads.shared1, threads.deposit1, threads.credit1,
+                      // sched.isolation1
+
+#include "../model/calendar.h"
+#include "../model/chebyshev_proxy.h"
+#include "../model/credit_simulator.h"
+#include "../model/expression_program.h"
+#include "../model/jit_program.h"
+#include "../model/lod_pyramid.h"
+#include "../model/mapped_series.h"
 #include "../model/model_calculator.h"
 #include "../model/model_credit.h"
+#include "../model/model_curve.h"
 #include "../model/model_deposit.h"
+#include "../model/money.h"
+#include "../model/native_program.h"
 #include "../model/polish_notation.h"
+#include "../model/register_program.h"
+#include "../model/static_expression.h"
+#include "../model/task_scheduler.h"
+#include "../model/tiered_expression.h"
 #include "../controller/calc_controller.h"
 #include "gtest/gtest.h"
 
@@ -393,6 +419,357 @@ TEST_F(CreditModelTest, DifferentialPaymentCalculation) {
   EXPECT_NEAR(payments[0].const_payment, 83333.3, 1.0); // Updated expected value with tolerance
 }
 
+TEST_F(CreditModelTest, DifferentialSummary) {
+  s21::CrInput in = {1000000, 240, 9.5};
+  double first_month_pay = 0;
+  s21::CrOutput out = {0, 0};
+  s21::PaymentVector payments;
+  credit_model.calculateCredit(s21::DIFFERENTIAL, in, first_month_pay, out, payments);
+
+  s21::CrSummary summary = credit_model.summarizeCredit(s21::DIFFERENTIAL, in);
+  EXPECT_NEAR(summary.total, out.total, 1e-6);
+  EXPECT_NEAR(summary.overpayment, out.overpayment, 1e-6);
+  EXPECT_NEAR(summary.first_pay, first_month_pay, 1e-9);
+  EXPECT_NEAR(summary.last_pay, payments.back().monthly_pay, 1e-6);
+
+  summary = credit_model.summarizeCredit(s21::ANNUITY, {1000000, 12, 10});
+  EXPECT_NEAR(summary.first_pay, 87915.89, 0.01);
+  EXPECT_NEAR(summary.last_pay, 87915.89, 0.01);
+  EXPECT_NEAR(summary.total, 1054990.68, 0.01);
+  EXPECT_THROW(credit_model.summarizeCredit(s21::DIFFERENTIAL, {1000, 0, 10}),
+               std::invalid_argument);
+}
+
+TEST_F(CreditModelTest, LazySchedule) {
+  s21::CrInput in = {1000000, 480, 12};
+  s21::PaymentSchedule rows =
+      credit_model.schedule(s21::DIFFERENTIAL, in, {2024, 1, 31});
+  double total = 0;
+  int count = 0;
+  s21::ScheduleRow last{};
+  for (const s21::ScheduleRow& row : rows) {
+    total += row.monthly_pay;
+    last = row;
+    ++count;
+  }
+  EXPECT_EQ(count, 480);
+  EXPECT_NEAR(total, credit_model.summarizeCredit(s21::DIFFERENTIAL, in).total,
+              1e-6);
+  EXPECT_NEAR(last.total_reminder, 0, 1e-6);
+  // число платежа сохраняется после коротких месяцев
+  auto it = rows.begin();
+  EXPECT_EQ(s21::CreditModel::formatDate((*it++).date), "31.01.2024");
+  EXPECT_EQ(s21::CreditModel::formatDate((*it++).date), "29.02.2024");
+  EXPECT_EQ(s21::CreditModel::formatDate(it->date), "31.03.2024");
+
+  // аннуитет гасит долг с точностью округления платежа
+  s21::PaymentSchedule annuity =
+      credit_model.schedule(s21::ANNUITY, {1000000, 12, 10}, {2024, 5, 15});
+  for (const s21::ScheduleRow& row : annuity) last = row;
+  EXPECT_NEAR(last.monthly_pay, 87915.89, 0.01);
+  EXPECT_NEAR(last.total_reminder, 0, 1.0);
+}
+
+TEST_F(CreditModelTest, EarlyRepayments) {
+  s21::CrInput in = {6000000, 360, 9};
+  const s21::RepaymentVector events = {
+      {120, 300000, s21::RepaymentMode::ReducePayment},
+      {24, 500000, s21::RepaymentMode::ReduceTerm},
+      {60, 400000, s21::RepaymentMode::ReduceTerm},
+      {60, 100000, s21::RepaymentMode::ReducePayment},
+      {200, 250000, s21::RepaymentMode::ReduceTerm},
+      {500, 1000, s21::RepaymentMode::ReduceTerm}};
+  s21::AnnuityPlan plan = credit_model.planAnnuity(in, events);
+  ASSERT_EQ(plan.segments.size(), 5u);
+  EXPECT_LT(plan.term, 360);
+
+  // пересчёт по событиям совпадает с помесячным графиком
+  s21::PaymentColumns columns;
+  double first_pay = 0;
+  s21::CrOutput out = {0, 0};
+  credit_model.calculateCredit(in, events, first_pay, out, columns);
+  ASSERT_EQ(columns.size(), static_cast<size_t>(plan.term));
+  double total = 0;
+  for (double pay : columns.monthly_pay) total += pay;
+  EXPECT_NEAR(total, plan.total, 1e-4);
+  EXPECT_NEAR(out.overpayment, plan.total - in.credit, 1e-9);
+  EXPECT_NEAR(columns.total_reminder.back(), 0, 1e-4);
+  EXPECT_NEAR(columns.total_reminder[23],
+              plan.segments[1].debt, 1e-4);
+  EXPECT_NEAR(first_pay, 48277.36, 0.01);
+  // уменьшение платежа после 120-го месяца
+  EXPECT_LT(columns.monthly_pay[120], columns.monthly_pay[118]);
+
+  // полное погашение заканчивает кредит
+  plan = credit_model.planAnnuity(
+      in, {{36, 1e9, s21::RepaymentMode::ReduceTerm}});
+  EXPECT_EQ(plan.term, 36);
+  ASSERT_EQ(plan.segments.size(), 1u);
+  EXPECT_THROW(credit_model.planAnnuity(
+                   in, {{0, 1000, s21::RepaymentMode::ReduceTerm}}),
+               std::invalid_argument);
+
+  // без событий последний платёж возвращает переплату от округления
+  s21::PaymentVector payments;
+  credit_model.calculateCredit(s21::ANNUITY, in, first_pay, out, payments);
+  ASSERT_EQ(payments.size(), 360u);
+  plan = credit_model.planAnnuity(in, {});
+  EXPECT_NEAR(plan.total, out.total + payments.back().total_reminder, 1e-4);
+}
+
+TEST_F(CreditModelTest, BatchPricing) {
+  s21::CreditPortfolio portfolio;
+  unsigned seed = 12345;
+  auto next = [&seed]() { return seed = seed * 1103515245u + 12345u; };
+  for (int i = 0; i < 50000; ++i) {
+    portfolio.credit.push_back(1000 + next() % 10000000 + (next() % 100) / 100.0);
+    portfolio.term.push_back(1 + next() % 480);
+    portfolio.rate.push_back(i % 97 == 0 ? 0 : (next() % 3000) / 100.0);
+    portfolio.type.push_back(next() % 3 == 0 ? s21::DIFFERENTIAL : s21::ANNUITY);
+  }
+  portfolio.credit.push_back(1000);
+  portfolio.term.push_back(0);
+  portfolio.rate.push_back(10);
+  portfolio.type.push_back(s21::ANNUITY);
+
+  s21::PortfolioQuotes quotes;
+  s21::CreditModel::priceBatch(portfolio, quotes);
+  ASSERT_EQ(quotes.total.size(), portfolio.credit.size());
+  int exact = 0;
+  for (size_t i = 0; i + 1 < portfolio.credit.size(); ++i) {
+    s21::CrSummary summary = credit_model.summarizeCredit(
+        portfolio.type[i],
+        {portfolio.credit[i], portfolio.term[i], portfolio.rate[i]});
+    // округление до копеек может разойтись лишь на границе копейки
+    ASSERT_NEAR(quotes.monthly_pay[i], summary.first_pay, 0.0100001);
+    ASSERT_NEAR(quotes.total[i], summary.total,
+                0.0100001 * portfolio.term[i]);
+    exact += quotes.monthly_pay[i] == summary.first_pay &&
+             quotes.total[i] == summary.total &&
+             quotes.overpayment[i] == summary.overpayment;
+  }
+  // ядра не совпадают с std::pow побитно: расхождение на копейку
+  // допускается у редких кредитов на границе копейки (с glibc их нет)
+  EXPECT_GE(exact, 49990);
+  EXPECT_TRUE(std::isnan(quotes.monthly_pay.back()));
+
+  portfolio.term.pop_back();
+  EXPECT_THROW(s21::CreditModel::priceBatch(portfolio, quotes),
+               std::invalid_argument);
+}
+
+TEST_F(CreditModelTest, MoneyLedger) {
+  s21::CrInput in = {1234567.89, 37, 11.3};
+  for (s21::TypeOfMonthlyPayments type : {s21::ANNUITY, s21::DIFFERENTIAL}) {
+    double monthly_pay = 0;
+    s21::CrOutput out;
+    s21::PaymentColumns payments;
+    credit_model.calculateCredit(type, in, monthly_pay, out, payments);
+
+    // в double график совпадает с обычным, кроме закрывающего платежа
+    s21::CreditLedger<double> doubles;
+    s21::CreditModel::calculateLedger(type, in, doubles);
+    ASSERT_EQ(doubles.monthly_pay.size(), payments.size());
+    EXPECT_EQ(doubles.monthly_pay.front(), monthly_pay);
+    EXPECT_NEAR(doubles.total, out.total, 0.01 * in.term);
+    EXPECT_NEAR(doubles.total_reminder.back(), 0, 1e-6);
+
+    // в копейках суммы сходятся без погрешности
+    s21::CreditLedger<s21::Money> money;
+    s21::CreditModel::calculateLedger(type, in, money);
+    s21::Money total, principal;
+    for (size_t i = 0; i < money.monthly_pay.size(); ++i) {
+      EXPECT_EQ(money.monthly_pay[i],
+                money.interest_pay[i] + money.const_payment[i]);
+      total += money.monthly_pay[i];
+      principal += money.const_payment[i];
+      EXPECT_NEAR(money.monthly_pay[i].toDouble(), payments.monthly_pay[i],
+                  i + 1 < payments.size() ? 0.02 : 1);
+    }
+    EXPECT_EQ(total, money.total);
+    EXPECT_EQ(principal, s21::Money::fromMinor(123456789));
+    EXPECT_EQ(money.total_reminder.back(), s21::Money());
+    EXPECT_EQ(money.overpayment, money.total - principal);
+    EXPECT_NEAR(money.total.toDouble(), doubles.total, 0.01 * in.term);
+  }
+  s21::CreditLedger<s21::Money> nearest, ledger;
+  s21::CreditModel::calculateLedger(s21::ANNUITY, in, nearest);
+  s21::CreditModel::calculateLedger(s21::ANNUITY, in, ledger,
+                                    s21::Rounding::Up);
+  s21::Money step = ledger.monthly_pay.front() - nearest.monthly_pay.front();
+  EXPECT_TRUE(step == s21::Money() || step == s21::Money::fromMinor(1));
+  EXPECT_GE(ledger.interest_pay.front(), nearest.interest_pay.front());
+
+  // 1000 рублей на 600 месяцев: доля 1/600 с округлением вверх (17 копеек)
+  // превышает кредит, но остаток долга не уходит ниже нуля
+  s21::CrInput small = {1000.0, 600, 12};
+  for (s21::TypeOfMonthlyPayments type : {s21::ANNUITY, s21::DIFFERENTIAL}) {
+    s21::CreditModel::calculateLedger(type, small, ledger, s21::Rounding::Up);
+    s21::Money principal;
+    for (size_t i = 0; i < ledger.total_reminder.size(); ++i) {
+      ASSERT_GE(ledger.total_reminder[i], s21::Money()) << i;
+      ASSERT_GE(ledger.const_payment[i], s21::Money()) << i;
+      principal += ledger.const_payment[i];
+    }
+    EXPECT_EQ(ledger.total_reminder.back(), s21::Money());
+    EXPECT_EQ(principal, s21::Money::fromMinor(100000));
+  }
+  in.term = 0;
+  EXPECT_THROW(s21::CreditModel::calculateLedger(s21::ANNUITY, in, ledger),
+               std::invalid_argument);
+}
+
+TEST_F(CreditModelTest, SensitivityGrid) {
+  s21::CreditGridAxes axes;
+  for (int i = 0; i < 300; ++i) axes.rate.push_back(i * 0.1);
+  axes.term = {1, 2, 12, 60, 360};
+  axes.credit = {1000, 123456.78, 6000000};
+  for (s21::TypeOfMonthlyPayments type : {s21::ANNUITY, s21::DIFFERENTIAL}) {
+    s21::CreditCube cube;
+    s21::CreditModel::priceGrid(type, axes, cube);
+    ASSERT_EQ(cube.monthly_pay.size(), 300u * 5 * 3);
+    // каждый узел совпадает с пакетным расчётом того же кредита
+    s21::CreditPortfolio portfolio;
+    for (size_t k = 0; k < 3; ++k) {
+      for (size_t t = 0; t < 5; ++t) {
+        for (size_t r = 0; r < 300; ++r) {
+          portfolio.credit.push_back(axes.credit[k]);
+          portfolio.term.push_back(axes.term[t]);
+          portfolio.rate.push_back(axes.rate[r]);
+          portfolio.type.push_back(type);
+        }
+      }
+    }
+    s21::PortfolioQuotes quotes;
+    s21::CreditModel::priceBatch(portfolio, quotes);
+    EXPECT_EQ(cube.monthly_pay, quotes.monthly_pay);
+    EXPECT_EQ(cube.total, quotes.total);
+    EXPECT_EQ(cube.overpayment, quotes.overpayment);
+  }
+  s21::CreditCube cube;
+  s21::CreditModel::priceGrid(s21::ANNUITY, axes, cube);
+  EXPECT_EQ(cube.monthly_pay[cube.index(120, 2, 1)],
+            credit_model.summarizeCredit(s21::ANNUITY, {123456.78, 12, 12})
+                .first_pay);
+  axes.term.push_back(0);
+  EXPECT_THROW(s21::CreditModel::priceGrid(s21::ANNUITY, axes, cube),
+               std::invalid_argument);
+}
+
+TEST_F(CreditModelTest, InverseSolvers) {
+  // аннуитет 1 000 000 на 120 месяцев под 9.5%: ставка восстанавливается
+  double pay = 1000000 * (9.5 / 1200) / (1 - pow(1 + 9.5 / 1200, -120));
+  s21::CrSolution rate =
+      s21::CreditModel::solveRate(s21::ANNUITY, 1000000, 120, pay);
+  EXPECT_NEAR(rate.value, 9.5, 1e-9);
+  EXPECT_LE(rate.iterations, 6);
+  EXPECT_NEAR(s21::CreditModel::solveRate(s21::ANNUITY, 1200, 12, 100).value,
+              0, 1e-12);
+  EXPECT_NEAR(s21::CreditModel::solveRate(s21::DIFFERENTIAL, 120000, 12,
+                                          11200).value,
+              12, 1e-9);
+  EXPECT_THROW(s21::CreditModel::solveRate(s21::ANNUITY, 1200, 12, 99),
+               std::invalid_argument);
+  EXPECT_THROW(s21::CreditModel::solveRate(s21::ANNUITY, 1200, 0, 200),
+               std::invalid_argument);
+
+  // срок: наименьший, при котором платёж не больше заданного
+  s21::CrSolution term =
+      s21::CreditModel::solveTerm(s21::ANNUITY, 1000000, 9.5, pay);
+  EXPECT_EQ(term.value, 120);
+  EXPECT_LE(term.iterations, 3);
+  EXPECT_EQ(s21::CreditModel::solveTerm(s21::ANNUITY, 1000000, 9.5, pay - 1)
+                .value,
+            121);
+  EXPECT_EQ(s21::CreditModel::solveTerm(s21::ANNUITY, 1200, 0, 100).value, 12);
+  EXPECT_EQ(
+      s21::CreditModel::solveTerm(s21::DIFFERENTIAL, 120000, 12, 11200).value,
+      12);
+  EXPECT_EQ(
+      s21::CreditModel::solveTerm(s21::DIFFERENTIAL, 120000, 12, 11199).value,
+      13);
+  EXPECT_THROW(s21::CreditModel::solveTerm(s21::ANNUITY, 120000, 12, 1200),
+               std::invalid_argument);
+
+  // сумма кредита линейна по платежу
+  EXPECT_NEAR(
+      s21::CreditModel::solvePrincipal(s21::ANNUITY, 120, 9.5, pay).value,
+      1000000, 1e-6);
+  EXPECT_NEAR(
+      s21::CreditModel::solvePrincipal(s21::DIFFERENTIAL, 12, 12, 11200).value,
+      120000, 1e-6);
+  EXPECT_NEAR(s21::CreditModel::solvePrincipal(s21::ANNUITY, 12, 0, 100).value,
+              1200, 1e-9);
+  EXPECT_THROW(s21::CreditModel::solvePrincipal(s21::ANNUITY, 0, 9.5, 100),
+               std::invalid_argument);
+
+  s21::CreditPortfolio portfolio;
+  std::vector<double> payments;
+  for (int i = 0; i < 2000; ++i) {
+    double annual = (i % 300) / 10.0;
+    int months = 1 + i % 360;
+    portfolio.credit.push_back(10000 + 37 * i);
+    portfolio.term.push_back(months);
+    portfolio.rate.push_back(annual);
+    portfolio.type.push_back(i % 2 ? s21::DIFFERENTIAL : s21::ANNUITY);
+    // точный платёж: кредит, делённый на сумму кредита при платеже 1
+    payments.push_back(portfolio.credit[i] /
+                       s21::CreditModel::solvePrincipal(portfolio.type[i],
+                                                        months, annual, 1)
+                           .value);
+  }
+  payments.push_back(1);
+  portfolio.credit.push_back(1000000);
+  portfolio.term.push_back(12);
+  portfolio.rate.push_back(10);
+  portfolio.type.push_back(s21::ANNUITY);
+  s21::CreditPortfolio solved = portfolio;
+  s21::CreditModel::solveBatch(s21::SolveFor::Rate, payments, solved);
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_NEAR(solved.rate[i], portfolio.rate[i], 1e-7) << i;
+  }
+  EXPECT_TRUE(std::isnan(solved.rate.back()));
+  payments.pop_back();
+  EXPECT_THROW(
+      s21::CreditModel::solveBatch(s21::SolveFor::Term, payments, solved),
+      std::invalid_argument);
+}
+
+TEST_F(CreditModelTest, ColumnarSchedule) {
+  s21::CrInput in = {1200000, 36, 12};
+  double first_month_pay = 0, columns_first_pay = 0;
+  s21::CrOutput out = {0, 0}, columns_out = {0, 0};
+  s21::PaymentVector payments;
+  s21::PaymentColumns columns;
+  credit_model.calculateCredit(s21::DIFFERENTIAL, in, first_month_pay, out, payments);
+  credit_model.calculateCredit(s21::DIFFERENTIAL, in, columns_first_pay, columns_out, columns);
+
+  ASSERT_EQ(columns.size(), payments.size());
+  EXPECT_DOUBLE_EQ(columns_first_pay, first_month_pay);
+  EXPECT_NEAR(columns_out.total, out.total, 1e-6);
+  double interest = 0;
+  for (size_t i = 0; i < payments.size(); ++i) {
+    EXPECT_EQ(s21::CreditModel::formatDate(
+                  s21::CreditModel::fromDayNumber(columns.day[i])),
+              payments[i].date);
+    EXPECT_DOUBLE_EQ(columns.total_reminder[i], payments[i].total_reminder);
+    interest += columns.interest_pay[i];
+  }
+  // проценты по годам в сумме дают переплату
+  int year = s21::CreditModel::fromDayNumber(columns.day.front()).year;
+  double byYears = 0;
+  for (int y = year; y <= year + 3; ++y) byYears += columns.interestInYear(y);
+  EXPECT_NEAR(byYears, interest, 1e-6);
+  EXPECT_DOUBLE_EQ(columns.interestInYear(year - 1), 0);
+
+  EXPECT_EQ(s21::CreditModel::toDayNumber({1970, 1, 1}), 0);
+  EXPECT_EQ(s21::CreditModel::toDayNumber({2000, 3, 1}), 11017);
+  for (std::int32_t day = -800000; day < 800000; day += 997) {
+    EXPECT_EQ(s21::CreditModel::toDayNumber(
+                  s21::CreditModel::fromDayNumber(day)), day);
+  }
+}
+
 
 namespace s21 {
 
@@ -433,6 +810,41 @@ TEST_F(DepositModelTest, CalculateDepositWithoutChanges) {
   EXPECT_NEAR(out.remainderDeposit, expected_remainder_deposit, 1.01);
 }
 
+TEST_F(DepositModelTest, MoneyDeposit) {
+  TimePoint now = std::chrono::system_clock::now();
+  Input in = {100000, 10, 13, 12, true, Period::EveryMonth,
+              {{now + std::chrono::hours(24 * 40), 5000.55}}, {}, now,
+              100000};
+  Output out;
+  deposit_model.calculateDeposit(in, out);
+
+  BasicInput<Money> cents = {Money::fromMinor(10000000),
+                             10,
+                             13,
+                             12,
+                             true,
+                             Period::EveryMonth,
+                             {{now + std::chrono::hours(24 * 40),
+                               Money::fromMinor(500055)}},
+                             {},
+                             now,
+                             100000};
+  BasicOutput<Money> money;
+  BasicDepositModel<Money>().calculateDeposit(cents, money);
+
+  // выплаты округлены до копеек, остаток - их точная сумма
+  ASSERT_EQ(money.report.size(), out.report.size());
+  Money balance;
+  for (const BasicReport<Money>& row : money.report) {
+    balance += row.addition;
+    EXPECT_EQ(row.remainder, balance);
+  }
+  EXPECT_EQ(money.remainderDeposit, balance);
+  EXPECT_NEAR(money.remainderDeposit.toDouble(), out.remainderDeposit, 0.1);
+  EXPECT_NEAR(money.totalPercents.toDouble(), out.totalPercents, 0.1);
+  EXPECT_EQ(money.totalTax, Money());
+}
+
 // TEST_F(DepositModelTest, CalculateDepositWithAdditions) {
 //   Input in = {
 //       100000,  // deposit
@@ -505,8 +917,1068 @@ TEST_F(DepositModelTest, CalculateDepositWithoutChanges) {
 
 }  // namespace s21
 
+TEST(fused, program1) {
+  s21::ExpressionProgram program =
+      s21::ExpressionProgram::compile(s21::StringVector{"sin(x)+1", "sin(x)*2"});
+  // x, sin(x), 1, +, 2, * -- sin(x) хранится один раз
+  ASSERT_EQ(program.outputCount(), 2u);
+  ASSERT_EQ(program.size(), 6u);
+  ASSERT_DOUBLE_EQ(program.evaluate(0.5, 0), std::sin(0.5) + 1);
+  ASSERT_DOUBLE_EQ(program.evaluate(0.5, 1), std::sin(0.5) * 2);
+}
+
+TEST(fused, program2) {
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile("2^3+x");
+  // 2^3 сворачивается в константу
+  ASSERT_EQ(program.size(), 3u);
+  ASSERT_DOUBLE_EQ(program.evaluate(1), 9);
+  ASSERT_TRUE(std::isnan(s21::ExpressionProgram::compile("1/x").evaluate(0)));
+  ASSERT_ANY_THROW(s21::ExpressionProgram::compile("2+"));
+  ASSERT_ANY_THROW(s21::ExpressionProgram::compile(s21::StringVector{}));
+}
+
+TEST(fused, grafs1) {
+  s21::ModelCalculator semple;
+  s21::StringVector infixes = {"x^2", "ln(x)", "1/x", "sqrt(x)+x^2"};
+  s21::Vector answer =
+      semple.calculateGrafs({-2, 2}, {-10, 10}, 1000, infixes);
+  ASSERT_EQ(answer.size(), 5u);
+  for (size_t i = 0; i < 1000; i++) {
+    double x = answer[0][i];
+    for (size_t j = 0; j < infixes.size(); j++) {
+      double expected;
+      try {
+        expected = semple.calculate(infixes[j], x);
+      } catch (...) {
+        expected = NAN;
+      }
+      if (!(expected >= -10 && expected <= 10)) expected = NAN;
+      if (std::isnan(expected)) {
+        ASSERT_TRUE(std::isnan(answer[j + 1][i]));
+      } else {
+        ASSERT_DOUBLE_EQ(answer[j + 1][i], expected);
+      }
+    }
+  }
+}
 
+TEST(fused, grafs2) {
+  s21::ModelCalculator semple;
+  ASSERT_ANY_THROW(semple.calculateGrafs({2, -2}, {-10, 10}, 10, {"x"}));
+  ASSERT_ANY_THROW(semple.calculateGrafs({-2, 2}, {100, 200}, 10, {"x"}));
+}
+
+TEST(curve, parametric1) {
+  s21::CurveModel curve_model;
+  s21::CurveInput in = {{0, 2 * M_PI}, "cos(3*x)", "sin(2*x)", 0.01, 0.01,
+                        1.0, 16, 1u << 20};
+  s21::Vector curve = curve_model.calculateParametric(in);
+  ASSERT_EQ(curve.size(), 3u);
+  ASSERT_GT(curve[0].size(), 17u);
+  for (size_t i = 0; i < curve[0].size(); i++) {
+    ASSERT_DOUBLE_EQ(curve[1][i], std::cos(3 * curve[0][i]));
+    ASSERT_DOUBLE_EQ(curve[2][i], std::sin(2 * curve[0][i]));
+    if (i > 0) {
+      ASSERT_LT(curve[0][i - 1], curve[0][i]);
+      double length = std::hypot(curve[1][i] - curve[1][i - 1],
+                                 curve[2][i] - curve[2][i - 1]);
+      ASSERT_LE(length, 0.01 + 1e-12);
+    }
+  }
+}
+
+TEST(curve, polar1) {
+  s21::CurveModel curve_model;
+  s21::CurveInput in = {{0, M_PI}, "cos(4*x)", "", 0.001, 0.001, 2.0, 8,
+                        1000};
+  s21::Vector curve = curve_model.calculatePolar(in);
+  // ограничение на число точек соблюдается
+  ASSERT_LE(curve[0].size(), 1000u);
+  for (size_t i = 0; i < curve[0].size(); i++) {
+    double r = std::cos(4 * curve[0][i]);
+    ASSERT_NEAR(curve[1][i], r * std::cos(curve[0][i]), 1e-12);
+    ASSERT_NEAR(curve[2][i], r * std::sin(curve[0][i]), 1e-12);
+  }
+}
+
+TEST(curve, invalid1) {
+  s21::CurveModel curve_model;
+  s21::CurveInput in = {{1, 0}, "x", "x", 0.01, 0.01, 1.0, 16, 100};
+  ASSERT_ANY_THROW(curve_model.calculateParametric(in));
+  in.tRange = {0, 1};
+  in.second = "x+";
+  ASSERT_ANY_THROW(curve_model.calculateParametric(in));
+}
+
+TEST(lod, query1) {
+  const size_t n = 100000;
+  std::vector<double> x(n), y(n);
+  for (size_t i = 0; i < n; i++) {
+    x[i] = i * 0.001;
+    y[i] = i % 97 == 0 ? NAN : std::sin(x[i] * 7) * x[i];
+  }
+  s21::LodPyramid pyramid;
+  pyramid.build(y.data(), n, 8);
+  ASSERT_EQ(pyramid.levels().back().min.size(), 1u);
+
+  s21::LodSlice slice =
+      pyramid.query(x.data(), y.data(), n, 3.3, 77.7, 300);
+  // сравниваем с полным перебором точек
+  double width = (77.7 - 3.3) / 300;
+  for (unsigned p = 0; p < 300; p++) {
+    double lo = NAN, hi = NAN;
+    for (size_t i = 0; i < n; i++) {
+      double left = 3.3 + p * width, right = 3.3 + (p + 1) * width;
+      bool inside = x[i] >= left && (p + 1 == 300 ? x[i] <= 77.7 : x[i] < right);
+      if (inside) {
+        lo = std::fmin(lo, y[i]);
+        hi = std::fmax(hi, y[i]);
+      }
+    }
+    ASSERT_DOUBLE_EQ(slice.min[p], lo);
+    ASSERT_DOUBLE_EQ(slice.max[p], hi);
+  }
+}
+
+TEST(lod, persist1) {
+  std::vector<double> y(5000);
+  for (size_t i = 0; i < y.size(); i++) y[i] = std::cos(i * 0.01);
+  s21::LodPyramid pyramid, loaded;
+  pyramid.build(y.data(), y.size(), 2);
+  std::string path = testing::TempDir() + "s21_lod_test.bin";
+  pyramid.save(path);
+  loaded.load(path, y.size());
+  ASSERT_EQ(loaded.factor(), 2u);
+  ASSERT_EQ(loaded.levels().size(), pyramid.levels().size());
+  for (size_t l = 0; l < loaded.levels().size(); l++) {
+    ASSERT_EQ(loaded.levels()[l].max, pyramid.levels()[l].max);
+  }
+  ASSERT_ANY_THROW(loaded.load(path, y.size() + 1));
+
+  // испорченные группы и число записей уровня не принимаются
+  std::ifstream in(path, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)),
+                    std::istreambuf_iterator<char>());
+  in.close();
+  // заголовок: сигнатура, factor, size, count; затем bucket и entries
+  const std::size_t bucket = 8 + 4 + 8 + 8, entries = bucket + 8;
+  auto corrupt = [&](std::size_t offset, std::uint64_t value) {
+    std::string damaged = bytes;
+    std::memcpy(&damaged[offset], &value, sizeof(value));
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << damaged;
+    return path;
+  };
+  ASSERT_THROW(loaded.load(corrupt(bucket, 0), y.size()), std::runtime_error);
+  ASSERT_THROW(loaded.load(corrupt(bucket, 1), y.size()), std::runtime_error);
+  ASSERT_THROW(loaded.load(corrupt(entries, 2499), y.size()),
+               std::runtime_error);
+  // второй уровень с той же группой, что и первый
+  std::size_t next = entries + 8 + 2 * 2500 * sizeof(double);
+  ASSERT_THROW(loaded.load(corrupt(next, 2), y.size()), std::runtime_error);
+  ASSERT_NO_THROW(loaded.load(corrupt(next, 4), y.size()));
+  std::remove(path.c_str());
+}
+
+TEST(mapped, append1) {
+  std::string path = testing::TempDir() + "s21_mapped_test.bin";
+  std::vector<double> values(3000);
+  for (size_t i = 0; i < values.size(); i++) values[i] = i * 0.5;
+  {
+    s21::MappedSeries series(path, 100);
+    // фрагмент округляется до целого числа страниц
+    ASSERT_GE(series.chunkPoints(), 100u);
+    series.append(values.data(), 1000);
+    series.append(values.data() + 1000, 2000);
+    ASSERT_EQ(series.size(), 3000u);
+    ASSERT_EQ(std::vector<double>(series.data(), series.data() + 3000),
+              values);
+  }
+  s21::MappedSeries reopened = s21::MappedSeries::open(path);
+  ASSERT_EQ(reopened.size(), 3000u);
+  ASSERT_DOUBLE_EQ(reopened.data()[2999], 1499.5);
+  reopened.append(values.data(), 1);
+  ASSERT_EQ(reopened.size(), 3001u);
+  ASSERT_DOUBLE_EQ(reopened.data()[3000], 0);
+  std::remove(path.c_str());
+  ASSERT_ANY_THROW(s21::MappedSeries::open(path));
+}
+
+TEST(mapped, foreign1) {
+  // файл не ряда не изменяется при неудачном открытии
+  std::string path = testing::TempDir() + "s21_mapped_foreign.txt";
+  const std::string text(100000, 'x');
+  std::ofstream(path, std::ios::binary) << text;
+  ASSERT_THROW(s21::MappedSeries::open(path), std::runtime_error);
+  std::ifstream in(path, std::ios::binary);
+  std::string after((std::istreambuf_iterator<char>(in)),
+                    std::istreambuf_iterator<char>());
+  ASSERT_EQ(after, text);
+  std::remove(path.c_str());
+}
+
+TEST(mapped, graf1) {
+  s21::ModelCalculator semple;
+  std::string prefix = testing::TempDir() + "s21_graf_test";
+  s21::MappedGraf graf = semple.calculateGrafToFiles(
+      {-1, 1}, 5000, {"x^2", "1/x"}, prefix);
+  std::vector<s21::MappedSeries>& series = graf.series;
+  ASSERT_EQ(series.size(), 3u);
+  s21::Vector table = s21::ExpressionProgram::compile(
+      s21::StringVector{"x^2", "1/x"}).evaluateGrid({-1, 1}, 5000);
+  for (size_t j = 0; j < series.size(); j++) {
+    ASSERT_EQ(series[j].size(), 5000u);
+    const double* data = series[j].data();
+    for (size_t i = 0; i < 5000; i++) {
+      if (std::isnan(table[j][i])) {
+        ASSERT_TRUE(std::isnan(data[i]));
+      } else {
+        ASSERT_DOUBLE_EQ(data[i], table[j][i]);
+      }
+    }
+  }
+  // пирамиды построены по отображённым данным и сохранены рядом с ними
+  ASSERT_EQ(graf.pyramids.size(), 2u);
+  ASSERT_EQ(graf.pyramids[0].size(), 5000u);
+  s21::LodSlice slice = graf.pyramids[0].query(
+      series[0].data(), series[1].data(), series[1].size(), -1, 1, 10);
+  ASSERT_DOUBLE_EQ(slice.max[0], 1);
+  s21::MappedGraf opened = s21::ModelCalculator::openGrafFiles(prefix, 2);
+  ASSERT_EQ(opened.series.size(), 3u);
+  ASSERT_EQ(opened.pyramids.size(), 2u);
+  s21::LodSlice reopened = opened.pyramids[0].query(
+      opened.series[0].data(), opened.series[1].data(),
+      opened.series[1].size(), -1, 1, 10);
+  ASSERT_EQ(reopened.max, slice.max);
+  ASSERT_EQ(reopened.min, slice.min);
+  s21::ModelCalculator::removeGrafFiles(prefix, 2);
+  ASSERT_THROW(s21::ModelCalculator::openGrafFiles(prefix, 2),
+               std::runtime_error);
+}
+
+TEST(native, compile1) {
+  s21::StringVector infixes = {"sin(x)^2+1", "ln(x)*3-x/(x-1)", "sqrt(x)%0.7"};
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile(infixes);
+  s21::NativeOptions options;
+  options.flags = "-O1 -fPIC -shared";
+  options.cacheDir = testing::TempDir() + "s21_native_test";
+  std::shared_ptr<s21::NativeProgram> native;
+  try {
+    native = s21::NativeProgram::compile(program, options);
+  } catch (const std::runtime_error& e) {
+    GTEST_SKIP() << "no C++ compiler available: " << e.what();
+  }
+  std::vector<double> x(1000);
+  for (size_t i = 0; i < x.size(); i++) x[i] = -2 + i * 0.004;
+  s21::Vector expected(3, std::vector<double>(x.size()));
+  s21::Vector actual(3, std::vector<double>(x.size()));
+  double* e[3] = {expected[0].data(), expected[1].data(), expected[2].data()};
+  double* a[3] = {actual[0].data(), actual[1].data(), actual[2].data()};
+  program.evaluate(x.data(), x.size(), e);
+  native->evaluate(x.data(), x.size(), a);
+  for (size_t j = 0; j < 3; j++) {
+    for (size_t i = 0; i < x.size(); i++) {
+      if (std::isnan(expected[j][i])) {
+        ASSERT_TRUE(std::isnan(actual[j][i]));
+      } else {
+        ASSERT_DOUBLE_EQ(actual[j][i], expected[j][i]);
+      }
+    }
+  }
+  // повторная сборка берётся из кэша
+  ASSERT_EQ(s21::NativeProgram::compile(program, options)->libraryPath(),
+            native->libraryPath());
+
+  // кэш закрыт от других пользователей, а доступную им на запись
+  // библиотеку нельзя загрузить - она собирается заново
+  struct stat info = {};
+  ASSERT_EQ(stat(options.cacheDir.c_str(), &info), 0);
+  ASSERT_EQ(info.st_mode & 077, 0u);
+  ASSERT_EQ(chmod(native->libraryPath().c_str(), 0666), 0);
+  ASSERT_EQ(s21::NativeProgram::compile(program, options)->libraryPath(),
+            native->libraryPath());
+  ASSERT_EQ(stat(native->libraryPath().c_str(), &info), 0);
+  ASSERT_EQ(info.st_mode & 022, 0u);
+}
 
+TEST(native, strict1) {
+  // флаги по умолчанию (-O3 -march=native) не меняют результат:
+  // умножение и сложение схемы Горнера не сливаются в FMA
+  s21::StringVector infixes = {"3*x^4+2*x^3-x^2+5*x-7", "x*x*0.1+x/3-2.5",
+                               "sin(x)*1.7+cos(x)*x"};
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile(infixes);
+  s21::NativeOptions options;
+  // кавычки и пробелы в пути не ломают команду сборки
+  options.cacheDir = testing::TempDir() + "s21 native 'strict\" $(false)";
+  std::shared_ptr<s21::NativeProgram> native;
+  try {
+    native = s21::NativeProgram::compile(program, options);
+  } catch (const std::runtime_error& e) {
+    GTEST_SKIP() << "no C++ compiler available: " << e.what();
+  }
+  std::vector<double> x(4099);
+  for (size_t i = 0; i < x.size(); i++) x[i] = -7.3 + i * 0.00371;
+  s21::Vector expected(3, std::vector<double>(x.size()));
+  s21::Vector actual(3, std::vector<double>(x.size()));
+  double* e[3] = {expected[0].data(), expected[1].data(), expected[2].data()};
+  double* a[3] = {actual[0].data(), actual[1].data(), actual[2].data()};
+  program.evaluate(x.data(), x.size(), e);
+  native->evaluate(x.data(), x.size(), a);
+  for (size_t j = 0; j < 3; j++) {
+    for (size_t i = 0; i < x.size(); i++) {
+      ASSERT_EQ(actual[j][i], expected[j][i]) << infixes[j] << " " << x[i];
+    }
+  }
+
+  // неверный компилятор - ошибка сборки, а не команда оболочки
+  options.compiler = "false;";
+  ASSERT_THROW(s21::NativeProgram::compile(program, options),
+               std::runtime_error);
+}
+
+TEST(jit, equivalence1) {
+  s21::StringVector infixes = {
+      "x*x-3*x+2",         "1/x",          "1/(x-x)",  "-(x^3)+x/2",
+      "sqrt(x)",           "ln(x)+log(x)", "x%0.3",    "x%0",
+      "sin(x)*cos(x)/tan(x)", "asin(x)+acos(x)-atan(x)", "2^x"};
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile(infixes);
+  std::shared_ptr<s21::JitProgram> jit = s21::JitProgram::compile(program);
+  ASSERT_EQ(jit->isNative(), s21::JitProgram::supported());
+
+  // нечётное количество точек и несколько блоков
+  std::vector<double> x(1001);
+  for (size_t i = 0; i < x.size(); i++) x[i] = -2.5 + i * 0.005;
+  x[500] = 0.0;
+  x[501] = -0.0;
+  s21::Vector expected(infixes.size(), std::vector<double>(x.size()));
+  s21::Vector actual(infixes.size(), std::vector<double>(x.size()));
+  std::vector<double*> e, a;
+  for (size_t j = 0; j < infixes.size(); j++) {
+    e.push_back(expected[j].data());
+    a.push_back(actual[j].data());
+  }
+  program.evaluate(x.data(), x.size(), e.data());
+  jit->evaluate(x.data(), x.size(), a.data());
+  for (size_t j = 0; j < infixes.size(); j++) {
+    for (size_t i = 0; i < x.size(); i++) {
+      if (std::isnan(expected[j][i])) {
+        ASSERT_TRUE(std::isnan(actual[j][i])) << infixes[j] << " " << x[i];
+      } else {
+        ASSERT_EQ(actual[j][i], expected[j][i]) << infixes[j] << " " << x[i];
+      }
+    }
+  }
+}
+
+TEST(jit, nan1) {
+  // деление на ноль даёт в JIT тот же NaN, что и в интерпретаторе
+  s21::ExpressionProgram program =
+      s21::ExpressionProgram::compile(s21::StringVector{"1/x", "-x/(x-x)"});
+  std::shared_ptr<s21::JitProgram> jit = s21::JitProgram::compile(program);
+  double x[4] = {0.0, -0.0, 2.0, -3.0};
+  double e0[4], e1[4], a0[4], a1[4];
+  double* e[2] = {e0, e1};
+  double* a[2] = {a0, a1};
+  program.evaluate(x, 4, e);
+  jit->evaluate(x, 4, a);
+  ASSERT_TRUE(std::isnan(a0[0]) && std::isnan(a0[1]) && std::isnan(a1[2]));
+  ASSERT_FALSE(std::signbit(a0[0]));
+  ASSERT_EQ(std::memcmp(a0, e0, sizeof(a0)), 0);
+  ASSERT_EQ(std::memcmp(a1, e1, sizeof(a1)), 0);
+}
+
+TEST(jit, constant1) {
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile("2+3*4");
+  std::shared_ptr<s21::JitProgram> jit = s21::JitProgram::compile(program);
+  double x[3] = {1, 2, 3};
+  double y[3] = {};
+  double* columns[1] = {y};
+  jit->evaluate(x, 3, columns);
+  ASSERT_DOUBLE_EQ(y[0], 14);
+  ASSERT_DOUBLE_EQ(y[2], 14);
+}
+
+TEST(tiered, promote1) {
+  s21::TierPolicy policy;
+  policy.blockAfter = 10;
+  policy.jitAfter = 100;
+  policy.nativeAfter = s21::TieredExpression::kNever;
+  s21::ExpressionProgram program =
+      s21::ExpressionProgram::compile("sin(x)/x+x^2");
+  s21::TieredExpression expression(program, policy);
+  ASSERT_EQ(expression.tier(), s21::Tier::Scalar);
+  for (int i = 0; i < 9; i++) {
+    ASSERT_DOUBLE_EQ(expression.evaluate(i + 0.5), program.evaluate(i + 0.5));
+  }
+  ASSERT_EQ(expression.tier(), s21::Tier::Scalar);
+
+  std::vector<double> x(50), y(50);
+  for (size_t i = 0; i < x.size(); i++) x[i] = i * 0.1;
+  double* columns[1] = {y.data()};
+  expression.evaluate(x.data(), x.size(), columns);
+  ASSERT_EQ(expression.tier(), s21::Tier::Block);
+  expression.evaluate(x.data(), x.size(), columns);
+  ASSERT_EQ(expression.tier(), s21::Tier::Jit);
+  ASSERT_EQ(expression.evaluations(), 109u);
+  for (size_t i = 1; i < x.size(); i++) {
+    ASSERT_DOUBLE_EQ(y[i], program.evaluate(x[i]));
+  }
+  ASSERT_TRUE(std::isnan(y[0]));
+  // после перехода на JIT одиночные точки по-прежнему считает интерпретатор
+  for (int i = -500; i < 500; i++) {
+    double v = i * 0.37 + 0.1;
+    ASSERT_EQ(expression.evaluate(v), program.evaluate(v));
+  }
+  ASSERT_EQ(expression.tier(), s21::Tier::Jit);
+  ASSERT_TRUE(std::isnan(expression.evaluate(0)));
+}
+
+TEST(tiered, native1) {
+  // по умолчанию внешний компилятор не запускается
+  ASSERT_EQ(s21::TierPolicy().nativeAfter, s21::TieredExpression::kNever);
+
+  s21::TierPolicy policy;
+  policy.nativeAfter = 1000;
+  policy.options.flags = "-O1 -fPIC -shared";
+  policy.options.cacheDir = testing::TempDir() + "s21_native_test";
+  s21::ExpressionProgram program =
+      s21::ExpressionProgram::compile("sqrt(x-500)*x-1/(x-3)");
+  try {
+    s21::NativeProgram::compile(program, policy.options);
+  } catch (const std::runtime_error& e) {
+    GTEST_SKIP() << "no C++ compiler available: " << e.what();
+  }
+
+  s21::TieredExpression expression(program, policy);
+  std::vector<double> x(1000), y(1000), expected(1000);
+  for (size_t i = 0; i < x.size(); i++) x[i] = i;
+  double* columns[1] = {y.data()};
+  double* reference[1] = {expected.data()};
+  program.evaluate(x.data(), x.size(), reference);
+  expression.evaluate(x.data(), x.size(), columns);
+  // пока идёт сборка, выражение работает в JIT
+  ASSERT_GE(expression.tier(), s21::Tier::Jit);
+  expression.wait();
+  ASSERT_EQ(expression.tier(), s21::Tier::Native);
+  expression.evaluate(x.data(), x.size(), columns);
+  for (size_t i = 0; i < x.size(); i++) {
+    if (std::isnan(expected[i])) {
+      ASSERT_TRUE(std::isnan(y[i]));
+    } else {
+      ASSERT_DOUBLE_EQ(y[i], expected[i]);
+    }
+  }
+
+  // выражение удаляется, не дожидаясь сборки
+  auto started = std::make_unique<s21::TieredExpression>(
+      s21::ExpressionProgram::compile("x*x*x-2"), policy);
+  started->evaluate(x.data(), x.size(), columns);
+  started.reset();
+}
+
+TEST(vm, equivalence1) {
+  s21::StringVector corpus = {
+      "x*x-3*x+2",  "sin(x)^2+cos(x)^2", "1/(x-1)+ln(x)*log(x)",
+      "sqrt(x)%0.7", "(x+1)*(x+2)*(x+3)*(x+4)/(x-5)",
+      "asin(x/10)+acos(x/10)-atan(x)*tan(x)", "-x^3+2^x"};
+  for (const s21::String& infix : corpus) {
+    s21::ExpressionProgram program = s21::ExpressionProgram::compile(infix);
+    // два регистра заставляют распределитель вытеснять значения
+    for (size_t registers : {size_t(2), s21::RegisterProgram::kRegisters}) {
+      s21::RegisterProgram vm = s21::RegisterProgram::compile(program,
+                                                              registers);
+      ASSERT_LE(vm.registerCount(), registers);
+      std::vector<double> x(600), y(600);
+      for (size_t i = 0; i < x.size(); i++) x[i] = -3 + i * 0.01;
+      double* columns[1] = {y.data()};
+      vm.evaluate(x.data(), x.size(), columns);
+      for (size_t i = 0; i < x.size(); i++) {
+        double expected = program.evaluate(x[i]);
+        if (std::isnan(expected)) {
+          ASSERT_TRUE(std::isnan(y[i])) << infix;
+          ASSERT_TRUE(std::isnan(vm.evaluate(x[i]))) << infix;
+        } else {
+          ASSERT_DOUBLE_EQ(y[i], expected) << infix;
+          ASSERT_DOUBLE_EQ(vm.evaluate(x[i]), expected) << infix;
+        }
+      }
+    }
+  }
+}
+
+TEST(vm, size1) {
+  s21::StringVector corpus = {"sin(x)^2+1", "x*x-3*x+2",
+                              "(x+1)*(x+2)*(x+3)/(x-4)", "ln(x)/log(x)+x"};
+  for (const s21::String& infix : corpus) {
+    std::istringstream rpn(s21::ReversePolishNotation::toRPN(infix));
+    size_t tokens = std::distance(std::istream_iterator<std::string>(rpn),
+                                  std::istream_iterator<std::string>());
+    s21::RegisterProgram vm = s21::RegisterProgram::compile(infix);
+    ASSERT_LE(vm.size() * 2, tokens + 1) << infix;
+    ASSERT_EQ(vm.spillCount(), 0u);
+  }
+}
+
+TEST(poly, horner1) {
+  s21::String infix = "3*x^4+2*x^3-x^2+5*x-7";
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile(infix);
+  // схема Горнера: четыре умножения и четыре сложения
+  size_t mul = 0;
+  for (const s21::Instruction& in : program.instructions()) {
+    ASSERT_NE(in.op, s21::OP_POW);
+    mul += in.op == s21::OP_MUL;
+  }
+  ASSERT_EQ(mul, 4u);
+  s21::ModelCalculator calculator;
+  for (double x = -3; x <= 3; x += 0.25) {
+    ASSERT_NEAR(program.evaluate(x), calculator.calculate(infix, x), 1e-12);
+  }
+  ASSERT_DOUBLE_EQ(s21::ExpressionProgram::compile("x^10+1").evaluate(2), 1025);
+  ASSERT_DOUBLE_EQ(s21::ExpressionProgram::compile("x^2/2-x").evaluate(3), 1.5);
+}
+
+TEST(poly, power1) {
+  s21::StringVector infixes = {"(sin(x))^3", "(x-1)^5", "x^0.5", "x^(0-2)"};
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile(infixes);
+  size_t pow = 0;
+  for (const s21::Instruction& in : program.instructions()) {
+    pow += in.op == s21::OP_POW;
+  }
+  // дробная и отрицательная степени остаются pow
+  ASSERT_EQ(pow, 2u);
+  for (double x = 0.5; x <= 4; x += 0.5) {
+    ASSERT_DOUBLE_EQ(program.evaluate(x, 0), std::pow(std::sin(x), 3));
+    ASSERT_DOUBLE_EQ(program.evaluate(x, 1), std::pow(x - 1, 5));
+    ASSERT_DOUBLE_EQ(program.evaluate(x, 2), std::sqrt(x));
+    ASSERT_DOUBLE_EQ(program.evaluate(x, 3), 1 / (x * x));
+  }
+  ASSERT_DOUBLE_EQ(s21::ExpressionProgram::power(1.5, 7), std::pow(1.5, 7));
+  ASSERT_DOUBLE_EQ(s21::ExpressionProgram::power(2, 0.5), std::sqrt(2));
+}
+
+TEST(poly, division1) {
+  // x / 10 остаётся делением: x * 0.1 даёт при x = 3 0.30000000000000004
+  s21::ModelCalculator calculator;
+  for (s21::String infix : {"x/10", "(x*x+1)/3", "2*x/0.7-x"}) {
+    s21::ExpressionProgram program = s21::ExpressionProgram::compile(infix);
+    for (double x = -5; x <= 5; x += 0.125) {
+      ASSERT_EQ(program.evaluate(x), calculator.calculate(infix, x))
+          << infix << " " << x;
+    }
+  }
+  ASSERT_EQ(s21::ExpressionProgram::compile("x/10").evaluate(3), 0.3);
+  // деление на степень двойки точно и сворачивается в коэффициенты
+  s21::ExpressionProgram half = s21::ExpressionProgram::compile("x*x/4+x/2");
+  for (const s21::Instruction& in : half.instructions()) {
+    ASSERT_NE(in.op, s21::OP_DIV);
+  }
+  for (double x = -5; x <= 5; x += 0.125) {
+    ASSERT_EQ(half.evaluate(x), x * x / 4 + x / 2);
+  }
+}
+
+TEST(poly, nonfinite1) {
+  // сокращённый член x не исчезает: при бесконечном x или NaN
+  // x - x и 0 * x дают NaN, как и без оптимизации
+  const double inf = std::numeric_limits<double>::infinity();
+  for (s21::String infix : {"x-x", "0*x", "x*0+1", "x^2-x*x", "2*x-x-x"}) {
+    s21::ExpressionProgram program = s21::ExpressionProgram::compile(infix);
+    for (double x : {inf, -inf, double(NAN)}) {
+      ASSERT_TRUE(std::isnan(program.evaluate(x))) << infix << " " << x;
+    }
+    ASSERT_DOUBLE_EQ(program.evaluate(2), infix == "x*0+1" ? 1 : 0) << infix;
+  }
+  // без сокращения многочлен по-прежнему сворачивается
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile("3*x-x");
+  ASSERT_DOUBLE_EQ(program.evaluate(inf), inf);
+  ASSERT_TRUE(std::isnan(program.evaluate(NAN)));
+  ASSERT_DOUBLE_EQ(program.evaluate(2), 4);
+}
+
+TEST(proxy, fit1) {
+  s21::ExpressionProgram program =
+      s21::ExpressionProgram::compile("sin(cos(ln(x+2)))*atan(sqrt(x+1))");
+  s21::ProxyOptions options;
+  options.absTolerance = 1e-10;
+  options.relTolerance = 0;
+  s21::ChebyshevProxy proxy = s21::ChebyshevProxy::fit(program, {0, 10}, options);
+  ASSERT_EQ(proxy.directCount(), 0u);
+  ASSERT_LE(proxy.maxError(), options.absTolerance);
+  ASSERT_GE(proxy.verifiedPoints(), proxy.pieceCount() * options.verifyPoints);
+  for (double x = 0; x <= 10; x += 0.001) {
+    ASSERT_NEAR(proxy.evaluate(x), program.evaluate(x), 1e-9);
+  }
+  // вне области вычисляется само выражение
+  ASSERT_DOUBLE_EQ(proxy.evaluate(12.5), program.evaluate(12.5));
+  ASSERT_THROW(s21::ChebyshevProxy::fit(program, {1, 1}), std::invalid_argument);
+}
+
+TEST(proxy, pole1) {
+  s21::ExpressionProgram program = s21::ExpressionProgram::compile("1/(x-1)");
+  s21::ProxyOptions options;
+  options.maxPieces = 64;
+  s21::ChebyshevProxy proxy = s21::ChebyshevProxy::fit(program, {0, 2}, options);
+  ASSERT_GT(proxy.directCount(), 0u);
+  ASSERT_LE(proxy.pieceCount(), 64u);
+  ASSERT_TRUE(std::isnan(proxy.evaluate(1)));
+  for (double x = 0; x <= 2; x += 0.01) {
+    if (std::fabs(x - 1) < 1e-9) continue;
+    ASSERT_NEAR(proxy.evaluate(x), program.evaluate(x),
+                1e-8 * std::fabs(program.evaluate(x)));
+  }
+  s21::Vector graf =
+      s21::ModelCalculator().calculateGrafs({0, 2}, {-10, 10}, 100, proxy);
+  ASSERT_EQ(graf.size(), 2u);
+  ASSERT_NEAR(graf[1][0], -1, options.absTolerance);
+
+  // параметры различаются по любому полю, в том числе по числу участков
+  s21::ProxyOptions other = options;
+  ASSERT_FALSE(options < other || other < options);
+  other.maxPieces = 128;
+  ASSERT_TRUE(options < other);
+  other = options;
+  other.verifyPoints = 16;
+  ASSERT_TRUE(other < options);
+  other = options;
+  other.degree = 8;
+  ASSERT_TRUE(other < options || options < other);
+}
+
+TEST(precision, single1) {
+  s21::ModelCalculator model;
+  s21::StringVector infixes = {"sin(x)*x", "x^3-2*x"};
+  s21::Vector d = model.calculateGrafs({-3, 3}, {-100, 100}, 1000, infixes);
+  s21::Vector f = model.calculateGrafs({-3, 3}, {-100, 100}, 1000, infixes,
+                                       s21::Precision::Single);
+  ASSERT_EQ(d.size(), f.size());
+  for (size_t row = 1; row < d.size(); ++row) {
+    for (size_t k = 0; k < d[row].size(); ++k) {
+      ASSERT_NEAR(f[row][k], d[row][k], 1e-5);
+    }
+  }
+}
+
+TEST(precision, accuracy1) {
+  s21::ExpressionProgram program =
+      s21::ExpressionProgram::compile({"sin(x)", "1000000+sin(x)", "ln(x)"});
+  std::vector<s21::AccuracyReport> reports =
+      program.checkAccuracy({-5, 5}, 1000);
+  ASSERT_EQ(reports.size(), 3u);
+  ASSERT_TRUE(reports[0].sufficient);
+  ASSERT_LE(reports[0].maxAbsError, 1e-6);
+  // размах 2 при значениях около 10^6: шаг float виден на графике
+  ASSERT_FALSE(reports[1].sufficient);
+  ASSERT_NEAR(reports[1].valueSpan, 2.0, 1e-3);
+  ASSERT_EQ(reports[2].mismatches, 0u);
+  // эталон в long double совпадает с double
+  long double x = 0.5L, y[3] = {};
+  long double* columns[3] = {y, y + 1, y + 2};
+  program.evaluate(&x, 1, columns);
+  ASSERT_NEAR(static_cast<double>(y[0]), program.evaluate(0.5), 1e-15);
+}
+
+namespace {
+constexpr char kStaticPolynomial[] = "2*x^5-3*x^4+x^3-7*x^2+x-1";
+constexpr char kStaticFunctions[] =
+    "-asin(x/4)+acos(x/5)*atan(x)-sqrt(x*x+1)/ln(x+6)+log(x+7)%2";
+constexpr char kStaticNumbers[] = "1.5e-3*x+0.1+12345678901234567890*x/-(2e2)";
+constexpr char kStaticPower[] = "(sin(x))^2+cos(x)^2-2^-x";
+}  // namespace
+
+TEST(static_expr, equivalence1) {
+  static_assert(s21::StaticExpression<kStaticPolynomial>::size() == 25,
+                "the formula is compiled by the C++ compiler");
+  auto check = [](auto expression, const char* infix) {
+    s21::ExpressionProgram program = s21::ExpressionProgram::compile(infix);
+    for (double x = -3.7; x < 3.7; x += 0.05) {
+      double exact = program.evaluate(x);
+      ASSERT_NEAR(expression(x), exact, 1e-12 * (1 + std::fabs(exact))) << infix;
+    }
+  };
+  check(s21::StaticExpression<kStaticPolynomial>(), kStaticPolynomial);
+  check(s21::StaticExpression<kStaticFunctions>(), kStaticFunctions);
+  check(s21::StaticExpression<kStaticNumbers>(), kStaticNumbers);
+  check(s21::StaticExpression<kStaticPower>(), kStaticPower);
+  // вне области определения - NaN, как у ExpressionProgram
+  ASSERT_TRUE(std::isnan(s21::StaticExpression<kStaticFunctions>::evaluate(-7.0)));
+  ASSERT_NEAR(s21::StaticExpression<kStaticPower>::evaluate<float>(0.5f),
+              s21::StaticExpression<kStaticPower>::evaluate(0.5), 1e-6);
+}
+
+TEST(threads, shared1) {
+  // один экземпляр каждого вычислителя на все потоки
+  const s21::ModelCalculator model;
+  const s21::StringVector infixes = {"sin(x)*x^2", "sqrt(x*x+1)-ln(x+6)"};
+  const s21::ExpressionProgram program = s21::ExpressionProgram::compile(infixes);
+  const std::shared_ptr<s21::JitProgram> jit = s21::JitProgram::compile(program);
+  const s21::RegisterProgram vm = s21::RegisterProgram::compile(program);
+  s21::TierPolicy policy;
+  policy.blockAfter = 1000;
+  policy.jitAfter = 20000;
+  policy.nativeAfter = s21::TieredExpression::kNever;
+  s21::TieredExpression tiered(program, policy);
+
+  const unsigned points = 500;
+  const s21::Vector reference =
+      model.calculateGrafs({-5, 5}, {-1e9, 1e9}, points, infixes);
+  std::atomic<int> mismatches{0};
+  auto check = [&](std::size_t row, std::size_t k, double value) {
+    double exact = reference[row + 1][k];
+    if (!(std::fabs(value - exact) <= 1e-9 * (1 + std::fabs(exact)))) {
+      ++mismatches;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 64; ++t) {
+    threads.emplace_back([&, t] {
+      std::vector<double> y0(points), y1(points);
+      double* columns[2] = {y0.data(), y1.data()};
+      for (int round = 0; round < 20; ++round) {
+        int kind = (t + round) % 6;
+        if (kind == 0) {
+          for (unsigned k = 0; k < points; k += 25) {
+            check(0, k, model.calculate(infixes[0], reference[0][k]));
+          }
+          continue;
+        }
+        if (kind == 1) {
+          s21::Vector table =
+              model.calculateGrafs({-5, 5}, {-1e9, 1e9}, points, infixes);
+          for (unsigned k = 0; k < points; ++k) check(1, k, table[2][k]);
+          continue;
+        }
+        if (kind == 2) {
+          for (unsigned k = 0; k < points; ++k) {
+            y0[k] = program.evaluate(reference[0][k], 0);
+            y1[k] = program.evaluate(reference[0][k], 1);
+          }
+        } else if (kind == 3) {
+          jit->evaluate(reference[0].data(), points, columns);
+        } else if (kind == 4) {
+          vm.evaluate(reference[0].data(), points, columns);
+        } else {
+          tiered.evaluate(reference[0].data(), points, columns);
+        }
+        for (unsigned k = 0; k < points; ++k) {
+          check(0, k, y0[k]);
+          check(1, k, y1[k]);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  ASSERT_EQ(mismatches.load(), 0);
+  ASSERT_EQ(tiered.tier(), s21::Tier::Jit);
+}
+
+TEST(sched, parallel1) {
+  s21::TaskScheduler& scheduler = s21::TaskScheduler::instance();
+  std::vector<int> hits(100000, 0);
+  scheduler.parallelFor(0, hits.size(), 1000, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) ++hits[i];
+  });
+  ASSERT_EQ(std::count(hits.begin(), hits.end(), 1), 100000);
+
+  // вложенные циклы не запускают лишних потоков
+  std::atomic<size_t> active(0), peak(0), total(0);
+  scheduler.parallelFor(0, 16, 1, [&](size_t, size_t) {
+    scheduler.parallelFor(0, 64, 1, [&](size_t, size_t) {
+      size_t now = ++active;
+      size_t seen = peak;
+      while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+      }
+      ++total;
+      --active;
+    });
+  });
+  ASSERT_EQ(total, 16u * 64u);
+  ASSERT_LE(peak, scheduler.workerCount() + 1);
+  ASSERT_THROW(s21::TaskScheduler::configure(s21::SchedulerOptions()),
+               std::runtime_error);
+}
+
+TEST(sched, exception1) {
+  s21::TaskScheduler& scheduler = s21::TaskScheduler::instance();
+  ASSERT_THROW(scheduler.parallelFor(0, 1000, 10,
+                                     [](size_t begin, size_t) {
+                                       if (begin >= 500) {
+                                         throw std::invalid_argument("body");
+                                       }
+                                     }),
+               std::invalid_argument);
+  // после исключения планировщик продолжает работать
+  std::atomic<size_t> total(0);
+  scheduler.parallelFor(0, 1000, 10,
+                        [&](size_t begin, size_t end) { total += end - begin; });
+  ASSERT_EQ(total, 1000u);
+}
+
+TEST(sched, isolation1) {
+  // ожидающий поток выполняет только задачи своей группы: долгая задача
+  // другой группы не попадает в поток, ждущий параллельный цикл
+  s21::SchedulerOptions options;
+  options.workers = 1;
+  s21::TaskScheduler scheduler(options);
+  std::atomic<bool> released(false);
+  std::thread::id runner;
+  bool early = false;  // задача началась до конца цикла
+  s21::TaskGroup slow(scheduler);
+  slow.run([&] {
+    runner = std::this_thread::get_id();
+    early = !released;
+    for (int i = 0; i < 2000 && !released; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  std::atomic<size_t> total(0);
+  scheduler.parallelFor(0, 64, 1,
+                        [&](size_t begin, size_t end) { total += end - begin; });
+  released = true;
+  slow.wait();
+  ASSERT_EQ(total, 64u);
+  ASSERT_FALSE(early && runner == std::this_thread::get_id());
+}
+
+TEST(montecarlo, philox1) {
+  // контрольные значения Philox4x32-10 из Random123
+  EXPECT_EQ(s21::Philox4x32::generate({0, 0, 0, 0}, {0, 0}),
+            (s21::Philox4x32::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                      0x9b00dbd8}));
+  EXPECT_EQ(s21::Philox4x32::generate(
+                {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                {0xffffffff, 0xffffffff}),
+            (s21::Philox4x32::Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6,
+                                      0x6d5451fd}));
+  EXPECT_EQ(s21::Philox4x32::generate(
+                {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                {0xa4093822, 0x299f31d0}),
+            (s21::Philox4x32::Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420,
+                                      0x24126ea1}));
+
+  // квантили гистограммы в пределах относительной точности
+  std::vector<double> values;
+  s21::QuantileSketch left(1e-3), right(1e-3);
+  for (std::uint32_t i = 0; i < 20000; ++i) {
+    std::array<double, 2> z = s21::Philox4x32::normals({i, 0, 0, 0}, {7, 0});
+    double value = std::exp(z[0]) * 1000;
+    values.push_back(value);
+    (i % 3 ? left : right).add(value);
+  }
+  left.merge(right);
+  ASSERT_EQ(left.count(), values.size());
+  std::sort(values.begin(), values.end());
+  for (double q : {0.0, 0.01, 0.25, 0.5, 0.75, 0.99, 1.0}) {
+    double exact = values[static_cast<size_t>(q * (values.size() - 1))];
+    EXPECT_NEAR(left.quantile(q), exact, exact * 1e-3);
+  }
+  EXPECT_THROW(s21::QuantileSketch(0), std::invalid_argument);
+  EXPECT_THROW(s21::QuantileSketch().quantile(0.5), std::invalid_argument);
+}
+
+TEST(montecarlo, simulate1) {
+  s21::CrInput in = {1000000, 120, 9};
+  s21::RateModel model;
+  s21::SimulationOptions options;
+  options.paths = 1000;
+  options.seed = 42;
+
+  // без волатильности и при ставке на среднем уровне - обычный кредит
+  model.mean = 9;
+  model.volatility = 0;
+  s21::CreditModel credit;
+  for (s21::TypeOfMonthlyPayments type : {s21::ANNUITY, s21::DIFFERENTIAL}) {
+    s21::SimulationResult fixed =
+        s21::CreditSimulator::simulate(type, in, model, options);
+    s21::CrSummary summary = credit.summarizeCredit(type, in);
+    EXPECT_NEAR(fixed.overpayment.mean, summary.overpayment, 0.005 * in.term);
+    EXPECT_NEAR(fixed.overpayment.deviation, 0, 1e-6);
+    EXPECT_NEAR(fixed.total.quantiles[1], fixed.total.mean,
+                fixed.total.mean * 1e-3);
+  }
+
+  // результат не зависит от числа потоков
+  model.volatility = 3;
+  model.reversion = 0.3;
+  model.mean = 12;
+  s21::TaskScheduler one({1, false}), three({3, false});
+  s21::SimulationResult a =
+      s21::CreditSimulator::simulate(s21::ANNUITY, in, model, options, one);
+  s21::SimulationResult b =
+      s21::CreditSimulator::simulate(s21::ANNUITY, in, model, options, three);
+  EXPECT_EQ(a.total.mean, b.total.mean);
+  EXPECT_EQ(a.total.deviation, b.total.deviation);
+  EXPECT_EQ(a.overpayment.quantiles, b.overpayment.quantiles);
+  double first = s21::CreditSimulator::simulatePath(s21::ANNUITY, in, model,
+                                                    options.seed, 0);
+  EXPECT_LE(a.total.min, first);
+  EXPECT_GE(a.total.max, first);
+  // ставка растёт к 12%: переплата выше, чем при постоянных 9%
+  EXPECT_GT(a.overpayment.mean, credit.summarizeCredit(s21::ANNUITY, in)
+                                    .overpayment);
+  EXPECT_LT(a.overpayment.quantiles[0], a.overpayment.quantiles[1]);
+  EXPECT_LT(a.overpayment.quantiles[1], a.overpayment.quantiles[2]);
+  EXPECT_LE(a.overpayment.min, a.overpayment.quantiles[0]);
+  EXPECT_GE(a.overpayment.max * (1 + 1e-3), a.overpayment.quantiles[2]);
+
+  options.seed = 43;
+  EXPECT_NE(s21::CreditSimulator::simulate(s21::ANNUITY, in, model, options)
+                .total.mean,
+            a.total.mean);
+  model.floor = -1;
+  EXPECT_THROW(s21::CreditSimulator::simulate(s21::ANNUITY, in, model),
+               std::invalid_argument);
+}
+
+TEST(money, rounding1) {
+  using s21::Money;
+  using s21::Rounding;
+  EXPECT_EQ(Money::fromDouble(12.345).minor(), 1235);
+  EXPECT_EQ(Money::fromDouble(-0.125, Rounding::HalfAwayFromZero).minor(),
+            -13);
+  EXPECT_EQ(Money::fromDouble(0.125, Rounding::HalfEven).minor(), 12);
+  EXPECT_EQ(Money::fromDouble(0.135, Rounding::HalfEven).minor(), 14);
+  EXPECT_EQ(Money::fromDouble(1.019, Rounding::TowardZero).minor(), 101);
+  EXPECT_EQ(Money::fromDouble(-1.011, Rounding::AwayFromZero).minor(), -102);
+  EXPECT_EQ(Money::fromDouble(-1.011, Rounding::Down).minor(), -102);
+  EXPECT_EQ(Money::fromDouble(1.011, Rounding::Up).minor(), 102);
+  EXPECT_THROW(Money::fromDouble(1e300), std::invalid_argument);
+
+  // деление в целых числах: остаток не теряется
+  Money credit = Money::fromMinor(100000);
+  EXPECT_EQ(credit.divide(3).minor(), 33333);
+  EXPECT_EQ(credit.divide(3, Rounding::Up).minor(), 33334);
+  EXPECT_EQ(Money::fromMinor(5).divide(2, Rounding::HalfEven).minor(), 2);
+  EXPECT_EQ(Money::fromMinor(-5).divide(2).minor(), -3);
+  EXPECT_EQ(Money::fromMinor(-5).divide(2, Rounding::Down).minor(), -3);
+  EXPECT_EQ(Money::fromMinor(-5).divide(2, Rounding::Up).minor(), -2);
+  EXPECT_THROW(credit.divide(0), std::invalid_argument);
+  EXPECT_EQ(credit.divide(3) * 3 + Money::fromMinor(1), credit);
+  EXPECT_EQ(credit.scale(0.01).minor(), 1000);
+  EXPECT_LT(-credit, Money());
+  EXPECT_EQ(Money::fromMinor(12345).toDouble(), 123.45);
+
+  // переполнение 64 бит - ошибка, а не переход через ноль
+  Money largest = Money::fromMinor(std::numeric_limits<std::int64_t>::max());
+  Money smallest = Money::fromMinor(std::numeric_limits<std::int64_t>::min());
+  EXPECT_THROW(largest + Money::fromMinor(1), std::invalid_argument);
+  EXPECT_THROW(smallest - Money::fromMinor(1), std::invalid_argument);
+  EXPECT_THROW(-smallest, std::invalid_argument);
+  EXPECT_THROW(largest * 2, std::invalid_argument);
+  EXPECT_THROW(smallest * -1, std::invalid_argument);
+  Money sum = largest;
+  EXPECT_THROW(sum += Money::fromMinor(1), std::invalid_argument);
+  EXPECT_EQ(sum, largest);
+  EXPECT_EQ(largest - largest, Money());
+  EXPECT_EQ(-largest + largest, Money());
+}
+
+TEST(calendar, civil1) {
+  static_assert(s21::calendar::daysFromCivil(1970, 1, 1) == 0, "epoch");
+  static_assert(s21::calendar::civilFromDays(11016).day == 29, "leap day");
+  ASSERT_EQ(s21::calendar::daysFromCivil(2000, 3, 1), 11017);
+  ASSERT_EQ(s21::calendar::daysFromCivil(1969, 12, 31), -1);
+  ASSERT_TRUE(s21::calendar::isLeapYear(2000));
+  ASSERT_FALSE(s21::calendar::isLeapYear(1900));
+  ASSERT_EQ(s21::calendar::daysInMonth(2024, 2), 29);
+  ASSERT_EQ(s21::calendar::daysInMonth(2023, 2), 28);
+  ASSERT_EQ(s21::calendar::daysInMonth(2023, 13), 0);
+  // последовательный обход дат совпадает с номерами дней
+  s21::calendar::Date date = {1600, 1, 1};
+  for (std::int32_t day = s21::calendar::daysFromCivil(1600, 1, 1);
+       day < s21::calendar::daysFromCivil(2400, 1, 1); ++day) {
+    s21::calendar::Date back = s21::calendar::civilFromDays(day);
+    ASSERT_EQ(back.year, date.year);
+    ASSERT_EQ(back.month, date.month);
+    ASSERT_EQ(back.day, date.day);
+    ASSERT_EQ(s21::calendar::daysInMonthOf(day),
+              s21::calendar::daysInMonth(date.year, date.month));
+    if (++date.day > s21::calendar::daysInMonth(date.year, date.month)) {
+      date.day = 1;
+      if (++date.month > 12) {
+        date.month = 1;
+        ++date.year;
+      }
+    }
+  }
+}
+
+TEST(threads, deposit1) {
+  // вклады считаются параллельно: календарь не вызывает localtime
+  s21::TimePoint now = std::chrono::system_clock::now();
+  std::vector<s21::Input> inputs;
+  for (int i = 0; i < 16; ++i) {
+    inputs.push_back({100000.0 + 1000 * i, 5.0 + i % 7, 13, 6 + 3 * i,
+                      i % 2 == 0,
+                      i % 3 == 0   ? s21::Period::EveryDay
+                      : i % 3 == 1 ? s21::Period::EveryMonth
+                                   : s21::Period::EveryYear,
+                      {},
+                      {},
+                      now + std::chrono::hours(24 * 17 * i),
+                      100000});
+  }
+  std::vector<s21::Output> serial(inputs.size()), parallel(inputs.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    s21::DepositModel().calculateDeposit(inputs[i], serial[i]);
+  }
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    threads.emplace_back([&, i] {
+      s21::DepositModel().calculateDeposit(inputs[i], parallel[i]);
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    ASSERT_EQ(parallel[i].report.size(), serial[i].report.size());
+    ASSERT_EQ(parallel[i].totalPercents, serial[i].totalPercents);
+    ASSERT_EQ(parallel[i].totalTax, serial[i].totalTax);
+    ASSERT_EQ(parallel[i].remainderDeposit, serial[i].remainderDeposit);
+  }
+}
+
+TEST(threads, credit1) {
+  // графики от сегодняшнего дня строятся параллельно: дата берётся
+  // через localtime_r, а не через общий буфер std::localtime
+  std::vector<s21::CrInput> inputs;
+  for (int i = 0; i < 16; ++i) {
+    inputs.push_back({100000.0 + 5000 * i, 12 + 7 * i, 5.0 + i % 9});
+  }
+  auto rowsOf = [](const s21::CrInput& in, s21::TypeOfMonthlyPayments type) {
+    std::vector<s21::ScheduleRow> rows;
+    for (const s21::ScheduleRow& row : s21::CreditModel().schedule(type, in)) {
+      rows.push_back(row);
+    }
+    return rows;
+  };
+  std::vector<std::vector<s21::ScheduleRow>> serial(inputs.size()),
+      parallel(inputs.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    serial[i] = rowsOf(inputs[i], i % 2 ? s21::DIFFERENTIAL : s21::ANNUITY);
+  }
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    threads.emplace_back([&, i] {
+      parallel[i] =
+          rowsOf(inputs[i], i % 2 ? s21::DIFFERENTIAL : s21::ANNUITY);
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    ASSERT_EQ(parallel[i].size(), serial[i].size());
+    for (std::size_t j = 0; j < serial[i].size(); ++j) {
+      ASSERT_EQ(parallel[i][j].date.year, serial[i][j].date.year);
+      ASSERT_EQ(parallel[i][j].date.month, serial[i][j].date.month);
+      ASSERT_EQ(parallel[i][j].date.day, serial[i][j].date.day);
+      ASSERT_EQ(parallel[i][j].monthly_pay, serial[i][j].monthly_pay);
+    }
+  }
+  // первый платёж - сегодня по местному времени
+  std::time_t now = std::time(nullptr);
+  std::tm local{};
+  ASSERT_NE(localtime_r(&now, &local), nullptr);
+  ASSERT_EQ(serial[0][0].date.year, local.tm_year + 1900);
+  ASSERT_EQ(serial[0][0].date.month, local.tm_mon + 1);
+}
 
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,156 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file s21_test_view.cc
+ *
+ * @brief Tests of the headless ChartRenderer for the SmartCalc v2.0
+ * application.
+ *
+ * The renderer needs Qt, so these tests are built separately from the model
+ * tests (make test_view) and run on the offscreen platform.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include <QGuiApplication>
+#include <cstdio>     // std::remove
+#include <fstream>    // render.svg1, render.points1
+#include <sstream>    // render.svg1, render.points1
+#include <stdexcept>  // render.error1
+#include <string>
+
+#include "../../view/chartrenderer.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+// задание для графика y = x на квадрате [-1, 1] x [-1, 1]
+ChartJob makeJob(const s21::StringVector& infixes) {
+  ChartJob job;
+  job.program = s21::ExpressionProgram::compile(infixes);
+  job.xRange = {-1, 1};
+  job.yRange = {-1, 1};
+  job.pAmount = 201;
+  job.style.width = 200;
+  job.style.height = 200;
+  return job;
+}
+
+// есть ли в окрестности точки пиксель не цвета фона
+bool hasInk(const QImage& image, int x, int y, QColor background) {
+  for (int dy = -2; dy <= 2; ++dy) {
+    for (int dx = -2; dx <= 2; ++dx) {
+      if (image.pixelColor(x + dx, y + dy) != background) return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(render, image1) {
+  ChartJob job = makeJob({"x"});
+  QImage image = ChartRenderer::render(job);
+  ASSERT_EQ(image.width(), 200);
+  ASSERT_EQ(image.height(), 200);
+  // точка (0.5, 0.5) лежит на графике, (0.5, 0.6) - нет
+  ASSERT_TRUE(hasInk(image, 150, 50, job.style.background));
+  ASSERT_FALSE(hasInk(image, 150, 40, job.style.background));
+  // ось x проходит через середину изображения
+  ASSERT_TRUE(hasInk(image, 20, 100, job.style.background));
+}
+
+TEST(render, svg1) {
+  ChartJob job = makeJob({"x", "sqrt(x)"});
+  job.svgPath = "s21_test_render.svg";
+  ChartRenderer::render(job);
+
+  std::ifstream file(job.svgPath);
+  ASSERT_TRUE(bool(file));
+  std::stringstream text;
+  text << file.rdbuf();
+  std::string svg = text.str();
+  std::remove(job.svgPath.c_str());
+
+  ASSERT_EQ(svg.rfind("<svg", 0), 0u);
+  // по одной линии на выражение; корень определён только при x >= 0,
+  // поэтому его линия начинается с середины изображения
+  std::size_t first = svg.find("<path");
+  std::size_t second = svg.find("<path", first + 1);
+  ASSERT_NE(first, std::string::npos);
+  ASSERT_NE(second, std::string::npos);
+  ASSERT_EQ(svg.find("<path", second + 1), std::string::npos);
+  auto start = [&svg](std::size_t path) {
+    return std::stod(svg.substr(svg.find("d=\"M", path) + 4));
+  };
+  ASSERT_DOUBLE_EQ(start(first), 0);
+  ASSERT_NEAR(start(second), 100, 1.01);
+}
+
+TEST(render, all1) {
+  std::vector<ChartJob> jobs;
+  for (int i = 0; i < 4; ++i) {
+    jobs.push_back(makeJob({"x"}));
+    jobs.back().style.width = 100 + 10 * i;
+  }
+  for (unsigned threads : {0u, 1u, 3u}) {
+    std::vector<ChartResult> results = ChartRenderer::renderAll(jobs, threads);
+    ASSERT_EQ(results.size(), jobs.size());
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+      EXPECT_TRUE(results[i].ok()) << results[i].error;
+      EXPECT_EQ(results[i].image.width(), jobs[i].style.width);
+    }
+  }
+}
+
+TEST(render, error1) {
+  // недоступный путь - ошибка этого графика, остальные строятся
+  std::vector<ChartJob> jobs = {makeJob({"x"}), makeJob({"x"})};
+  jobs[0].pngPath = "s21_no_such_dir/chart.png";
+  jobs[1].svgPath = "s21_no_such_dir/chart.svg";
+  jobs.push_back(makeJob({"x"}));
+  std::vector<ChartResult> results = ChartRenderer::renderAll(jobs, 2);
+  ASSERT_FALSE(results[0].ok());
+  EXPECT_NE(results[0].error.find(jobs[0].pngPath), std::string::npos);
+  ASSERT_FALSE(results[1].ok());
+  EXPECT_NE(results[1].error.find(jobs[1].svgPath), std::string::npos);
+  EXPECT_TRUE(results[2].ok());
+  EXPECT_EQ(results[2].image.width(), 200);
+  EXPECT_THROW(ChartRenderer::render(jobs[0]), std::runtime_error);
+}
+
+TEST(render, points1) {
+  // точечный график в SVG - окружности, как и в PNG
+  ChartJob job = makeJob({"x"});
+  job.pAmount = 11;
+  job.style.points = true;
+  job.svgPath = "s21_test_points.svg";
+  ChartRenderer::render(job);
+
+  std::ifstream file(job.svgPath);
+  ASSERT_TRUE(bool(file));
+  std::stringstream text;
+  text << file.rdbuf();
+  std::string svg = text.str();
+  std::remove(job.svgPath.c_str());
+
+  EXPECT_EQ(svg.find("<path"), std::string::npos);
+  std::size_t circles = 0;
+  for (std::size_t at = svg.find("<circle"); at != std::string::npos;
+       at = svg.find("<circle", at + 1)) {
+    ++circles;
+  }
+  EXPECT_EQ(circles, 11u);
+}
+
+int main(int argc, char** argv) {
+  // шрифты QPainter требуют приложения; окна не создаются
+  qputenv("QT_QPA_PLATFORM", "offscreen");
+  QGuiApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,248 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file chartrenderer.cpp
+ *
+ * @brief Implementation of the ChartRenderer class for the SmartCalc v2.0
+ * application.
+ *
+ * This file contains the implementation of the ChartRenderer class, which
+ * renders graphs of compiled expressions to images without any window.
+ * Rendering is done with QPainter on a QImage, which is allowed outside the
+ * GUI thread, so many charts can be rendered in parallel and the GUI event
+ * loop is never involved.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#include "chartrenderer.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+#include "../model/task_scheduler.h"
+
+/**
+ * @brief Renders one chart into an image and saves it if paths are given.
+ *
+ * Can be called from any thread.
+ *
+ * @param job The chart to be rendered.
+ * @return The rendered image.
+ * @throw std::runtime_error If the chart cannot be rendered or saved;
+ * the message names the path.
+ */
+QImage ChartRenderer::render(const ChartJob &job) {
+  ChartResult result = renderJob(job);
+  if (!result.ok()) {
+    throw std::runtime_error(result.error);
+  }
+  return result.image;
+}
+
+/**
+ * @brief Renders many charts in parallel on the shared task scheduler.
+ *
+ * The charts are taken one by one by at most threads tasks of a TaskGroup,
+ * so idle workers pick up the remaining charts, the load is balanced even
+ * if the charts differ in cost and no more than threads charts are
+ * rendered at once. A chart that fails does not stop the others: its
+ * error is returned with its result.
+ *
+ * @param jobs The charts to be rendered.
+ * @param threads The largest number of charts rendered at once
+ * (0 - as many as the scheduler runs).
+ * @return The images and the errors in the order of the jobs.
+ */
+std::vector<ChartResult> ChartRenderer::renderAll(
+    const std::vector<ChartJob> &jobs, unsigned threads) {
+  std::vector<ChartResult> results(jobs.size());
+  size_t tasks = threads == 0 ? jobs.size()
+                              : std::min<size_t>(threads, jobs.size());
+  std::atomic<size_t> next{0};
+  s21::TaskGroup group;
+  for (size_t t = 0; t < tasks; t++) {
+    group.run([&] {
+      // каждая задача берёт следующий график, пока они не кончатся
+      for (size_t i = next++; i < jobs.size(); i = next++) {
+        results[i] = renderJob(jobs[i]);
+      }
+    });
+  }
+  group.wait();
+  return results;
+}
+
+/**
+ * @brief Saves a chart as an SVG image.
+ *
+ * @param job The chart to be saved.
+ * @param table The evaluated points of the chart.
+ * @return True if the file was written, false otherwise.
+ */
+bool ChartRenderer::saveSvg(const ChartJob &job, const s21::Vector &table) {
+  std::ofstream file(job.svgPath);
+  if (!file) {
+    return false;
+  }
+  const ChartStyle &style = job.style;
+  double sx = style.width / (job.xRange.second - job.xRange.first);
+  double sy = style.height / (job.yRange.second - job.yRange.first);
+
+  file << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << style.width
+       << "\" height=\"" << style.height << "\">\n";
+  file << "<rect width=\"100%\" height=\"100%\" fill=\""
+       << style.background.name().toStdString() << "\" stroke=\""
+       << style.axis.name().toStdString() << "\"/>\n";
+
+  for (size_t row = 1; row < table.size(); row++) {
+    QColor pen = style.pens[(row - 1) % style.pens.size()];
+    // точки - окружности того же радиуса и толщины, что и в PNG
+    file << (style.points ? "<g" : "<path") << " fill=\"none\" stroke=\""
+         << pen.name().toStdString() << "\" stroke-width=\""
+         << style.lineWidth << (style.points ? "\">\n" : "\" d=\"");
+    bool penDown = false;
+    for (size_t i = 0; i < table[0].size(); i++) {
+      double y = table[row][i];
+      // разрываем линию на неопределённых точках
+      if (!std::isfinite(y)) {
+        penDown = false;
+        continue;
+      }
+      double px = (table[0][i] - job.xRange.first) * sx;
+      double py = (job.yRange.second - y) * sy;
+      if (style.points) {
+        file << "<circle cx=\"" << px << "\" cy=\"" << py << "\" r=\""
+             << style.lineWidth << "\"/>\n";
+      } else {
+        file << (penDown ? 'L' : 'M') << px << ',' << py << ' ';
+      }
+      penDown = true;
+    }
+    file << (style.points ? "</g>\n" : "\"/>\n");
+  }
+  file << "</svg>\n";
+  return bool(file);
+}
+
+/**
+ * @brief Renders and saves one chart, collecting the errors.
+ *
+ * @param job The chart to be rendered.
+ * @return The image and the description of the errors, if any.
+ */
+ChartResult ChartRenderer::renderJob(const ChartJob &job) {
+  ChartResult result;
+  try {
+    s21::Vector table = evaluate(job);
+    result.image = draw(job, table);
+    // сохраняем изображение, если указаны пути
+    if (!job.pngPath.empty() &&
+        !result.image.save(QString::fromStdString(job.pngPath), "PNG")) {
+      result.error = "Cannot save chart: " + job.pngPath;
+    }
+    if (!job.svgPath.empty() && !saveSvg(job, table)) {
+      result.error += (result.error.empty() ? "" : "; ") +
+                      std::string("Cannot save chart: ") + job.svgPath;
+    }
+  } catch (const std::exception &e) {
+    result.error = e.what();
+  }
+  return result;
+}
+
+/**
+ * @brief Evaluates the expressions of a chart over its grid.
+ *
+ * Points outside the range of values are replaced by NaN.
+ *
+ * @param job The chart to be evaluated.
+ * @return Row 0 holds x, rows 1..N hold the values of the expressions.
+ */
+s21::Vector ChartRenderer::evaluate(const ChartJob &job) {
+  s21::Vector table = job.program.evaluateGrid(job.xRange, job.pAmount);
+  for (size_t row = 1; row < table.size(); row++) {
+    for (double &y : table[row]) {
+      if (!(y >= job.yRange.first && y <= job.yRange.second)) {
+        y = NAN;
+      }
+    }
+  }
+  return table;
+}
+
+/**
+ * @brief Draws the evaluated points of a chart on a new image.
+ *
+ * @param job The chart to be drawn.
+ * @param table The evaluated points of the chart.
+ * @return The image with the chart.
+ */
+QImage ChartRenderer::draw(const ChartJob &job, const s21::Vector &table) {
+  const ChartStyle &style = job.style;
+  QImage image(style.width, style.height, QImage::Format_ARGB32_Premultiplied);
+  image.fill(style.background);
+
+  QPainter painter(&image);
+  painter.setRenderHint(QPainter::Antialiasing);
+
+  double sx = style.width / (job.xRange.second - job.xRange.first);
+  double sy = style.height / (job.yRange.second - job.yRange.first);
+  auto toPixel = [&](double x, double y) {
+    return QPointF((x - job.xRange.first) * sx, (job.yRange.second - y) * sy);
+  };
+
+  // рисуем рамку и оси координат, если они попадают в область
+  painter.setPen(QPen(style.axis, 1));
+  painter.drawRect(0, 0, style.width - 1, style.height - 1);
+  if (job.xRange.first <= 0 && job.xRange.second >= 0) {
+    painter.drawLine(toPixel(0, job.yRange.first),
+                     toPixel(0, job.yRange.second));
+  }
+  if (job.yRange.first <= 0 && job.yRange.second >= 0) {
+    painter.drawLine(toPixel(job.xRange.first, 0),
+                     toPixel(job.xRange.second, 0));
+  }
+  painter.drawText(QPointF(4, style.height - 4),
+                   QString("x: [%1, %2]  y: [%3, %4]")
+                       .arg(job.xRange.first)
+                       .arg(job.xRange.second)
+                       .arg(job.yRange.first)
+                       .arg(job.yRange.second));
+
+  // рисуем графики, разрывая линию на неопределённых точках
+  for (size_t row = 1; row < table.size(); row++) {
+    QPen pen(style.pens[(row - 1) % style.pens.size()], style.lineWidth);
+    painter.setPen(pen);
+    QPainterPath path;
+    bool penDown = false;
+    for (size_t i = 0; i < table[0].size(); i++) {
+      double y = table[row][i];
+      if (!std::isfinite(y)) {
+        penDown = false;
+        continue;
+      }
+      QPointF point = toPixel(table[0][i], y);
+      if (style.points) {
+        painter.drawEllipse(point, style.lineWidth, style.lineWidth);
+      } else if (penDown) {
+        path.lineTo(point);
+      } else {
+        path.moveTo(point);
+      }
+      penDown = true;
+    }
+    painter.drawPath(path);
+  }
+  painter.end();
+  return image;
+}
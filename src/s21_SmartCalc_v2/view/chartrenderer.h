@@ -0,0 +1,75 @@
+// Copyright 2024 Dmitrii Khramtsov
+
+/**
+ * @file chartrenderer.h
+ *
+ * @brief Declaration of the ChartRenderer class for the SmartCalc v2.0
+ * application.
+ *
+ * This file contains the declaration of the ChartRenderer class, which
+ * renders graphs of compiled expressions to images (PNG and SVG) without
+ * any window, so charts can be rendered in parallel outside the GUI thread.
+ *
+ * @author Dmitrii Khramtsov (lonmouth@student.21-school.ru)
+ *
+ * @date 2026-10-18
+ *
+ * @copyright School-21 (c) 2024
+ */
+
+#ifndef CHARTRENDERER_H
+#define CHARTRENDERER_H
+
+#include <QColor>
+#include <QImage>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../model/expression_program.h"
+
+// оформление графика
+struct ChartStyle {
+  int width = 800;                // ширина изображения в пикселях
+  int height = 600;               // высота изображения в пикселях
+  QColor background = Qt::white;  // цвет фона
+  QColor axis = Qt::gray;         // цвет осей и рамки
+  // цвета графиков по кругу
+  std::vector<QColor> pens = {Qt::blue, Qt::red, Qt::darkGreen, Qt::magenta};
+  double lineWidth = 1.5;  // толщина линии
+  bool points = false;     // точки вместо линии
+};
+
+// задание на построение одного графика
+struct ChartJob {
+  s21::ExpressionProgram program;    // скомпилированные выражения
+  std::pair<double, double> xRange;  // область определения
+  std::pair<double, double> yRange;  // область значений
+  unsigned pAmount = 1000;           // количество точек
+  ChartStyle style;                  // оформление
+  std::string pngPath;  // путь для PNG (пустой - не сохранять)
+  std::string svgPath;  // путь для SVG (пустой - не сохранять)
+};
+
+// результат построения одного графика в пакете
+struct ChartResult {
+  QImage image;       // построенное изображение
+  std::string error;  // причина ошибки (пустая - график сохранён)
+
+  bool ok() const { return error.empty(); }
+};
+
+class ChartRenderer {
+ public:
+  static QImage render(const ChartJob& job);
+  static std::vector<ChartResult> renderAll(const std::vector<ChartJob>& jobs,
+                                            unsigned threads = 0);
+  static bool saveSvg(const ChartJob& job, const s21::Vector& table);
+
+ private:
+  static ChartResult renderJob(const ChartJob& job);
+  static s21::Vector evaluate(const ChartJob& job);
+  static QImage draw(const ChartJob& job, const s21::Vector& table);
+};
+
+#endif  // CHARTRENDERER_H
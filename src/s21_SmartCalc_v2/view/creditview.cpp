@@ -17,6 +17,10 @@
 #include "creditview.h"
 #include "ui_creditview.h"
 
+#include <algorithm>
+
+#include "qcustomplot.h"
+
 /**
  * @brief Constructor for the CreditView class.
  *
@@ -32,6 +36,7 @@ CreditView::CreditView(QWidget *parent) :
 
   // подключение сигналов от кнопок к слотам
   connect(ui->pushButton_credit, &QPushButton::clicked, this, &CreditView::calc_credit);
+  connect(ui->pushButton_sensitivity, &QPushButton::clicked, this, &CreditView::show_sensitivity);
 }
 
 /**
@@ -48,13 +53,13 @@ void CreditView::calc_credit() {
   s21::CrInput conditions = initializeCreditConditions();
   s21::CrOutput output;
   double monthly_pay = 0;
-  s21::PaymentVector payment_vector;
+  s21::PaymentColumns payments;
 
   try {
     // вычисляем кредитные условия и получаем результаты
-    controller.calculateCredit(static_cast<s21::TypeOfMonthlyPayments>(ui->comboBox->currentIndex()), conditions, monthly_pay, output, payment_vector);
+    controller.calculateCredit(static_cast<s21::TypeOfMonthlyPayments>(ui->comboBox->currentIndex()), conditions, monthly_pay, output, payments);
     // обновляем таблицу кредита
-    updateCreditTable(payment_vector);
+    updateCreditTable(payments);
     // обновляем метки кредита
     updateCreditLabels(monthly_pay, output);
   } catch (...) {
@@ -63,6 +68,29 @@ void CreditView::calc_credit() {
   }
 }
 
+/**
+ * @brief Shows the monthly payment for the entered amount over a grid of
+ * rates and terms.
+ *
+ * The grid has 200 rates from 0.15% to 30% and the terms from 1 month up
+ * to 30 years (or the entered term, if it is longer).
+ */
+void CreditView::show_sensitivity() {
+  s21::CreditGridAxes axes;
+  for (int i = 1; i <= 200; i++) axes.rate.push_back(i * 0.15);
+  int max_term = std::max(360, ui->spinBox_number_of_mouth->value());
+  for (int n = 1; n <= max_term; n++) axes.term.push_back(n);
+  axes.credit.push_back(ui->doubleSpinBox_credit_summ->value());
+  s21::CreditCube cube;
+
+  try {
+    controller.priceGrid(static_cast<s21::TypeOfMonthlyPayments>(ui->comboBox->currentIndex()), axes, cube);
+    updateSensitivityMap(axes, cube);
+  } catch (...) {
+    ui->statusBar->showMessage("Не корректно введены данные для расчета кредита", 3000);
+  }
+}
+
 /**
  * @brief Initializes the credit conditions based on the user input.
  *
@@ -80,40 +108,41 @@ s21::CrInput CreditView::initializeCreditConditions() {
 /**
  * @brief Updates the credit table with the calculation results.
  *
- * @param payment_vector The vector containing the payment data.
+ * The dates are formatted here, only for the rows being displayed.
+ *
+ * @param payments The columns containing the payment data.
  */
-void CreditView::updateCreditTable(const s21::PaymentVector& payment_vector) {
+void CreditView::updateCreditTable(const s21::PaymentColumns& payments) {
   // устанавливаем количество столбцов и строк в таблице
   ui->tableCredit->setColumnCount(5); // предполагается 5 столбцов: Date, Monthly Payment, Total Payment, Total Reminder, Const Payment
-  ui->tableCredit->setRowCount(payment_vector.size());
-
-  // заполняем таблицу данными из payment_vector
-  for (int row = 0; row < payment_vector.size(); row++) {
-    const s21::Payment& payment = payment_vector[row];
+  ui->tableCredit->setRowCount(payments.size());
 
+  // заполняем таблицу данными из столбцов графика
+  for (int row = 0; row < static_cast<int>(payments.size()); row++) {
     QTableWidgetItem *itemDate = new QTableWidgetItem();
     itemDate->setTextAlignment(Qt::AlignRight);
-    itemDate->setText(QString::fromStdString(payment.date));
+    itemDate->setText(QString::fromStdString(s21::CreditModel::formatDate(
+        s21::CreditModel::fromDayNumber(payments.day[row]))));
     ui->tableCredit->setItem(row, 0, itemDate);
 
     QTableWidgetItem *itemMonthlyPay = new QTableWidgetItem();
     itemMonthlyPay->setTextAlignment(Qt::AlignRight);
-    itemMonthlyPay->setText(QString::number(payment.monthly_pay, 'f', 2));
+    itemMonthlyPay->setText(QString::number(payments.monthly_pay[row], 'f', 2));
     ui->tableCredit->setItem(row, 1, itemMonthlyPay);
 
     QTableWidgetItem *itemTotal = new QTableWidgetItem();
     itemTotal->setTextAlignment(Qt::AlignRight);
-    itemTotal->setText(QString::number(payment.interest_pay, 'f', 2));
+    itemTotal->setText(QString::number(payments.interest_pay[row], 'f', 2));
     ui->tableCredit->setItem(row, 2, itemTotal);
 
     QTableWidgetItem *itemTotalReminder = new QTableWidgetItem();
     itemTotalReminder->setTextAlignment(Qt::AlignRight);
-    itemTotalReminder->setText(QString::number(payment.const_payment, 'f', 2));
+    itemTotalReminder->setText(QString::number(payments.const_payment[row], 'f', 2));
     ui->tableCredit->setItem(row, 3, itemTotalReminder);
 
     QTableWidgetItem *itemConstPayment = new QTableWidgetItem();
     itemConstPayment->setTextAlignment(Qt::AlignRight);
-    itemConstPayment->setText(QString::number(payment.total_reminder, 'f', 2));
+    itemConstPayment->setText(QString::number(payments.total_reminder[row], 'f', 2));
     ui->tableCredit->setItem(row, 4, itemConstPayment);
   }
 
@@ -133,3 +162,48 @@ void CreditView::updateCreditLabels(double monthly_pay, const s21::CrOutput& out
   ui->label_overpayment->setText(QString::number(output.overpayment, 'f', 2));
   ui->label_overpayment_total_payment->setText(QString::number(output.total, 'f', 2));
 }
+
+/**
+ * @brief Draws the payments of the first amount of a grid as a heatmap.
+ *
+ * The window with the heatmap is created on first use. The slice of the
+ * cube with one amount is a matrix whose rows are terms and whose columns
+ * are rates, the same layout as the cells of QCPColorMap.
+ *
+ * @param axes The rates, the terms and the amounts of the grid.
+ * @param cube The payments over the grid.
+ */
+void CreditView::updateSensitivityMap(const s21::CreditGridAxes& axes,
+                                      const s21::CreditCube& cube) {
+  if (!heatmap) {
+    heatmap = new QCustomPlot(this);
+    heatmap->setWindowFlags(Qt::Window);
+    heatmap->setWindowTitle("Ежемесячный платёж");
+    heatmap->resize(720, 540);
+    heatmap->xAxis->setLabel("Ставка, %");
+    heatmap->yAxis->setLabel("Срок, мес.");
+    QCPColorMap *map = new QCPColorMap(heatmap->xAxis, heatmap->yAxis);
+    QCPColorScale *scale = new QCPColorScale(heatmap);
+    heatmap->plotLayout()->addElement(0, 1, scale);
+    map->setColorScale(scale);
+    map->setGradient(QCPColorGradient::gpJet);
+    map->setInterpolate(false);
+  }
+
+  QCPColorMap *map = static_cast<QCPColorMap *>(heatmap->plottable(0));
+  map->data()->setSize(cube.rates, cube.terms);
+  map->data()->setRange(QCPRange(axes.rate.front(), axes.rate.back()),
+                        QCPRange(axes.term.front(), axes.term.back()));
+  // строка среза - один срок, ставка меняется быстрее всего
+  for (size_t term = 0; term < cube.terms; term++) {
+    const double *row = cube.monthly_pay.data() + cube.index(0, term, 0);
+    for (size_t rate = 0; rate < cube.rates; rate++) {
+      map->data()->setCell(rate, term, row[rate]);
+    }
+  }
+  map->rescaleDataRange(true);
+  heatmap->rescaleAxes();
+  heatmap->replot();
+  heatmap->show();
+  heatmap->raise();
+}
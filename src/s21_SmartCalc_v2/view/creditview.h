@@ -8,6 +8,8 @@ namespace Ui {
 class CreditView;
 }
 
+class QCustomPlot;
+
 class CreditView : public QMainWindow {
   Q_OBJECT
 
@@ -17,14 +19,18 @@ class CreditView : public QMainWindow {
 
  private slots:
   void calc_credit();
+  void show_sensitivity();
 
  private:
   Ui::CreditView *ui;
   s21::CalcController controller;
+  QCustomPlot *heatmap = nullptr;
 
   s21::CrInput initializeCreditConditions();
-  void updateCreditTable(const s21::PaymentVector& payment_vector);
+  void updateCreditTable(const s21::PaymentColumns& payments);
   void updateCreditLabels(double monthly_pay, const s21::CrOutput& output);
+  void updateSensitivityMap(const s21::CreditGridAxes& axes,
+                            const s21::CreditCube& cube);
 };
 
 #endif // CREDITVIEW_H
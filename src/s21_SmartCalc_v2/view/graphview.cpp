@@ -17,6 +17,12 @@
 #include "graphview.h"
 #include "ui_graphview.h"
 
+#include <QCoreApplication>
+#include <QDir>
+#include <QRegularExpression>
+#include <algorithm>
+#include <cmath>
+
 /**
  * @brief Constructor for the GraphView class.
  *
@@ -44,58 +50,217 @@ GraphView::~GraphView() {
 }
 
 /**
- * @brief Builds and displays the graph based on user input.
+ * @brief Builds and displays the graph in the selected mode.
  */
 void GraphView::build_graf() {
-  double vXMin = ui->doubleSpinBox_Xmin->value();
-  double vXMax = ui->doubleSpinBox_Xmax->value();
-  double vYMin = ui->doubleSpinBox_Ymin->value();
-  double vYMax = ui->doubleSpinBox_Ymax->value();
-  QVector<double> x, y;
-  std::vector<std::vector<double>> answer;
-
   // проверяем, не пустой ли текст в QLineEdit
-  if (ui->lineEdit->text() != "") {
-    try {
-      // вычисляем данные для графика
-      answer = controller.calculateGraf(std::make_pair(vXMin, vXMax),
-                                        std::make_pair(vYMin, vYMax),
-                                        ui->spinBox_points->value(),
-                                        ui->lineEdit->text().toStdString());
-      // заполняем векторы x и y данными из answer
-      for (int i = 0; i < ui->spinBox_points->value(); i++) {
-        x.push_back(answer[0][i]);
-        y.push_back(answer[1][i]);
+  if (ui->lineEdit->text().trimmed().isEmpty()) {
+    return;
+  }
+
+  // очищаем все графики и кривые
+  ui->widget->clearPlottables();
+
+  try {
+    if (ui->comboBox_mode->currentIndex() == 0) {
+      build_function_graf();
+    } else {
+      build_curve();
+    }
+  } catch (std::exception const &errorMessage) {
+    // отображаем сообщение об ошибке в статусной строке
+    ui->statusbar->showMessage(
+        "ОШИБКА: возможно " + QString::fromStdString(errorMessage.what()),
+        3000);
+  }
+
+  // устанавливаем диапазоны осей
+  ui->widget->xAxis->setRange(ui->doubleSpinBox_Xmin->value(),
+                              ui->doubleSpinBox_Xmax->value());
+  ui->widget->yAxis->setRange(ui->doubleSpinBox_Ymin->value(),
+                              ui->doubleSpinBox_Ymax->value());
+
+  // перерисовываем график
+  ui->widget->replot();
+
+  // включаем взаимодействие с графиком (масштабирование и перетаскивание)
+  ui->widget->setInteraction(QCP::iRangeZoom, true);
+  ui->widget->setInteraction(QCP::iRangeDrag, true);
+}
+
+/**
+ * @brief Builds the graphs y = f(x).
+ *
+ * Several expressions can be entered at once, separated by ';'.
+ * They are evaluated together over a shared grid of x values, in single
+ * precision if it is selected; then the status bar warns about the
+ * expressions whose single precision errors would be visible.
+ */
+void GraphView::build_function_graf() {
+  s21::StringVector infixes = splitExpressions();
+  if (infixes.empty()) {
+    return;
+  }
+  // большие сетки не помещаются в память и рисуются по пирамидам
+  if (std::size_t(ui->spinBox_points->value()) >
+      s21::MappedSeries::kChunkPoints) {
+    build_mapped_graf(infixes);
+    return;
+  }
+
+  std::pair<double, double> xRange = std::make_pair(
+      ui->doubleSpinBox_Xmin->value(), ui->doubleSpinBox_Xmax->value());
+  s21::Precision precision = ui->comboBox_precision->currentIndex()
+                                 ? s21::Precision::Single
+                                 : s21::Precision::Double;
+
+  // вычисляем данные для всех графиков за один проход по сетке
+  std::vector<std::vector<double>> answer = controller.calculateGrafs(
+      xRange,
+      std::make_pair(ui->doubleSpinBox_Ymin->value(),
+                     ui->doubleSpinBox_Ymax->value()),
+      ui->spinBox_points->value(), infixes, precision);
+
+  // предупреждаем, если погрешность float видна на графике
+  if (precision == s21::Precision::Single) {
+    std::vector<s21::AccuracyReport> reports = controller.checkAccuracy(
+        xRange, ui->spinBox_points->value(), infixes);
+    for (size_t i = 0; i < reports.size(); i++) {
+      if (!reports[i].sufficient) {
+        ui->statusbar->showMessage(
+            QString("ВНИМАНИЕ: точности float недостаточно для \"%1\", "
+                    "погрешность до %2")
+                .arg(QString::fromStdString(infixes[i]))
+                .arg(reports[i].maxAbsError),
+            5000);
+        break;
       }
-    } catch (std::exception const &errorMessage) {
-      // отображаем сообщение об ошибке в статусной строке
-      ui->statusbar->showMessage(
-          "ОШИБКА: возможно " + QString::fromStdString(errorMessage.what()),
-          3000);
     }
+  }
 
-    // очищаем графики и добавляем новый график
-    ui->widget->clearGraphs();
-    ui->widget->addGraph();
-    ui->widget->graph(0)->setData(x, y);
+  // добавляем по графику на каждое выражение
+  QVector<double> x(answer[0].begin(), answer[0].end());
+  for (size_t row = 1; row < answer.size(); row++) {
+    QVector<double> y(answer[row].begin(), answer[row].end());
+    QCPGraph *graph = ui->widget->addGraph();
+    graph->setData(x, y);
+    graph->setPen(QPen(QColor::fromHsv(int(row - 1) * 67 % 360, 220, 200)));
 
     // устанавливаем стиль линии и маркеров в зависимости от выбранного индекса в comboBox_2
     if (ui->comboBox_2->currentIndex()) {
-      ui->widget->graph(0)->setLineStyle(QCPGraph::lsNone);
-      ui->widget->graph(0)->setScatterStyle(QCPScatterStyle::ssDisc);
+      graph->setLineStyle(QCPGraph::lsNone);
+      graph->setScatterStyle(QCPScatterStyle::ssDisc);
     } else {
-      ui->widget->graph(0)->setLineStyle(QCPGraph::lsLine);
+      graph->setLineStyle(QCPGraph::lsLine);
     }
+  }
+}
 
-    // устанавливаем диапазоны осей
-    ui->widget->xAxis->setRange(vXMin, vXMax);
-    ui->widget->yAxis->setRange(vYMin, vYMax);
+/**
+ * @brief Builds the graphs y = f(x) for a grid too large for memory.
+ *
+ * The points are streamed into temporary memory-mapped files, and for every
+ * pixel of the plot only the minimum and maximum of the expression over the
+ * visible range are drawn as a filled band, taken from the level of detail
+ * pyramid. The files are removed afterwards.
+ *
+ * @param infixes The expressions to be plotted.
+ */
+void GraphView::build_mapped_graf(const s21::StringVector &infixes) {
+  std::string prefix =
+      QDir(QDir::tempPath())
+          .filePath(QString("s21_graf_%1").arg(QCoreApplication::applicationPid()))
+          .toStdString();
+  double xMin = ui->doubleSpinBox_Xmin->value();
+  double xMax = ui->doubleSpinBox_Xmax->value();
+  try {
+    s21::MappedGraf graf = controller.calculateGrafToFiles(
+        std::make_pair(xMin, xMax), ui->spinBox_points->value(), infixes,
+        prefix);
+    const s21::MappedSeries &x = graf.series[0];
+    unsigned pixels = std::max(1, ui->widget->axisRect()->width());
+    for (size_t i = 0; i < graf.pyramids.size(); i++) {
+      const s21::MappedSeries &y = graf.series[i + 1];
+      s21::LodSlice slice =
+          graf.pyramids[i].query(x.data(), y.data(), y.size(), xMin, xMax, pixels);
+      QColor color = QColor::fromHsv(int(i) * 67 % 360, 220, 200);
+
+      // огибающая: граф максимумов заливается до графа минимумов
+      QVector<double> px(slice.x.begin(), slice.x.end());
+      QCPGraph *lower = ui->widget->addGraph();
+      lower->setData(px, QVector<double>(slice.min.begin(), slice.min.end()));
+      lower->setPen(QPen(color));
+      QCPGraph *upper = ui->widget->addGraph();
+      upper->setData(px, QVector<double>(slice.max.begin(), slice.max.end()));
+      upper->setPen(QPen(color));
+      upper->setBrush(QBrush(color));
+      upper->setChannelFillGraph(lower);
+    }
+  } catch (...) {
+    controller.removeGrafFiles(prefix, infixes.size());
+    throw;
+  }
+  controller.removeGrafFiles(prefix, infixes.size());
+}
 
-    // перерисовываем график
-    ui->widget->replot();
+/**
+ * @brief Builds a parametric curve "x(t); y(t)" or a polar curve r(t)
+ * for t in [0, 2π].
+ *
+ * The parameter is sampled adaptively, so that every segment of the curve
+ * is at most one pixel long on the current plot.
+ */
+void GraphView::build_curve() {
+  s21::StringVector infixes = splitExpressions();
+  bool polar = ui->comboBox_mode->currentIndex() == 2;
+  if (infixes.size() != (polar ? 1u : 2u)) {
+    throw std::invalid_argument(polar ? "введите одно выражение r(t)"
+                                      : "введите два выражения x(t); y(t)");
+  }
 
-    // включаем взаимодействие с графиком (масштабирование и перетаскивание)
-    ui->widget->setInteraction(QCP::iRangeZoom, true);
-    ui->widget->setInteraction(QCP::iRangeDrag, true);
+  s21::CurveInput in;
+  in.tRange = std::make_pair(0.0, 2 * M_PI);
+  in.first = infixes[0];
+  in.second = polar ? "" : infixes[1];
+  in.pixelX = (ui->doubleSpinBox_Xmax->value() - ui->doubleSpinBox_Xmin->value()) /
+              ui->widget->width();
+  in.pixelY = (ui->doubleSpinBox_Ymax->value() - ui->doubleSpinBox_Ymin->value()) /
+              ui->widget->height();
+  in.maxSegment = 1.0;
+  in.initialPoints = ui->spinBox_points->value();
+  in.maxPoints = 1u << 20;
+
+  std::vector<std::vector<double>> answer =
+      polar ? controller.calculatePolar(in) : controller.calculateParametric(in);
+
+  // QCPCurve сохраняет порядок точек по параметру t
+  QCPCurve *curve = new QCPCurve(ui->widget->xAxis, ui->widget->yAxis);
+  curve->setData(QVector<double>(answer[0].begin(), answer[0].end()),
+                 QVector<double>(answer[1].begin(), answer[1].end()),
+                 QVector<double>(answer[2].begin(), answer[2].end()));
+  if (ui->comboBox_2->currentIndex()) {
+    curve->setLineStyle(QCPCurve::lsNone);
+    curve->setScatterStyle(QCPScatterStyle::ssDisc);
+  }
+}
+
+/**
+ * @brief Splits the text of the line edit into expressions separated by ';'.
+ *
+ * The parameter of a curve can be written as t, it is replaced by x.
+ *
+ * @return The list of expressions.
+ */
+s21::StringVector GraphView::splitExpressions() {
+  s21::StringVector infixes;
+  QString text = ui->lineEdit->text();
+  if (ui->comboBox_mode->currentIndex() != 0) {
+    text.replace(QRegularExpression("\\bt\\b"), "x");
+  }
+  for (const QString &part : text.split(';', Qt::SkipEmptyParts)) {
+    if (!part.trimmed().isEmpty()) {
+      infixes.push_back(part.trimmed().toStdString());
+    }
   }
+  return infixes;
 }
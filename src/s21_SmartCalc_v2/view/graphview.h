@@ -21,6 +21,11 @@ class GraphView : public QMainWindow {
  private:
   Ui::GraphView *ui;
   s21::CalcController controller;
+
+  void build_function_graf();
+  void build_mapped_graf(const s21::StringVector &infixes);
+  void build_curve();
+  s21::StringVector splitExpressions();
 };
 
 #endif  // GRAPHVIEW_H